@@ -169,6 +169,6 @@ namespace sigma::ast {
 
 		// metadata
 		node_type type;
-		handle<token_location> location = nullptr;
+		token_location location;
 	};
 } // namespace sigma::ast
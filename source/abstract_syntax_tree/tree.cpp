@@ -45,4 +45,12 @@ namespace sigma::ast {
 	auto tree::get_allocator() -> utility::block_allocator& {
 		return m_allocator;
 	}
+
+	auto tree::create_region() -> utility::block_allocator& {
+		return *m_regions.emplace_back(std::make_unique<utility::block_allocator>(1024));
+	}
+
+	void tree::adopt_region(std::unique_ptr<utility::block_allocator> region) {
+		m_regions.push_back(std::move(region));
+	}
 } // namespace sigma::ast
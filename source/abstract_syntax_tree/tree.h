@@ -18,24 +18,61 @@ namespace sigma::ast {
 		auto get_nodes() const -> const utility::memory_buffer<handle<node>>&;
 		auto get_allocator() -> utility::block_allocator&;
 
+		/**
+		 * \brief Creates a separate allocator owned by the tree. Nodes allocated from different
+		 * regions can be created on different threads.
+		 * \return Allocator of the new region.
+		 */
+		auto create_region() -> utility::block_allocator&;
+
+		/**
+		 * \brief Transfers the ownership of an allocator, which already contains nodes, to the tree.
+		 * \param region Allocator to adopt
+		 */
+		void adopt_region(std::unique_ptr<utility::block_allocator> region);
+
+		template<typename extra_type = utility::empty_property>
+		auto create_node(node_type type, u64 child_count, token_location location) -> handle<node> {
+			return create_node<extra_type>(m_allocator, type, child_count, location);
+		}
+
 		template<typename extra_type = utility::empty_property>
-		auto create_node(node_type type, u64 child_count, handle<token_location> location) -> handle<node> {
+		static auto create_node(utility::block_allocator& allocator, node_type type, u64 child_count, token_location location) -> handle<node> {
 			ASSERT(child_count <= std::numeric_limits<u16>::max(), "cannot allocate more than {} children", std::numeric_limits<u16>::max());
-			const handle node_ptr = m_allocator.emplace<node>();
+			handle<node> node_ptr;
+
+			if constexpr(std::is_same_v<extra_type, utility::empty_property>) {
+				node_ptr = allocator.emplace<node>();
+			}
+			else {
+				// allocate the node together with its property, so that both end up next to each other
+				const handle record = allocator.emplace<node_record<extra_type>>();
+
+				node_ptr = &record->base;
+				node_ptr->set_property(&record->property);
+			}
 
 			// initialize the node
-			node_ptr->set_property(m_allocator.emplace<extra_type>());
-			node_ptr->children = allocate_node_list(static_cast<u16>(child_count));
+			node_ptr->children = { allocator, static_cast<u16>(child_count) };
 			node_ptr->location = location;
 			node_ptr->type = type;
 
 			return node_ptr;
 		}
 	private:
+		template<typename extra_type>
+		struct node_record {
+			node base;
+			extra_type property;
+		};
+
 		// handles pointing to the main nodes (functions and globals)
 		utility::memory_buffer<handle<node>> m_nodes;
 
 		// the actual node data is stored in a block allocator
 		utility::block_allocator m_allocator;
+
+		// additional allocators, used when parts of the tree are created in parallel
+		std::vector<std::unique_ptr<utility::block_allocator>> m_regions;
 	};
 } // namespace sigma::ast
@@ -1,8 +1,8 @@
 #include "compilation_context.h"
 
 namespace sigma {
-	backend_context::backend_context(sigma::syntax& syntax, ir::target target)
-		: allocator(1024), syntax(syntax), semantics(*this), module(target), builder(module) {
+	backend_context::backend_context(ir::target target)
+		: allocator(1024), semantics(*this), module(target), builder(module) {
 		// TODO: we don't have to initialize these if they're not used
 
 		// printf
@@ -42,9 +42,56 @@ namespace sigma {
 		}
 	}
 
+	void backend_context::merge_frontend(const frontend_context& frontend) {
+		// NOTE: string table keys are derived from the contents of the string, which means that keys
+		//       referenced by the frontend AST stay valid, we just have to copy the strings over
+
+		auto import_string = [&](utility::string_table_key key) {
+			if(!frontend.syntax.strings.contains(key)) {
+				return;
+			}
+
+			[[maybe_unused]] const utility::string_table_key imported = syntax.strings.insert(frontend.syntax.strings.get(key));
+			ASSERT(imported == key, "string table key mismatch");
+		};
+
+		// identifiers and literals
+		for(const token_info& info : frontend.tokens) {
+			import_string(info.symbol_key);
+		}
+
+		for(const utility::string_table_key key : frontend.external_symbols) {
+			import_string(key);
+		}
+
+		// literals synthesized by the parser (ie. negations)
+		frontend.syntax.ast.traverse([&](handle<ast::node> node, u16) {
+			if(node->type == ast::node_type::NUMERICAL_LITERAL) {
+				import_string(node->get<ast::named_type_expression>().key);
+			}
+		});
+
+		// top level nodes
+		for(const handle<ast::node>& node : frontend.syntax.ast.get_nodes()) {
+			syntax.ast.add_node(node);
+		}
+	}
+
 	frontend_context::frontend_context()
 		: allocator(sizeof(token_location) * 200) {}
 
+	void frontend_context::append_tokens(const token_buffer& chunk_tokens, const utility::string_table& chunk_strings) {
+		// string table keys are derived from the contents of the string, keys stored in the tokens
+		// therefore stay valid
+		for(const token_info& info : chunk_tokens) {
+			if(chunk_strings.contains(info.symbol_key)) {
+				syntax.strings.insert(chunk_strings.get(info.symbol_key));
+			}
+		}
+
+		tokens.append(chunk_tokens);
+	}
+
 	void frontend_context::print_tokens() const {
 		if (tokens.empty()) {
 			utility::console::print("empty token buffer\n");
@@ -55,14 +102,17 @@ namespace sigma {
 		u8 longest_line_number = 1;
 		u8 longest_char_number = 1;
 
-		for (const auto& info : tokens) {
-			longest_line_number = std::max(longest_line_number, utility::num_digits(info.location->line_index + 1));
-			longest_char_number = std::max(longest_char_number, utility::num_digits(info.location->char_index + 1));
+		for (u64 i = 0; i < tokens.get_size(); ++i) {
+			const token_location location = tokens.get_location(i);
+			longest_line_number = std::max(longest_line_number, utility::num_digits(location.get_line_index() + 1));
+			longest_char_number = std::max(longest_char_number, utility::num_digits(location.get_char_index() + 1));
 		}
 
 		u8 longest_loc = longest_line_number + longest_char_number + 2; // + 1 because we add a ':' char as well
 
-		for (const auto& info : tokens) {
+		for (u64 i = 0; i < tokens.get_size(); ++i) {
+			const token_info info = tokens[i];
+			const token_location location = tokens.get_location(i);
 			std::string symbol_value;
 			// check if the token has a string value associated with it 
 			if (syntax.strings.contains(info.symbol_key)) {
@@ -71,7 +121,7 @@ namespace sigma {
 
 			utility::console::print(
 				"{:<{}} {:<20} {}\n",
-				std::format("{}:{}:", info.location->line_index + 1, info.location->char_index + 1),
+				std::format("{}:{}:", location.get_line_index() + 1, location.get_char_index() + 1),
 				longest_loc,
 				info.tok.to_string(),
 				symbol_value
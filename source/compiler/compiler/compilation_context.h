@@ -5,6 +5,7 @@
 #include <utility/string/string_table.h>
 #include <abstract_syntax_tree/tree.h>
 #include <tokenizer/token_buffer.h>
+#include <tokenizer/source_file.h>
 
 // TODO: add support for emitting to .dot files
 
@@ -16,14 +17,21 @@ namespace sigma {
 		ast::tree ast;
 	};
 
+	struct frontend_context;
+
 	struct backend_context {
-		backend_context(syntax& syntax, ir::target target);
+		backend_context(ir::target target);
+
+		/**
+		 * \brief Merges the syntax of \b frontend into the backend. The AST nodes themselves aren't
+		 * copied, the frontend therefore has to outlive the backend.
+		 * \param frontend Frontend context to merge
+		 */
+		void merge_frontend(const frontend_context& frontend);
 
 		utility::block_allocator allocator;
 
-		// TEMP: the reference here is just temporary, and will be replaced when we add support for
-		//       multiple source files
-		syntax& syntax; 
+		syntax syntax; // merged syntax of all frontends
 		semantic_context semantics;
 
 		ir::module module;
@@ -35,9 +43,21 @@ namespace sigma {
 
 		void print_tokens() const;
 
+		/**
+		 * \brief Appends a separately tokenized chunk of the source file to the token buffer.
+		 * \param chunk_tokens Tokens of the chunk, which directly follows the current tokens
+		 * \param chunk_strings String table containing values of the chunk tokens
+		 */
+		void append_tokens(const token_buffer& chunk_tokens, const utility::string_table& chunk_strings);
+
 		utility::block_allocator allocator; // one allocator per file
 
+		source_file source;                 // source text, referenced by tokens and locations
 		token_buffer tokens;                // tokenized representation of the source file
 		syntax syntax;                      // ast + strings
+
+		// keys of values which aren't referenced by the token buffer (streamed tokens and syntax
+		// loaded from the cache)
+		std::vector<utility::string_table_key> external_symbols;
 	};
 } // namespace sigma
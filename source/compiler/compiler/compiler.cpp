@@ -8,45 +8,295 @@
 #include "compiler/compiler/compilation_context.h"
 #include "compiler/compiler/diagnostics.h"
 
+#include <intermediate_representation/target/outputs/jit.h>
+#include <filesystem>
+#include <thread>
+
 #define LANG_FILE_EXTENSION ".s"
 
 namespace sigma {
+	namespace detail {
+		// independently tokenized range of a source file
+		struct token_chunk {
+			u64 file_index;
+			u32 begin;
+			u32 end;
+
+			token_buffer tokens;
+			utility::string_table strings;
+			std::optional<utility::error> error;
+		};
+
+		// tokenizes the source of 'frontend' on a separate thread, while parsing it on the current one
+		auto parse_streamed(frontend_context& frontend) -> utility::result<void> {
+			token_stream stream(&frontend.source, frontend.syntax.strings, frontend.external_symbols);
+			std::optional<utility::error> tokenizer_error;
+
+			// the producer can't be a pool task, we're running inside of one ourselves and block
+			// until the producer pushes more tokens, if every worker ended up waiting on a queued
+			// producer the pool would deadlock
+			std::thread producer([&] {
+				// the string table is private to the tokenizer, values are imported by the stream
+				utility::string_table strings;
+				const auto result = tokenizer::tokenize(&frontend.source, stream, strings);
+
+				if(result.has_error()) {
+					tokenizer_error = result.get_error();
+				}
+			});
+
+			const auto result = parser::parse(frontend, stream);
+
+			// let the tokenizer finish, tokenizer errors take precedence over parser errors, just
+			// like they do when the entire file is tokenized up front
+			stream.drain();
+			producer.join();
+
+			if(tokenizer_error.has_value()) {
+				return tokenizer_error.value();
+			}
+
+			return result;
+		}
+
+		auto get_first_error(const std::vector<std::optional<utility::error>>& errors) -> utility::result<void> {
+			for(const std::optional<utility::error>& error : errors) {
+				if(error.has_value()) {
+					return error.value();
+				}
+			}
+
+			return SUCCESS;
+		}
+	} // namespace detail
+
 	auto compiler::compile(const compiler_description& description) -> utility::result<void> {
 		return compiler(description).compile();
 	}
 
+	auto compiler::run(const compiler_description& description) -> utility::result<i32> {
+		return compiler(description).run();
+	}
+
 	compiler::compiler(const compiler_description& description)
-		: m_description(description) {}
+		: m_description(description), m_pool(description.job_count) {
+		if(!m_description.cache_path.to_string().empty()) {
+			m_cache.emplace(m_description.cache_path);
+		}
+	}
 
 	auto compiler::compile() -> utility::result<void> {
-		utility::console::print("compiling file: {} ({})\n", m_description.source_path, m_description.emit_path);
+		for(const filepath& path : m_description.source_paths) {
+			utility::console::print("compiling file: {} ({})\n", path, m_description.emit_path);
+		}
 
-		TRY(verify_file(m_description.source_path));
 		TRY(m_emit_target, get_emit_target_from_path(m_description.emit_path));
 
-		// frontend
-		// TODO: the entire frontend can be multi-threaded
-		frontend_context frontend;
+		return build([&](ir::module& module) -> utility::result<void> {
+			// emit as an object file
+			if(m_emit_target == emit_target::OBJECT) {
+				TRY(emit_object_file(module, m_description.emit_path));
+			}
+			else if(m_emit_target == emit_target::EXECUTABLE) {
+				TRY(emit_executable(module, m_description.emit_path));
+			}
+			else if(m_emit_target == emit_target::ASSEMBLY) {
+				TRY(emit_assembly(module, m_description.emit_path));
+			}
+
+			return SUCCESS;
+		});
+	}
 
-		// generate the AST
-		TRY(const std::string file, utility::fs::load(m_description.source_path));
-		TRY(tokenizer::tokenize(file, &m_description.source_path, frontend));
-		TRY(parser::parse(frontend));
+	auto compiler::run() -> utility::result<i32> {
+		i32 exit_code = 0;
+
+		const auto run_and_store = [&](ir::module& module) -> utility::result<void> {
+			TRY(exit_code, run_module(module));
+			return SUCCESS;
+		};
+
+		TRY(build(run_and_store));
+		return exit_code;
+	}
+
+	auto compiler::build(const std::function<utility::result<void>(ir::module&)>& consume) -> utility::result<void> {
+		for(const filepath& path : m_description.source_paths) {
+			TRY(verify_file(path));
+		}
+
+		// frontend
+		// every source file gets its own frontend context, which allows us to tokenize and parse
+		// them in parallel
+		std::vector<frontend_context> frontends(m_description.source_paths.size());
+		TRY(run_frontends(frontends));
 
 		// backend
 		// at this point we want to merge all frontend contexts into the backend context
-		backend_context backend(frontend.syntax, m_description.target);
+		backend_context backend(m_description.target);
+
+		for(const frontend_context& frontend : frontends) {
+			backend.merge_frontend(frontend);
+		}
 
 		// run analysis on the generated AST
-		TRY(type_checker::type_check(backend));
-		TRY(ir_translator::translate(backend));
+		TRY(type_checker::type_check(backend, m_pool));
+		TRY(ir_translator::translate(backend, m_pool));
+
+		// compile the generated IR module, disassembly is only kept around when we need to emit it
+		backend.module.compile([&](u64 count, const std::function<void(u64)>& function) {
+			m_pool.parallel_for(count, function);
+		}, m_emit_target == emit_target::ASSEMBLY);
 
-		// compile the generated IR module
-		backend.module.compile();
+		return consume(backend.module);
+	}
 
-		//emit as an object file
-		if(m_emit_target == emit_target::OBJECT) {
-			TRY(emit_object_file(backend.module, m_description.emit_path));
+	auto compiler::run_frontends(std::vector<frontend_context>& frontends) -> utility::result<void> {
+		const u64 file_count = frontends.size();
+		std::vector<std::optional<utility::error>> errors(file_count);
+		std::vector<std::vector<u32>> boundaries(file_count);
+		std::vector<u8> streamed(file_count, false);
+		std::vector<u8> cached(file_count, false);
+
+		// map all source files, large files are split into chunks, so that a single file can be
+		// tokenized on multiple threads
+		m_pool.parallel_for(file_count, [&](u64 index) {
+			frontend_context& frontend = frontends[index];
+			const auto result = frontend.source.load(&m_description.source_paths[index]);
+
+			if(result.has_error()) {
+				errors[index] = result.get_error();
+				return;
+			}
+
+			// unchanged files are loaded from the cache, there's nothing left to do for them
+			if(m_cache.has_value() && m_cache->load(frontend)) {
+				cached[index] = true;
+				return;
+			}
+
+			const u64 size = frontend.source.get_text().size();
+			const u64 chunk_size = std::max(m_description.token_chunk_size, size / m_pool.get_thread_count());
+			boundaries[index] = tokenizer::split(frontend.source, chunk_size);
+
+			// overlap tokenization and parsing of medium sized files
+			if(!m_pool.is_single_threaded() && boundaries[index].size() == 2 && size >= m_description.token_stream_size) {
+				streamed[index] = true;
+				boundaries[index].clear();
+			}
+		});
+
+		TRY(detail::get_first_error(errors));
+
+		// index of the first chunk of every file
+		std::vector<u64> first_chunks(file_count + 1, 0);
+
+		for(u64 i = 0; i < file_count; ++i) {
+			first_chunks[i + 1] = first_chunks[i] + (streamed[i] || cached[i] ? 0 : boundaries[i].size() - 1);
+		}
+
+		std::vector<detail::token_chunk> chunks(first_chunks.back());
+
+		for(u64 i = 0; i < file_count; ++i) {
+			for(u64 j = 0; j + 1 < boundaries[i].size(); ++j) {
+				detail::token_chunk& chunk = chunks[first_chunks[i] + j];
+
+				chunk.file_index = i;
+				chunk.begin = boundaries[i][j];
+				chunk.end = boundaries[i][j + 1];
+			}
+		}
+
+		// tokenize all chunks, the first chunk of every file is tokenized directly into its frontend
+		m_pool.parallel_for(chunks.size(), [&](u64 index) {
+			detail::token_chunk& chunk = chunks[index];
+			frontend_context& frontend = frontends[chunk.file_index];
+
+			const bool is_first = index == first_chunks[chunk.file_index];
+			token_buffer& tokens = is_first ? frontend.tokens : chunk.tokens;
+			utility::string_table& strings = is_first ? frontend.syntax.strings : chunk.strings;
+
+			const auto result = tokenizer::tokenize(&frontend.source, chunk.begin, chunk.end, tokens, strings);
+
+			if(result.has_error()) {
+				chunk.error = result.get_error();
+			}
+		});
+
+		// join the chunks and parse declarations, function bodies are skipped, only the first error
+		// of every file is reported, so that diagnostics match sequential tokenization
+		std::vector<std::vector<function_body>> bodies(file_count);
+
+		m_pool.parallel_for(file_count, [&](u64 index) {
+			frontend_context& frontend = frontends[index];
+
+			if(cached[index]) {
+				return;
+			}
+
+			if(streamed[index]) {
+				const auto result = detail::parse_streamed(frontend);
+
+				if(result.has_error()) {
+					errors[index] = result.get_error();
+				}
+
+				return;
+			}
+
+			for(u64 i = first_chunks[index]; i < first_chunks[index + 1]; ++i) {
+				if(chunks[i].error.has_value()) {
+					errors[index] = chunks[i].error;
+					return;
+				}
+
+				if(i != first_chunks[index]) {
+					frontend.append_tokens(chunks[i].tokens, chunks[i].strings);
+				}
+			}
+
+			const auto result = parser::parse_declarations(frontend, bodies[index]);
+
+			if(result.has_error()) {
+				errors[index] = result.get_error();
+			}
+		});
+
+		// parse function bodies of all files, bodies are independent of each other
+		std::vector<std::pair<u64, handle<function_body>>> body_tasks;
+
+		for(u64 i = 0; i < file_count; ++i) {
+			for(function_body& body : bodies[i]) {
+				body_tasks.emplace_back(i, &body);
+			}
+		}
+
+		m_pool.parallel_for(body_tasks.size(), [&](u64 index) {
+			const auto& [file_index, body] = body_tasks[index];
+			parser::parse_function_body(frontends[file_index], *body);
+		});
+
+		// errors in function bodies precede errors in the remaining declarations
+		m_pool.parallel_for(file_count, [&](u64 index) {
+			const auto result = parser::join_function_bodies(frontends[index], bodies[index]);
+
+			if(result.has_error()) {
+				errors[index] = result.get_error();
+			}
+		});
+
+		// report the first error in order of the source files, so that diagnostics don't depend on
+		// the order in which the files were processed
+		TRY(detail::get_first_error(errors));
+
+		// cache the syntax of parsed files, this has to happen before the type checker starts
+		// modifying the AST
+		if(m_cache.has_value()) {
+			m_pool.parallel_for(file_count, [&](u64 index) {
+				if(!cached[index]) {
+					m_cache->store(frontends[index]);
+				}
+			});
 		}
 
 		return SUCCESS;
@@ -77,15 +327,65 @@ namespace sigma {
 		};
 
 		const char* format = object_formats[static_cast<u8>(m_description.target.get_system())];
-		return m_description.source_path.get_parent_path() / (name + format);
+		return m_description.source_paths.front().get_parent_path() / (name + format);
 	}
 
 	auto compiler::emit_object_file(ir::module& module, const filepath& path) -> utility::result<void> {
 		return utility::fs::write(path, module.generate_object_file());
 	}
 
+	auto compiler::emit_executable(ir::module& module, const filepath& path) -> utility::result<void> {
+		TRY(utility::fs::write(path, module.generate_executable()));
+
+		// make the emitted file executable
+		std::error_code error_code;
+		std::filesystem::permissions(
+			path.to_string(),
+			std::filesystem::perms::owner_exec | std::filesystem::perms::group_exec | std::filesystem::perms::others_exec,
+			std::filesystem::perm_options::add,
+			error_code
+		);
+
+		if(error_code) {
+			return error::emit(error::code::CANNOT_MAKE_FILE_EXECUTABLE, path, error_code.message());
+		}
+
+		return SUCCESS;
+	}
+
+	auto compiler::emit_assembly(const ir::module& module, const filepath& path) -> utility::result<void> {
+		utility::byte_buffer assembly;
+		assembly.append_string(module.generate_assembly());
+
+		return utility::fs::write(path, assembly);
+	}
+
+	auto compiler::run_module(ir::module& module) -> utility::result<i32> {
+		ir::jit jit;
+		const std::vector<std::string> unresolved = jit.load(module);
+
+		if(!unresolved.empty()) {
+			return error::emit(error::code::UNRESOLVED_EXTERNAL_SYMBOL, unresolved.front());
+		}
+
+		if(jit.get_symbol_address("main") == nullptr) {
+			return error::emit(error::code::MISSING_ENTRY_POINT, "main");
+		}
+
+		const i32 exit_code = jit.run("main");
+
+		// the program shares stdout with us, make sure its output isn't interleaved with ours
+		std::fflush(stdout);
+		return exit_code;
+	}
+
 	auto compiler::get_emit_target_from_path(const filepath& path) const -> utility::result<emit_target> {
-		if(path.get_extension() == ".exe") {
+		// executables are linked by the compiler itself, which isn't supported on every system yet
+		if(path.get_extension() == ".exe" || path.get_extension().empty()) {
+			if(!ir::codegen_target::supports_executables(m_description.target.get_system())) {
+				return error::emit(error::code::UNSUPPORTED_EXECUTABLE_TARGET, path);
+			}
+
 			return emit_target::EXECUTABLE;
 		}
 
@@ -99,6 +399,10 @@ namespace sigma {
 			return emit_target::OBJECT;
 		}
 
+		if(path.get_extension() == ".asm") {
+			return emit_target::ASSEMBLY;
+		}
+
 		NOT_IMPLEMENTED();
 		return emit_target::NONE;
 	}
@@ -12,6 +12,8 @@
 
 #pragma once
 #include <intermediate_representation/target/target.h>
+#include <compiler/compiler/syntax_cache.h>
+#include <compiler/compiler/thread_pool.h>
 #include <utility/filesystem/filesystem.h>
 #include <parametric/parametric.h>
 #include <utility/diagnostics.h>
@@ -26,31 +28,78 @@ namespace sigma {
 	enum class emit_target : u8 {
 		NONE,
 		OBJECT,
-		EXECUTABLE
+		EXECUTABLE,
+		ASSEMBLY
 	};
 
+	struct frontend_context;
+
 	struct compiler_description {
-		filepath source_path;
+		std::vector<filepath> source_paths;
 		filepath emit_path;
 		ir::target target;
+
+		// number of threads used during compilation, 0 uses all available hardware threads
+		u64 job_count = 1;
+
+		// files larger than this are split into chunks, which are tokenized in parallel
+		u64 token_chunk_size = 4 * 1024 * 1024;
+
+		// files which aren't split into chunks, but are at least this large are tokenized on a
+		// separate thread, while they're being parsed
+		u64 token_stream_size = 1024 * 1024;
+
+		// directory of the syntax cache, an empty path disables the cache
+		filepath cache_path;
 	};
 
 	class compiler {
 	public:
 		static auto compile(const compiler_description& description) -> utility::result<void>;
+
+		/**
+		 * \brief Compiles the specified description and runs it in-process, without emitting
+		 * anything. The target of the description has to match the host system.
+		 * \param description Description to compile, the emit path is ignored
+		 * \return Value returned by the 'main' function of the compiled program.
+		 */
+		static auto run(const compiler_description& description) -> utility::result<i32>;
 	private:
 		compiler(const compiler_description& description);
 
 		auto compile() -> utility::result<void>;
+		auto run() -> utility::result<i32>;
+
+		/**
+		 * \brief Runs the entire compilation pipeline for all source files and hands the compiled
+		 * module over to \b consume.
+		 * \param consume Callback which receives the compiled module
+		 */
+		auto build(const std::function<utility::result<void>(ir::module&)>& consume) -> utility::result<void>;
 		auto get_object_file_path(const std::string& name = "a") const -> filepath;
 
+		/**
+		 * \brief Runs the frontend (tokenizer and parser) for all source files. Large files are
+		 * split into chunks, which are tokenized in parallel, function bodies of all files are
+		 * parsed in parallel as well. Files with an entry in the syntax cache aren't tokenized or
+		 * parsed at all.
+		 * \param frontends Frontend contexts, one for every source path
+		 */
+		auto run_frontends(std::vector<frontend_context>& frontends) -> utility::result<void>;
+
 		static auto verify_file(const filepath& path) -> utility::result<void>;
 		static auto emit_object_file(ir::module& module, const filepath& path) -> utility::result<void>;
+		static auto emit_executable(ir::module& module, const filepath& path) -> utility::result<void>;
+		static auto emit_assembly(const ir::module& module, const filepath& path) -> utility::result<void>;
+		static auto run_module(ir::module& module) -> utility::result<i32>;
 
 		auto get_emit_target_from_path(const filepath& path) const -> utility::result<emit_target>;
 	private:
 		compiler_description m_description;
 		emit_target m_emit_target = emit_target::NONE;
+
+		thread_pool m_pool;
+		std::optional<syntax_cache> m_cache;
 	};
 } // namespace sigma
 
@@ -61,6 +110,35 @@ struct parametric::options_parser<sigma::filepath> {
 	}
 };
 
+template<>
+struct parametric::options_parser<std::vector<sigma::filepath>> {
+	static auto parse(const std::string& value) -> std::vector<sigma::filepath> {
+		// comma separated list of paths
+		std::vector<sigma::filepath> paths;
+		std::size_t start = 0;
+
+		while(start <= value.size()) {
+			std::size_t end = value.find(',', start);
+
+			if(end == std::string::npos) {
+				end = value.size();
+			}
+
+			if(end > start) {
+				paths.emplace_back(value.substr(start, end - start));
+			}
+
+			start = end + 1;
+		}
+
+		if(paths.empty()) {
+			throw std::invalid_argument("invalid argument");
+		}
+
+		return paths;
+	}
+};
+
 template<>
 struct parametric::options_parser<sigma::ir::arch> {
 	static auto parse(const std::string& value) -> sigma::ir::arch {
@@ -102,6 +180,10 @@ struct parametric::options_parser<sigma::emit_target> {
 			return sigma::emit_target::EXECUTABLE;
 		}
 
+		if (value == "assembly") {
+			return sigma::emit_target::ASSEMBLY;
+		}
+
 		throw std::invalid_argument("invalid argument");
 	}
 };
@@ -18,6 +18,7 @@ namespace sigma {
 			FILE_DOES_NOT_EXIST,
 			INVALID_FILE_EXTENSION,
 			CANNOT_READ_FILE,
+			CANNOT_MAKE_FILE_EXECUTABLE,
 
 			// tokenizer (2000 - 2999)
 			INVALID_STRING_TERMINATOR = 2000,
@@ -54,18 +55,23 @@ namespace sigma {
 			STRUCT_ALREADY_DECLARED,
 			UNKNOWN_TYPE,
 			UNKNOWN_STRUCT_MEMBER,
+
+			// backend (5000 - 5999)
+			UNSUPPORTED_EXECUTABLE_TARGET = 5000,
+			UNRESOLVED_EXTERNAL_SYMBOL,
+			MISSING_ENTRY_POINT,
 		};
 
 		/**
 		 * \brief Emits a new error with positional info using an error code.
 		 * \tparam arguments Argument types for the specific \b code
 		 * \param code Error code to emit
-		 * \param location Handle to the relevant token location
+		 * \param location Location of the relevant token
 		 * \param args Relevant error arguments (arguments for the specific error::code message)
 		 * \return utility::error with the generated message.
 		 */
 		template<typename... arguments>
-		static auto emit(code code, handle<token_location> location, arguments&&... args) -> utility::error {
+		static auto emit(code code, token_location location, arguments&&... args) -> utility::error {
 			auto arg_tuple = std::make_tuple(args...);
 			const std::string message = std::apply([&](auto&... vals) {
 				return std::vformat(m_errors.find(code)->second, std::make_format_args(vals...));
@@ -73,9 +79,9 @@ namespace sigma {
 
 			const std::string error_message = std::format(
 				"{}:{}:{}: error C{}: {}",
-				location->file->get_filename(),
-				location->line_index + 1,
-				location->char_index + 1,
+				location.get_path()->get_filename(),
+				location.get_line_index() + 1,
+				location.get_char_index() + 1,
 				static_cast<u32>(code), 
 				message
 			);
@@ -111,6 +117,7 @@ namespace sigma {
 			{ code::FILE_DOES_NOT_EXIST,                 "specified file does not exist ('{}')"                                              },
 			{ code::INVALID_FILE_EXTENSION,              "specified file has an invalid file extension ('{}' - expected '{}')"               },
 			{ code::CANNOT_READ_FILE,                    "unable to read the specified file ('{}')"                                          },
+			{ code::CANNOT_MAKE_FILE_EXECUTABLE,         "unable to make the specified file executable ('{}' - {})"                          },
 
 			// tokenizer
 			{ code::INVALID_STRING_TERMINATOR,           "invalid string literal terminator detected"                                        },
@@ -147,6 +154,11 @@ namespace sigma {
 			{ code::STRUCT_ALREADY_DECLARED,             "struct '{}' has already been declared before"                                      },
 			{ code::UNKNOWN_TYPE,                        "unknown type '{}' referenced"                                                      },
 			{ code::UNKNOWN_STRUCT_MEMBER,               "unknown struct member '{}' referenced"                                             },
+
+			// backend
+			{ code::UNSUPPORTED_EXECUTABLE_TARGET,       "executables cannot be emitted for the specified target ('{}')"                     },
+			{ code::UNRESOLVED_EXTERNAL_SYMBOL,          "unresolved external symbol '{}'"                                                   },
+			{ code::MISSING_ENTRY_POINT,                 "cannot run a program without an entry point ('{}')"                                },
 		};
 	};
 
@@ -161,18 +173,27 @@ namespace sigma {
 			NUMERICAL_CHAR,
 		};
 
+		/**
+		 * \brief Emits a new warning with positional info using a warning code. Warnings aren't
+		 * printed right away, so that they can be reported in a deterministic order.
+		 * \tparam arguments Argument types for the specific \b code
+		 * \param code Warning code to emit
+		 * \param location Location of the relevant token
+		 * \param args Relevant warning arguments (arguments for the specific warning::code message)
+		 * \return Generated warning message.
+		 */
 		template<typename... arguments>
-		static void emit(code code, handle<token_location> location, arguments&&... args) {
+		static auto emit(code code, token_location location, arguments&&... args) -> std::string {
 			auto arg_tuple = std::make_tuple(args...);
 			std::string message = std::apply([&](auto&... vals) {
 				return std::vformat(m_warnings.find(code)->second, std::make_format_args(vals...));
 			}, arg_tuple);
 
-			utility::console::print(
-				"{}:{}:{}: warning C{}: {}\n",
-				location->file->get_filename(),
-				location->line_index + 1,
-				location->char_index + 1,
+			return std::format(
+				"{}:{}:{}: warning C{}: {}",
+				location.get_path()->get_filename(),
+				location.get_line_index() + 1,
+				location.get_char_index() + 1,
 				static_cast<u32>(code), 
 				message
 			);
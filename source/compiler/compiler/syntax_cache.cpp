@@ -0,0 +1,552 @@
+#include "syntax_cache.h"
+
+#include "compiler/compiler/compilation_context.h"
+
+#include <utility/containers/byte_buffer.h>
+#include <utility/filesystem/filesystem.h>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+
+namespace sigma {
+	namespace detail {
+		// bump whenever the layout of an entry or of the AST changes
+		constexpr u32 syntax_cache_version = 2;
+		constexpr u32 syntax_cache_magic = 0x54534153; // 'SAST'
+
+		// node type of null children (ie. the false branch target of a conditional branch)
+		constexpr u16 null_node = std::numeric_limits<u16>::max();
+
+		// keys are written as-is, the key of every string is checked once it's loaded
+		static_assert(std::is_trivially_copyable_v<utility::string_table_key>);
+
+		// the header is followed by the source text, the strings and the nodes, in that order
+		struct syntax_cache_header {
+			u32 magic;
+			u32 version;
+			u64 source_hash;
+			u64 source_size;
+			u64 payload_hash; // hash of everything that follows the header
+			u32 string_count;
+			u32 root_count;
+		};
+
+		// 64-bit FNV-1a, stable across builds and platforms
+		auto hash_source(std::string_view source) -> u64 {
+			u64 hash = 0xcbf29ce484222325;
+
+			for(const char c : source) {
+				hash ^= static_cast<u8>(c);
+				hash *= 0x100000001b3;
+			}
+
+			return hash;
+		}
+
+		auto hash_payload(const utility::byte_buffer& payload) -> u64 {
+			return hash_source({ reinterpret_cast<const char*>(payload.get_data()), payload.get_size() });
+		}
+
+		class syntax_writer {
+		public:
+			syntax_writer(const utility::string_table& strings) : m_strings(strings) {}
+
+			void write_node(handle<ast::node> node) {
+				if(node == nullptr) {
+					m_nodes.append_type(null_node);
+					return;
+				}
+
+				m_nodes.append_type(static_cast<u16>(node->type.type));
+				m_nodes.append_type(node->children.get_size());
+				m_nodes.append_type(static_cast<u8>(node->location.file != nullptr));
+				m_nodes.append_type(node->location.offset);
+
+				switch(node->type) {
+					case ast::node_type::FUNCTION_DECLARATION: {
+						write_signature(node->get<ast::function>().signature);
+						break;
+					}
+					case ast::node_type::FUNCTION_CALL: {
+						const auto& call = node->get<ast::function_call>();
+						write_signature(call.signature);
+						write_namespaces(call.namespaces);
+						break;
+					}
+					case ast::node_type::NAMESPACE_DECLARATION: {
+						write_key(node->get<ast::named_expression>().key);
+						break;
+					}
+					case ast::node_type::VARIABLE_DECLARATION:
+					case ast::node_type::STRUCT_DECLARATION:
+					case ast::node_type::VARIABLE_ACCESS:
+					case ast::node_type::LOCAL_MEMBER_ACCESS:
+					case ast::node_type::NUMERICAL_LITERAL:
+					case ast::node_type::CHARACTER_LITERAL:
+					case ast::node_type::STRING_LITERAL: {
+						const auto& expression = node->get<ast::named_type_expression>();
+						write_key(expression.key);
+						write_type(expression.type);
+						break;
+					}
+					case ast::node_type::ARRAY_ACCESS:
+					case ast::node_type::ALIGNOF:
+					case ast::node_type::SIZEOF:
+					case ast::node_type::LOAD: {
+						write_type(node->get<ast::type_expression>().type);
+						break;
+					}
+					case ast::node_type::OPERATOR_GREATER_THAN:
+					case ast::node_type::OPERATOR_LESS_THAN:
+					case ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL:
+					case ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL:
+					case ast::node_type::OPERATOR_EQUAL:
+					case ast::node_type::OPERATOR_NOT_EQUAL: {
+						m_nodes.append_type(node->get<ast::comparison_expression>().type);
+						break;
+					}
+					case ast::node_type::CAST: {
+						const auto& cast = node->get<ast::cast>();
+						write_type(cast.original_type);
+						write_type(cast.target_type);
+						break;
+					}
+					case ast::node_type::BOOL_LITERAL: {
+						m_nodes.append_type(static_cast<u8>(node->get<ast::bool_literal>().value));
+						break;
+					}
+					default: break; // nodes without any properties
+				}
+
+				for(const handle<ast::node> child : node->children) {
+					write_node(child);
+				}
+			}
+
+			auto finish(std::string_view source, u32 root_count) -> utility::byte_buffer {
+				// only keys with a value in the string table are exported, other keys (ie. keys of
+				// unnamed types) are still written into the nodes
+				std::sort(m_keys.begin(), m_keys.end());
+				m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+				std::erase_if(m_keys, [&](utility::string_table_key key) { return !m_strings.contains(key); });
+
+				utility::byte_buffer payload;
+				payload.append_string(std::string(source));
+
+				for(const utility::string_table_key key : m_keys) {
+					const std::string& value = m_strings.get(key);
+
+					payload.append_type(key);
+					payload.append_type(static_cast<u32>(value.size()));
+					payload.append_string(value);
+				}
+
+				payload.append(m_nodes);
+
+				const syntax_cache_header header = {
+					.magic = syntax_cache_magic,
+					.version = syntax_cache_version,
+					.source_hash = hash_source(source),
+					.source_size = source.size(),
+					.payload_hash = hash_payload(payload),
+					.string_count = static_cast<u32>(m_keys.size()),
+					.root_count = root_count
+				};
+
+				utility::byte_buffer entry;
+				entry.append_type(header);
+				entry.append(payload);
+				return entry;
+			}
+		private:
+			void write_key(utility::string_table_key key) {
+				m_nodes.append_type(key);
+				m_keys.push_back(key);
+			}
+
+			void write_namespaces(const namespace_list& namespaces) {
+				m_nodes.append_type(static_cast<u64>(namespaces.size()));
+
+				for(const utility::string_table_key key : namespaces) {
+					write_key(key);
+				}
+			}
+
+			void write_type(const type& ty) {
+				m_nodes.append_type(ty.get_kind());
+				m_nodes.append_type(ty.get_pointer_level());
+				write_key(ty.get_member_identifier());
+				write_namespaces(ty.get_namespaces());
+
+				if(ty.is_unresolved()) {
+					write_key(ty.get_unresolved());
+				}
+				else if(ty.is_struct()) {
+					ASSERT(ty.get_pointer_level() == 0, "unexpected struct pointer in a parsed AST");
+					const auto& members = ty.get_struct_members();
+
+					m_nodes.append_type(members.get_size());
+
+					for(const type& member : members) {
+						write_type(member);
+					}
+				}
+			}
+
+			void write_signature(const function_signature& signature) {
+				write_type(signature.return_type);
+				m_nodes.append_type(static_cast<u64>(signature.parameter_types.get_size()));
+
+				for(const named_data_type& parameter : signature.parameter_types) {
+					write_type(parameter.type);
+					write_key(parameter.identifier_key);
+				}
+
+				m_nodes.append_type(static_cast<u8>(signature.has_var_args));
+				write_key(signature.identifier_key);
+			}
+		private:
+			const utility::string_table& m_strings;
+
+			utility::byte_buffer m_nodes;
+			std::vector<utility::string_table_key> m_keys; // every key referenced by the nodes
+		};
+
+		class syntax_reader {
+		public:
+			syntax_reader(std::string_view data, handle<source_file> source, utility::block_allocator& allocator)
+				: m_data(data), m_source(source), m_allocator(allocator) {}
+
+			template<typename value_type>
+			auto read() -> value_type {
+				value_type value = {};
+
+				if(sizeof(value_type) > m_data.size() - m_position) {
+					m_failed = true;
+					return value;
+				}
+
+				std::memcpy(&value, m_data.data() + m_position, sizeof(value_type));
+				m_position += sizeof(value_type);
+				return value;
+			}
+
+			auto read_string(u64 length) -> std::string_view {
+				if(length > m_data.size() - m_position) {
+					m_failed = true;
+					return {};
+				}
+
+				const std::string_view value = m_data.substr(m_position, length);
+				m_position += length;
+				return value;
+			}
+
+			auto read_node() -> handle<ast::node> {
+				const u16 node_type = read<u16>();
+
+				if(node_type == null_node || m_failed) {
+					return nullptr;
+				}
+
+				const u16 child_count = read<u16>();
+				const bool has_location = read<u8>();
+				const u32 offset = read<u32>();
+
+				const token_location location = {
+					.file = has_location ? m_source : nullptr,
+					.offset = offset
+				};
+
+				handle<ast::node> node;
+
+				switch(const ast::node_type type = static_cast<ast::node_type::underlying>(node_type)) {
+					case ast::node_type::FUNCTION_DECLARATION: {
+						node = create_node<ast::function>(type, child_count, location);
+						node->get<ast::function>().signature = read_signature();
+						break;
+					}
+					case ast::node_type::FUNCTION_CALL: {
+						node = create_node<ast::function_call>(type, child_count, location);
+						auto& call = node->get<ast::function_call>();
+						call.signature = read_signature();
+						call.namespaces = read_namespaces();
+						break;
+					}
+					case ast::node_type::NAMESPACE_DECLARATION: {
+						node = create_node<ast::named_expression>(type, child_count, location);
+						node->get<ast::named_expression>().key = read<utility::string_table_key>();
+						break;
+					}
+					case ast::node_type::VARIABLE_DECLARATION:
+					case ast::node_type::STRUCT_DECLARATION:
+					case ast::node_type::VARIABLE_ACCESS:
+					case ast::node_type::LOCAL_MEMBER_ACCESS:
+					case ast::node_type::NUMERICAL_LITERAL:
+					case ast::node_type::CHARACTER_LITERAL:
+					case ast::node_type::STRING_LITERAL: {
+						node = create_node<ast::named_type_expression>(type, child_count, location);
+						auto& expression = node->get<ast::named_type_expression>();
+						expression.key = read<utility::string_table_key>();
+						expression.type = read_type();
+						break;
+					}
+					case ast::node_type::ARRAY_ACCESS:
+					case ast::node_type::ALIGNOF:
+					case ast::node_type::SIZEOF:
+					case ast::node_type::LOAD: {
+						node = create_node<ast::type_expression>(type, child_count, location);
+						node->get<ast::type_expression>().type = read_type();
+						break;
+					}
+					case ast::node_type::OPERATOR_GREATER_THAN:
+					case ast::node_type::OPERATOR_LESS_THAN:
+					case ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL:
+					case ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL:
+					case ast::node_type::OPERATOR_EQUAL:
+					case ast::node_type::OPERATOR_NOT_EQUAL: {
+						node = create_node<ast::comparison_expression>(type, child_count, location);
+						node->get<ast::comparison_expression>().type = read<enum ast::comparison_expression::type>();
+						break;
+					}
+					case ast::node_type::CAST: {
+						node = create_node<ast::cast>(type, child_count, location);
+						auto& cast = node->get<ast::cast>();
+						cast.original_type = read_type();
+						cast.target_type = read_type();
+						break;
+					}
+					case ast::node_type::BOOL_LITERAL: {
+						node = create_node<ast::bool_literal>(type, child_count, location);
+						node->get<ast::bool_literal>().value = read<u8>();
+						break;
+					}
+					default: {
+						if(node_type > ast::node_type::NULL_LITERAL) {
+							m_failed = true;
+							return nullptr;
+						}
+
+						node = create_node(type, child_count, location);
+						break;
+					}
+				}
+
+				for(handle<ast::node>& child : node->children) {
+					child = read_node();
+				}
+
+				return node;
+			}
+
+			auto has_failed() const -> bool {
+				return m_failed;
+			}
+
+			auto get_remaining() const -> std::string_view {
+				return m_data.substr(m_position);
+			}
+		private:
+			template<typename extra_type = utility::empty_property>
+			auto create_node(ast::node_type type, u16 child_count, token_location location) const -> handle<ast::node> {
+				return ast::tree::create_node<extra_type>(m_allocator, type, child_count, location);
+			}
+
+			auto read_namespaces() -> namespace_list {
+				const u64 count = read<u64>();
+
+				if(count > m_data.size() - m_position) {
+					m_failed = true;
+					return {};
+				}
+
+				if(count == 0) {
+					return {};
+				}
+
+				utility::memory_view<utility::string_table_key> namespaces(m_allocator, count);
+
+				for(utility::string_table_key& key : namespaces) {
+					key = read<utility::string_table_key>();
+				}
+
+				return namespaces;
+			}
+
+			auto read_type() -> type {
+				const auto kind = read<type::kind>();
+				const u8 pointer_level = read<u8>();
+				const auto identifier = read<utility::string_table_key>();
+				const namespace_list namespaces = read_namespaces();
+
+				type ty;
+
+				if(kind == type::UNRESOLVED) {
+					ty = type::create_member(type::create_unresolved(read<utility::string_table_key>(), pointer_level), identifier);
+				}
+				else if(kind == type::STRUCT) {
+					const u8 member_count = read<u8>();
+					utility::memory_view<type, u8> members(m_allocator, member_count);
+
+					for(type& member : members) {
+						member = read_type();
+					}
+
+					ty = type::create_struct(members, identifier);
+				}
+				else {
+					ty = type::create_member({ kind, pointer_level }, identifier);
+				}
+
+				ty.set_namespaces(namespaces);
+				return ty;
+			}
+
+			auto read_signature() -> function_signature {
+				function_signature signature;
+				signature.return_type = read_type();
+
+				const u64 parameter_count = read<u64>();
+
+				if(parameter_count > m_data.size() - m_position) {
+					m_failed = true;
+					return signature;
+				}
+
+				signature.parameter_types = utility::memory_view<named_data_type>(m_allocator, parameter_count);
+
+				for(named_data_type& parameter : signature.parameter_types) {
+					const type parameter_type = read_type();
+					parameter = named_data_type(parameter_type, read<utility::string_table_key>());
+				}
+
+				signature.has_var_args = read<u8>();
+				signature.identifier_key = read<utility::string_table_key>();
+				return signature;
+			}
+		private:
+			std::string_view m_data;
+			u64 m_position = 0;
+			bool m_failed = false;
+
+			handle<source_file> m_source;
+			utility::block_allocator& m_allocator; // every allocation made while decoding the entry
+		};
+	} // namespace detail
+
+	syntax_cache::syntax_cache(const filepath& directory) : m_directory(directory) {}
+
+	auto syntax_cache::load(frontend_context& frontend) const -> bool {
+		const std::string_view source = frontend.source.get_text();
+		const u64 source_hash = detail::hash_source(source);
+		filepath path = get_entry_path(source_hash);
+
+		if(!path.exists()) {
+			return false;
+		}
+
+		// map the entry, nodes are decoded straight from the mapping
+		source_file entry;
+
+		if(entry.load(&path).has_error()) {
+			return false;
+		}
+
+		// nodes are decoded into a separate region, which is only handed over to the frontend once
+		// the entire entry has been decoded, a damaged entry therefore doesn't leave anything behind
+		auto region = std::make_unique<utility::block_allocator>(1024);
+		detail::syntax_reader reader(entry.get_text(), &frontend.source, *region);
+		const auto header = reader.read<detail::syntax_cache_header>();
+
+		if(
+			reader.has_failed() ||
+			header.magic != detail::syntax_cache_magic ||
+			header.version != detail::syntax_cache_version ||
+			header.source_hash != source_hash ||
+			header.source_size != source.size() ||
+			header.payload_hash != detail::hash_source(reader.get_remaining())
+		) {
+			return false;
+		}
+
+		// the hash only selects the entry, make sure it actually belongs to our source file
+		if(reader.read_string(header.source_size) != source) {
+			return false;
+		}
+
+		// strings referenced by the AST, these aren't referenced by any tokens, so we have to export
+		// them to the backend separately, keys are verified against a separate string table first
+		utility::string_table strings;
+		std::vector<std::string_view> values;
+
+		for(u32 i = 0; i < header.string_count && !reader.has_failed(); ++i) {
+			const auto key = reader.read<utility::string_table_key>();
+			const std::string_view value = reader.read_string(reader.read<u32>());
+
+			// keys written by a compiler which hashes strings differently are useless
+			if(reader.has_failed() || strings.insert(std::string(value)) != key) {
+				return false;
+			}
+
+			values.push_back(value);
+		}
+
+		std::vector<handle<ast::node>> roots;
+
+		for(u32 i = 0; i < header.root_count && !reader.has_failed(); ++i) {
+			roots.push_back(reader.read_node());
+		}
+
+		if(reader.has_failed()) {
+			return false;
+		}
+
+		// the entry is valid, commit it into the frontend
+		for(const std::string_view value : values) {
+			frontend.external_symbols.push_back(frontend.syntax.strings.insert(std::string(value)));
+		}
+
+		frontend.syntax.ast.adopt_region(std::move(region));
+
+		for(const handle<ast::node>& root : roots) {
+			frontend.syntax.ast.add_node(root);
+		}
+
+		return true;
+	}
+
+	void syntax_cache::store(const frontend_context& frontend) const {
+		const std::string_view source = frontend.source.get_text();
+		const auto& roots = frontend.syntax.ast.get_nodes();
+
+		detail::syntax_writer writer(frontend.syntax.strings);
+
+		for(const handle<ast::node>& root : roots) {
+			writer.write_node(root);
+		}
+
+		const utility::byte_buffer entry = writer.finish(source, static_cast<u32>(roots.get_size()));
+
+		// write the entry into a temporary file first, so that concurrent builds never see a
+		// partially written entry
+		const filepath path = get_entry_path(detail::hash_source(source));
+		const filepath temporary_path = path.to_string() + std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+		std::error_code error_code;
+		std::filesystem::create_directories(m_directory.to_string(), error_code);
+
+		if(utility::fs::write(temporary_path, entry).has_error()) {
+			return;
+		}
+
+		std::filesystem::rename(temporary_path.to_string(), path.to_string(), error_code);
+
+		if(error_code) {
+			std::filesystem::remove(temporary_path.to_string(), error_code);
+		}
+	}
+
+	auto syntax_cache::get_entry_path(u64 source_hash) const -> filepath {
+		return m_directory / std::format("{:016x}.ast", source_hash);
+	}
+} // namespace sigma
@@ -0,0 +1,50 @@
+// On-disk cache of parsed source files. Every entry holds the AST of a single source file
+// together with the strings it references and is keyed by a hash of the source text, files
+// which haven't changed since the last build therefore don't have to be tokenized or parsed.
+//
+// -   Entries are written right after parsing, before the type checker modifies the AST.
+// -   Entries contain a copy of the source text, which has to match the source file, hash
+//     collisions therefore can't pull in the AST of a different file.
+// -   Loaded entries are memory-mapped and decoded into a separate allocator, which is handed
+//     over to the frontend once the entire entry has been decoded. AST locations refer to the
+//     (still loaded) source file, so diagnostics stay the same.
+// -   Entries are only ever written in full (via a temporary file), damaged, outdated or
+//     otherwise unreadable entries are treated as misses and leave the frontend untouched.
+
+#pragma once
+#include <utility/filesystem/filepath.h>
+#include <utility/types.h>
+
+namespace sigma {
+	using namespace utility::types;
+
+	struct frontend_context;
+
+	class syntax_cache {
+	public:
+		/**
+		 * \brief Constructs a new cache located in \b directory, the directory is created once the
+		 * first entry is stored.
+		 * \param directory Directory containing the cache entries
+		 */
+		syntax_cache(const filepath& directory);
+
+		/**
+		 * \brief Attempts to load the syntax (AST + strings) of the source file of \b frontend.
+		 * \param frontend Frontend with a loaded source file and an empty AST
+		 * \return True if the syntax was loaded from the cache, false otherwise.
+		 */
+		auto load(frontend_context& frontend) const -> bool;
+
+		/**
+		 * \brief Stores the syntax of \b frontend, failures are ignored, since the cache only ever
+		 * speeds the compilation up.
+		 * \param frontend Successfully parsed frontend
+		 */
+		void store(const frontend_context& frontend) const;
+	private:
+		auto get_entry_path(u64 source_hash) const -> filepath;
+	private:
+		filepath m_directory;
+	};
+} // namespace sigma
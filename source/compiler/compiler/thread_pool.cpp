@@ -0,0 +1,146 @@
+#include "thread_pool.h"
+
+namespace sigma {
+	thread_pool::thread_pool(u64 thread_count) {
+		if(thread_count == 0) {
+			thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		if(thread_count == 1) {
+			return; // run everything on the calling thread
+		}
+
+		m_queues.reserve(thread_count);
+		m_workers.reserve(thread_count);
+
+		for(u64 i = 0; i < thread_count; ++i) {
+			m_queues.emplace_back(std::make_unique<task_queue>());
+		}
+
+		for(u64 i = 0; i < thread_count; ++i) {
+			m_workers.emplace_back([this, i] { run_worker(i); });
+		}
+	}
+
+	thread_pool::~thread_pool() {
+		if(is_single_threaded()) {
+			return;
+		}
+
+		wait();
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_task_available.notify_all();
+
+		for(std::thread& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	void thread_pool::submit(task&& task) {
+		if(is_single_threaded()) {
+			task();
+			return;
+		}
+
+		m_pending_count++;
+
+		// distribute tasks evenly, idle workers will steal them if the load is uneven
+		const u64 queue_index = m_next_queue++ % m_queues.size();
+
+		{
+			std::lock_guard lock(m_queues[queue_index]->mutex);
+			m_queues[queue_index]->tasks.emplace_back(std::move(task));
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_queued_count++;
+		}
+
+		m_task_available.notify_one();
+	}
+
+	void thread_pool::wait() {
+		if(is_single_threaded()) {
+			return;
+		}
+
+		std::unique_lock lock(m_mutex);
+		m_tasks_finished.wait(lock, [this] { return m_pending_count == 0; });
+	}
+
+	auto thread_pool::get_thread_count() const -> u64 {
+		return is_single_threaded() ? 1 : m_workers.size();
+	}
+
+	auto thread_pool::is_single_threaded() const -> bool {
+		return m_workers.empty();
+	}
+
+	void thread_pool::run_worker(u64 index) {
+		task current;
+
+		while(true) {
+			{
+				std::unique_lock lock(m_mutex);
+				m_task_available.wait(lock, [this] { return m_stop || m_queued_count > 0; });
+
+				if(m_stop && m_queued_count == 0) {
+					return;
+				}
+			}
+
+			// prefer our own tasks, steal from other workers otherwise
+			if(!pop_local_task(index, current) && !steal_task(index, current)) {
+				// another worker was faster
+				continue;
+			}
+
+			m_queued_count--;
+			current();
+			current = nullptr;
+
+			if(--m_pending_count == 0) {
+				// take the lock so that the notification can't slip in between the predicate check
+				// and the wait in 'wait()'
+				std::lock_guard lock(m_mutex);
+				m_tasks_finished.notify_all();
+			}
+		}
+	}
+
+	auto thread_pool::pop_local_task(u64 index, task& out) -> bool {
+		task_queue& queue = *m_queues[index];
+		std::lock_guard lock(queue.mutex);
+
+		if(queue.tasks.empty()) {
+			return false;
+		}
+
+		out = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	auto thread_pool::steal_task(u64 index, task& out) -> bool {
+		for(u64 i = 1; i < m_queues.size(); ++i) {
+			task_queue& queue = *m_queues[(index + i) % m_queues.size()];
+			std::lock_guard lock(queue.mutex);
+
+			if(queue.tasks.empty()) {
+				continue;
+			}
+
+			out = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
+		}
+
+		return false;
+	}
+} // namespace sigma
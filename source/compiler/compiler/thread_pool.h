@@ -0,0 +1,103 @@
+// Basic work-stealing thread pool, used to distribute independent units of work (ie. the
+// compilation of individual functions) across multiple threads.
+//
+// -   Every worker owns a local task queue. Workers pop tasks from the back of their own
+//     queue and, when it runs dry, steal tasks from the front of queues owned by other
+//     workers.
+// -   A pool with a thread count of 1 does not spawn any threads, all submitted tasks are
+//     run in place on the calling thread.
+
+#pragma once
+#include <utility/types.h>
+
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace sigma {
+	using namespace utility::types;
+
+	class thread_pool {
+	public:
+		using task = std::function<void()>;
+
+		/**
+		 * \brief Constructs a new pool with \b thread_count worker threads.
+		 * \param thread_count Number of worker threads, 0 selects the number of hardware threads
+		 */
+		thread_pool(u64 thread_count = 1);
+		~thread_pool();
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		/**
+		 * \brief Schedules \b task for execution. In single threaded pools the task is executed
+		 * immediately.
+		 * \param task Task to execute
+		 */
+		void submit(task&& task);
+
+		/**
+		 * \brief Blocks the calling thread until all submitted tasks have finished executing, must
+		 * not be called from within a task.
+		 */
+		void wait();
+
+		/**
+		 * \brief Invokes \b function for every index in the range [0, \b count) and waits for all
+		 * invocations to finish. Invocation order is not guaranteed in multithreaded pools.
+		 * \param count Number of invocations
+		 * \param function Function to invoke, takes the index of the invocation as a parameter
+		 */
+		template<typename function_type>
+		void parallel_for(u64 count, const function_type& function) {
+			if(is_single_threaded() || count <= 1) {
+				for(u64 i = 0; i < count; ++i) {
+					function(i);
+				}
+
+				return;
+			}
+
+			for(u64 i = 0; i < count; ++i) {
+				submit([&function, i] { function(i); });
+			}
+
+			wait();
+		}
+
+		[[nodiscard]] auto get_thread_count() const -> u64;
+		[[nodiscard]] auto is_single_threaded() const -> bool;
+	private:
+		struct task_queue {
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		void run_worker(u64 index);
+
+		auto pop_local_task(u64 index, task& out) -> bool;
+		auto steal_task(u64 index, task& out) -> bool;
+	private:
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<task_queue>> m_queues;
+
+		std::mutex m_mutex;
+		std::condition_variable m_task_available;
+		std::condition_variable m_tasks_finished;
+
+		// number of tasks which have been submitted, but haven't been picked up by a worker yet
+		std::atomic<u64> m_queued_count = 0;
+		// number of tasks which have been submitted, but haven't finished executing yet
+		std::atomic<u64> m_pending_count = 0;
+
+		std::atomic<u64> m_next_queue = 0;
+		bool m_stop = false;
+	};
+} // namespace sigma
@@ -0,0 +1,45 @@
+#include "overload_cache.h"
+
+namespace sigma {
+	auto overload_cache::key::operator==(const key& other) const -> bool {
+		return
+			scope == other.scope &&
+			identifier == other.identifier &&
+			parameter_types == other.parameter_types;
+	}
+
+	auto overload_cache::key_hash::operator()(const key& key) const -> u64 {
+		u64 hash = detail::hash_combine(
+			reinterpret_cast<u64>(key.scope.get()),
+			std::hash<utility::string_table_key>{}(key.identifier)
+		);
+
+		for(const type& parameter : key.parameter_types) {
+			hash = detail::hash_combine(hash, parameter.get_id());
+		}
+
+		return hash;
+	}
+
+	auto overload_cache::find(const key& key) const -> std::optional<function_signature> {
+		std::shared_lock lock(m_mutex);
+		const auto it = m_signatures.find(key);
+
+		if(it == m_signatures.end()) {
+			return std::nullopt;
+		}
+
+		return it->second;
+	}
+
+	void overload_cache::insert(const key& key, const function_signature& signature) {
+		// resolution is deterministic, threads which resolved the same call will agree on the result
+		std::unique_lock lock(m_mutex);
+		m_signatures.try_emplace(key, signature);
+	}
+
+	void overload_cache::clear() {
+		std::unique_lock lock(m_mutex);
+		m_signatures.clear();
+	}
+} // namespace sigma
@@ -0,0 +1,38 @@
+#pragma once
+#include "compiler/compiler/type_system/scope.h"
+
+#include <shared_mutex>
+#include <optional>
+
+namespace sigma {
+	/**
+	 * \brief Cache of resolved function overloads, shared by all semantic contexts. Entries are keyed
+	 * by the namespace the callee was looked up in, the callee identifier and the argument types, and
+	 * hold the signature picked by overload resolution. Lookups and insertions are thread safe.
+	 */
+	class overload_cache {
+	public:
+		struct key {
+			auto operator==(const key& other) const -> bool;
+
+			handle<namespace_scope> scope;
+			utility::string_table_key identifier;
+			std::vector<type> parameter_types;
+		};
+
+		auto find(const key& key) const -> std::optional<function_signature>;
+		void insert(const key& key, const function_signature& signature);
+
+		/**
+		 * \brief Removes all cached resolutions, has to be called whenever a new overload is declared.
+		 */
+		void clear();
+	private:
+		struct key_hash {
+			auto operator()(const key& key) const -> u64;
+		};
+
+		mutable std::shared_mutex m_mutex;
+		std::unordered_map<key, function_signature, key_hash> m_signatures;
+	};
+} // namespace sigma
@@ -3,14 +3,6 @@
 namespace sigma {
 	scope::scope(scope_type type) : scope_ty(type) {}
 
-	auto scope::find_parent_namespace() const -> handle<namespace_scope> {
-		if (parent->scope_ty == scope_type::NAMESPACE) {
-			return parent;
-		}
-
-		return parent->find_parent_namespace();
-	}
-
 	auto scope::find_variable(const utility::string_table_key& identifier) -> handle<variable> {
 		const auto it = variables.find(identifier);
 		if(it != variables.end()) {
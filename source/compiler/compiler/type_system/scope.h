@@ -46,7 +46,6 @@ namespace sigma {
 		scope() = default;
 		scope(scope_type type);
 
-		auto find_parent_namespace() const -> handle<namespace_scope>;
 		auto find_variable(const utility::string_table_key& identifier) -> handle<variable>;
 		auto find_type(const utility::string_table_key& identifier) -> handle<type>;
 
@@ -54,6 +53,7 @@ namespace sigma {
 		std::unordered_map<utility::string_table_key, type> types;
 
 		handle<scope> parent = nullptr;
+		handle<namespace_scope> parent_namespace = nullptr; // closest namespace containing this scope
 		std::vector<handle<scope>> child_scopes;
 
 		// metadata
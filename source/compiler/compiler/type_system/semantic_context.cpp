@@ -31,7 +31,7 @@ namespace sigma {
 			return {};
 		}
 
-		auto signature_to_ir(const function_signature& signature, const utility::string_table& string_table) -> ir::function_signature {
+		auto signature_to_ir(const function_signature& signature, const std::string& identifier) -> ir::function_signature {
 			std::vector<ir::data_type> parameters(signature.parameter_types.get_size());
 
 			for (u64 i = 0; i < signature.parameter_types.get_size(); ++i) {
@@ -40,7 +40,7 @@ namespace sigma {
 			}
 
 			ir::function_signature ir_signature{
-				.identifier = mangle_function_identifier(signature, string_table),
+				.identifier = identifier,
 				.parameters = parameters,
 				.returns = { data_type_to_ir(signature.return_type) },
 				.has_var_args = signature.has_var_args
@@ -49,7 +49,7 @@ namespace sigma {
 			return ir_signature;
 		}
 
-		auto mangle_function_identifier(const function_signature& signature, const utility::string_table& string_table) -> std::string {
+		auto mangle_function_identifier(const function_signature& signature, const utility::string_table& string_table, u64 index) -> std::string {
 			// TODO: names are a bit sus right now, longer names don't appear ot be stored correctly in
 			//       object files (see COFF & ELF)
 
@@ -58,8 +58,8 @@ namespace sigma {
 				return "main";
 			}
 
-			static u64 counter = 0;
-			return "f" + std::to_string(counter++);
+			// functions are declared in a deterministic order, the index is therefore stable as well
+			return "f" + std::to_string(index);
 			//return string_table.get(signature.identifier_key);
 		}
 
@@ -118,11 +118,26 @@ namespace sigma {
 		}
 	} // namespace detail
 
-  semantic_context::semantic_context(backend_context& context) : m_context(context) {
+  semantic_context::semantic_context(backend_context& context)
+		: m_context(context), m_allocator(&context.allocator), m_builder(&context.builder), m_overloads(std::make_shared<overload_cache>()) {
 		m_global_scope = allocate_namespace();
 		reset_active_scope();
   }
 
+	semantic_context::semantic_context(const semantic_context& other, handle<scope> active_scope, utility::block_allocator& allocator, ir::builder& builder)
+		: m_context(other.m_context), m_allocator(&allocator), m_builder(&builder), m_global_scope(other.m_global_scope), m_current_scope(active_scope), m_overloads(other.m_overloads), m_trace({ 0 }) {
+		std::vector<handle<scope>> scopes;
+
+		for(handle<scope> current = active_scope; current; current = current->parent) {
+			scopes.push_back(current);
+		}
+
+		// make declarations of all parent scopes visible, starting with the outermost one
+		for(auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+			m_symbols.enter_scope(*it);
+		}
+	}
+
 	auto semantic_context::verify_control_flow(handle<ast::node> function_node) const -> utility::result<void> {
 		const ast::function function = function_node->get<ast::function>();
 
@@ -142,110 +157,142 @@ namespace sigma {
   void semantic_context::push_scope(scope::control_type control) {
 		const handle new_scope = allocate_scope();
 		new_scope->parent = m_current_scope;
+		new_scope->parent_namespace = find_parent_namespace();
 		new_scope->control = control;
 
 		m_current_scope->child_scopes.push_back(new_scope);
 		m_current_scope = new_scope;
-		m_trace.emplace_back(new_scope);
+		m_symbols.push_scope();
   }
 
 	void semantic_context::push_namespace(utility::string_table_key name) {
 		const handle new_scope = allocate_namespace();
 		new_scope->parent = m_current_scope;
+		new_scope->parent_namespace = m_current_scope;
 
 		ASSERT(m_current_scope->scope_ty == scope::scope_type::NAMESPACE, "cannot declare a namespace in a non-namespace scope");
 
 		const handle<namespace_scope> current = m_current_scope;
 		current->child_namespaces[name] = new_scope;
+		current->child_scopes.push_back(new_scope);
 
 		m_current_scope = new_scope;
-		m_trace.emplace_back(new_scope);
+		m_symbols.push_scope();
 	}
 
 	void semantic_context::pop_scope() {
 		ASSERT(m_current_scope->parent, "invalid pop on global scope");
 		m_current_scope = m_current_scope->parent;
+		m_symbols.pop_scope();
 	}
 
 	void semantic_context::trace_push_scope() {
-		m_current_scope = m_trace[m_trace_index++];
+		// enter the next child scope, in the order in which the scopes were pushed
+		m_current_scope = m_current_scope->child_scopes[m_trace.back()++];
+		m_trace.push_back(0);
+
+		// the scope has already been populated
+		m_symbols.enter_scope(m_current_scope);
 	}
 
 	void semantic_context::trace_pop_scope() {
+		m_trace.pop_back();
 		pop_scope();
 	}
 
+	auto semantic_context::get_active_scope() const -> handle<scope> {
+		return m_current_scope;
+	}
+
 	void semantic_context::reset_active_scope() {
 		m_current_scope = m_global_scope;
-		m_trace_index = 0;
+		m_trace = { 0 };
+
+		m_symbols = {};
+		m_symbols.enter_scope(m_global_scope);
 	}
 
-	auto semantic_context::pre_declare_variable(utility::string_table_key identifier, type type) const -> variable& {
+	auto semantic_context::pre_declare_variable(utility::string_table_key identifier, type type) -> variable& {
 		auto& var = m_current_scope->variables[identifier];
 		var.type = type;
+
+		m_symbols.declare_variable(identifier, &var);
 		return var;
 	}
 
 	auto semantic_context::declare_variable(utility::string_table_key identifier, u16 size, u16 alignment) const -> handle<ir::node> {
-		return m_current_scope->variables.at(identifier).value = m_context.builder.create_local(size, alignment);
+		return m_current_scope->variables.at(identifier).value = m_builder->create_local(size, alignment);
 	}
 
 	auto semantic_context::find_variable(utility::string_table_key identifier, const namespace_list& namespaces) const -> utility::result<handle<variable>> {
+		// NOTE: may be null, this is handled after this function is called depending on the context of
+		// where this function was called (ie. we want to emit different errors depending on whether
+		// we're accessing a variable or assigning to it)
+		if(namespaces.empty()) {
+			return m_symbols.find_variable(identifier);
+		}
+
   	const handle<scope> root_scope = find_namespace(namespaces);
 
 		if (!root_scope) {
 			return emit_unknown_namespace_error(namespaces);
 		}
 
-		// NOTE: may be null, this is handled after this function is called depending on the context of
-		// where this function was called (ie. we want to emit different errors depending on whether
-		// we're accessing a variable or assigning to it)
 		return root_scope->find_variable(identifier);
 	}
 
 	auto semantic_context::get_variable(utility::string_table_key identifier, const namespace_list& namespaces) const -> handle<variable> {
 		// TODO: this is a temporary function, we should probably replace this by just referencing
 		//       the variable in the type checker right away and using that
+		if(namespaces.empty()) {
+			return m_symbols.find_variable(identifier);
+		}
+
 		return find_namespace(namespaces)->find_variable(identifier);
 	}
 
 	auto semantic_context::create_load(utility::string_table_key identifier, ir::data_type type, u16 alignment) const -> handle<ir::node> {
-		const handle<variable> variable = m_current_scope->find_variable(identifier);
+		const handle<variable> variable = m_symbols.find_variable(identifier);
 		ASSERT(variable, "attempting to load an invalid variable");
-		return m_context.builder.create_load(variable->value, type, alignment, false);
+		return m_builder->create_load(variable->value, type, alignment, false);
   }
 
 	void semantic_context::create_store(utility::string_table_key identifier, handle<ir::node> value, u16 alignment) const {
-		const handle<variable> variable = m_current_scope->find_variable(identifier);
+		const handle<variable> variable = m_symbols.find_variable(identifier);
 		// ASSERT(!(variable->flags & variable::FUNCTION_PARAMETER), "not implemented");
 
 		if (variable != nullptr) {
-			m_context.builder.create_store(variable->value, value, alignment, false);
+			m_builder->create_store(variable->value, value, alignment, false);
 			return;
 		}
 
 		ASSERT(false, "unknown variable referenced");
   }
 
-	auto semantic_context::resolve_type(type& ty, handle<token_location> location) const -> utility::result<void> {
+	auto semantic_context::resolve_type(type& ty, token_location location) const -> utility::result<void> {
 		if(!ty.is_unresolved()) {
 			return SUCCESS; // nothing else needed
 		}
 
-		const handle<namespace_scope> scope = find_namespace(ty.get_namespaces());
+		handle<type> resolved;
 
-		if(scope == nullptr) {
-			// invalid namespace
-			return emit_unknown_namespace_error(ty.get_namespaces());
+		if(ty.get_namespaces().empty()) {
+			resolved = m_symbols.find_type(ty.get_unresolved());
 		}
+		else {
+			const handle<scope> scope = find_namespace(ty.get_namespaces());
 
-		if(const handle<type> resolved = scope->find_type(ty.get_unresolved())) {
-			ty.set_kind(resolved->get_kind());
-		
-			if(resolved->is_struct()) {
-				ty.set_struct_members(resolved->get_struct_members());
+			if(scope == nullptr) {
+				// invalid namespace
+				return emit_unknown_namespace_error(ty.get_namespaces());
 			}
-		
+
+			resolved = scope->find_type(ty.get_unresolved());
+		}
+
+		if(resolved) {
+			// keep the pointer level and the member identifier of the unresolved type
+			ty = type::create_member(resolved->create_pointer(ty.get_pointer_level()), ty.get_member_identifier());
 			return SUCCESS;
 		}
 
@@ -273,7 +320,7 @@ namespace sigma {
 			return m_current_scope;
 		}
 
-		return m_current_scope->find_parent_namespace();
+		return m_current_scope->parent_namespace;
 	}
 
 	auto semantic_context::find_relative_namespace(const namespace_list& namespaces) const -> handle<namespace_scope> {
@@ -293,31 +340,34 @@ namespace sigma {
 	}
 
 	auto semantic_context::allocate_scope() const -> handle<scope> {
-		return m_context.allocator.emplace<scope>(scope::scope_type::REGULAR);
+		return m_allocator->emplace<scope>(scope::scope_type::REGULAR);
 	}
 
 	auto semantic_context::allocate_namespace() const -> handle<scope> {
-		return m_context.allocator.emplace<namespace_scope>(scope::scope_type::NAMESPACE);
+		return m_allocator->emplace<namespace_scope>(scope::scope_type::NAMESPACE);
 	}
 
 	void semantic_context::pre_declare_local_function(const function_signature& signature) const {
 		find_parent_namespace()->local_functions[signature.identifier_key][signature] = nullptr;
+		m_overloads->clear(); // the new overload may be a better match for already resolved calls
 	}
 
 	bool semantic_context::contains_variable(utility::string_table_key identifier) const {
-		return m_current_scope->find_variable(identifier) != nullptr;
+		return m_symbols.find_variable(identifier) != nullptr;
 	}
 
-  auto semantic_context::declare_struct(handle<ast::node> node) const -> utility::result<void> {
+  auto semantic_context::declare_struct(handle<ast::node> node) -> utility::result<void> {
 		const auto& expression = node->get<ast::named_type_expression>();
 
 		// check if the struct hasn't already been defined in this scope
-		if(m_current_scope->find_type(expression.key) != nullptr) {
+		if(m_symbols.find_type(expression.key) != nullptr) {
 			const std::string& identifier = m_context.syntax.strings.get(expression.key);
 			return error::emit(error::code::STRUCT_ALREADY_DECLARED, node->location, identifier);
 		}
 
-		m_current_scope->types[expression.key] = expression.type;
+		type& declared = m_current_scope->types[expression.key] = expression.type;
+		m_symbols.declare_type(expression.key, &declared);
+
 		return SUCCESS;
   }
 
@@ -420,6 +470,18 @@ namespace sigma {
 			return emit_unknown_namespace_error(function.namespaces);
 		}
 
+		// relative namespaces are already resolved, calls with the same argument types in the same
+		// namespace therefore always resolve to the same signature
+		overload_cache::key cache_key {
+			.scope = scope,
+			.identifier = function.signature.identifier_key,
+			.parameter_types = parameter_types
+		};
+
+		if(const auto cached = m_overloads->find(cache_key)) {
+			return *cached;
+		}
+
 		add_candidates(scope->local_functions);
 		add_candidates(scope->external_functions);
 
@@ -444,6 +506,7 @@ namespace sigma {
 		// TODO: implement casting
 		// TODO: literals can just be upcasted implicitly
 		// ASSERT(best_match->second == 0, "implement casting in the type checker!");
+		m_overloads->insert(cache_key, best_match->first);
 		return best_match->first;
 	}
 
@@ -452,24 +515,27 @@ namespace sigma {
 
 		find_parent_namespace()->external_functions[signature.identifier_key][signature] = {
 			.ir_function = m_context.module.create_external(identifier, ir::linkage::SO_LOCAL),
-			.ir_signature = detail::signature_to_ir(signature, m_context.syntax.strings)
+			.ir_signature = detail::signature_to_ir(signature, identifier)
 		};
+
+		m_overloads->clear();
 	}
 
-	void semantic_context::declare_local_function(const function_signature& signature) const {
-		const ir::function_signature ir_signature = detail::signature_to_ir(signature, m_context.syntax.strings);
-		const	handle<ir::function> function = m_context.builder.create_function(ir_signature, ir::linkage::PUBLIC);
+	auto semantic_context::declare_local_function(const function_signature& signature, u64 index) const -> handle<ir::function> {
+		const std::string identifier = detail::mangle_function_identifier(signature, m_context.syntax.strings, index);
+		const ir::function_signature ir_signature = detail::signature_to_ir(signature, identifier);
+		const	handle<ir::function> function = m_builder->create_function(ir_signature, ir::linkage::PUBLIC);
 
-		find_parent_namespace()->local_functions.at(signature.identifier_key).at(signature) = function;
+		return find_parent_namespace()->local_functions.at(signature.identifier_key).at(signature) = function;
 	}
 
 	void semantic_context::define_implicit_return() const {
 		// declare an implicit return value for the active function
-		const handle<ir::function> function = m_context.builder.get_insert_point();
+		const handle<ir::function> function = m_builder->get_insert_point();
 
 		if(function->exit_node == nullptr) {
 			// declare an implicit return value
-			m_context.builder.create_return({});
+			m_builder->create_return({});
 		}
 	}
 
@@ -480,14 +546,14 @@ namespace sigma {
 		// attempt to call a local function
 		const auto local_it = scope->local_functions.find(callee_signature.identifier_key);
 		if (local_it != scope->local_functions.end()) {
-			return m_context.builder.create_call(local_it->second.at(callee_signature), parameters);
+			return m_builder->create_call(local_it->second.at(callee_signature), parameters);
 		}
 
 		// attempt to call an external function
 		const auto external_it = scope->external_functions.find(callee_signature.identifier_key);
 		if (external_it != scope->external_functions.end()) {
 			const external_function& external = external_it->second.at(callee_signature);
-			return m_context.builder.create_call(external.ir_function, external.ir_signature, parameters);
+			return m_builder->create_call(external.ir_function, external.ir_signature, parameters);
 		}
 
 		PANIC("unknown function called");
@@ -1,15 +1,16 @@
 #pragma once
 #include <utility/string/string_table.h>
 
-#include "compiler/compiler/type_system/scope.h"
+#include "compiler/compiler/type_system/overload_cache.h"
+#include "compiler/compiler/type_system/symbol_table.h"
 
 namespace sigma {
 	struct backend_context;
 
 	namespace detail {
 		auto data_type_to_ir(type type) -> ir::data_type;
-		auto signature_to_ir(const function_signature& signature, const utility::string_table& string_table) -> ir::function_signature;
-		auto mangle_function_identifier(const function_signature& signature, const utility::string_table& string_table) -> std::string;
+		auto signature_to_ir(const function_signature& signature, const std::string& identifier) -> ir::function_signature;
+		auto mangle_function_identifier(const function_signature& signature, const utility::string_table& string_table, u64 index) -> std::string;
 		auto calculate_parameter_cast_cost(const function_signature& signature, const std::vector<type>& parameter_types) -> u16;
 		auto calculate_cast_cost(const type& provided, const type& required) -> u16;
 
@@ -26,6 +27,17 @@ namespace sigma {
 	public:
 		semantic_context(backend_context& context);
 
+		/**
+		 * \brief Constructs a context which shares all declarations with \b other, but keeps track of
+		 * its own active scope. Contexts created this way can be used on separate threads, as long as
+		 * they only modify scopes nested in \b active_scope.
+		 * \param other Context to share declarations with
+		 * \param active_scope Scope the context starts in
+		 * \param allocator Allocator used for scopes created by this context
+		 * \param builder Builder used for IR emitted by this context
+		 */
+		semantic_context(const semantic_context& other, handle<scope> active_scope, utility::block_allocator& allocator, ir::builder& builder);
+
 		auto verify_control_flow(handle<ast::node> function_node) const-> utility::result<void>;
 
 		// scope manipulation
@@ -38,22 +50,31 @@ namespace sigma {
 		void trace_push_scope();
 		void trace_pop_scope();
 
+		auto get_active_scope() const -> handle<scope>;
+
 		// variables
 		auto find_variable(utility::string_table_key identifier, const namespace_list& namespaces = {}) const -> utility::result<handle<variable>>;
 		auto get_variable(utility::string_table_key identifier, const namespace_list& namespaces = {}) const -> handle<variable>;
 		auto declare_variable(utility::string_table_key identifier, u16 size, u16 alignment) const -> handle<ir::node>;
-		auto pre_declare_variable(utility::string_table_key identifier, type type) const -> variable&;
+		auto pre_declare_variable(utility::string_table_key identifier, type type) -> variable&;
 		bool contains_variable(utility::string_table_key identifier) const;
 
 		// structs
-		auto declare_struct(handle<ast::node> node) const -> utility::result<void>;
+		auto declare_struct(handle<ast::node> node) -> utility::result<void>;
 
 		// functions
 		auto create_call(const function_signature& callee_signature, const namespace_list& namespaces, const std::vector<handle<ir::node>>& parameters) const -> handle<ir::node>;
 		auto find_callee_signature(handle<ast::node> function_node, const std::vector<type>& parameter_types) -> utility::result<function_signature>;
 		void pre_declare_local_function(const function_signature& signature) const;
 		void declare_external_function(const function_signature& signature) const;
-		void declare_local_function(const function_signature& signature) const;
+
+		/**
+		 * \brief Creates the IR function of a pre-declared local function.
+		 * \param signature Signature of the function
+		 * \param index Index of the function in declaration order, used for name mangling
+		 * \return Newly created IR function.
+		 */
+		auto declare_local_function(const function_signature& signature, u64 index) const -> handle<ir::function>;
 		bool contains_function(const function_signature& signature) const;
 
 		// returns
@@ -65,7 +86,7 @@ namespace sigma {
 		auto create_load(utility::string_table_key identifier, ir::data_type type, u16 alignment) const -> handle<ir::node>;
 		void create_store(utility::string_table_key identifier, handle<ir::node> value, u16 alignment) const;
 
-		auto resolve_type(type& type, handle<token_location> location) const -> utility::result<void>;
+		auto resolve_type(type& type, token_location location) const -> utility::result<void>;
 	private:
 		// namespaces
 		auto find_relative_namespace(const namespace_list& namespaces) const->handle<namespace_scope>;
@@ -83,12 +104,20 @@ namespace sigma {
 		static auto all_control_paths_return(handle<scope> scope, handle<ast::node> function_node) -> utility::result<bool>;
 	private:
 		backend_context& m_context;
+		handle<utility::block_allocator> m_allocator;
+		handle<ir::builder> m_builder;
 
 		handle<namespace_scope> m_global_scope;
 		handle<scope> m_current_scope;
 
-		// store a list of all pushes for traversing the scope tree later
-		std::vector<handle<scope>> m_trace;
-		u64 m_trace_index = 0;
+		// declarations visible from the active scope, unqualified lookups only go through this table
+		symbol_table m_symbols;
+
+		// resolved overloads, shared with all contexts created from this one
+		s_ptr<overload_cache> m_overloads;
+
+		// child scopes are stored in the order in which they were pushed, when traversing the scope
+		// tree later on we keep the index of the next child of every traversed scope
+		std::vector<u64> m_trace;
 	};
 } // namespace sigma
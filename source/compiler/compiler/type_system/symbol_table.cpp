@@ -0,0 +1,68 @@
+#include "symbol_table.h"
+
+namespace sigma {
+	namespace detail {
+		template<typename declaration>
+		auto find_declaration(
+			const std::unordered_map<utility::string_table_key, std::vector<handle<declaration>>>& declarations,
+			utility::string_table_key identifier
+		) -> handle<declaration> {
+			const auto it = declarations.find(identifier);
+
+			if(it == declarations.end() || it->second.empty()) {
+				return nullptr;
+			}
+
+			return it->second.back();
+		}
+	} // namespace detail
+
+	void symbol_table::push_scope() {
+		m_frames.emplace_back();
+	}
+
+	void symbol_table::pop_scope() {
+		ASSERT(!m_frames.empty(), "invalid pop on an empty symbol table");
+
+		// empty stacks are kept around, since the identifier is likely to be declared again
+		for(const utility::string_table_key identifier : m_frames.back().variables) {
+			m_variables.at(identifier).pop_back();
+		}
+
+		for(const utility::string_table_key identifier : m_frames.back().types) {
+			m_types.at(identifier).pop_back();
+		}
+
+		m_frames.pop_back();
+	}
+
+	void symbol_table::enter_scope(handle<scope> scope) {
+		push_scope();
+
+		for(auto& [identifier, variable] : scope->variables) {
+			declare_variable(identifier, &variable);
+		}
+
+		for(auto& [identifier, type] : scope->types) {
+			declare_type(identifier, &type);
+		}
+	}
+
+	void symbol_table::declare_variable(utility::string_table_key identifier, handle<variable> variable) {
+		m_variables[identifier].push_back(variable);
+		m_frames.back().variables.push_back(identifier);
+	}
+
+	void symbol_table::declare_type(utility::string_table_key identifier, handle<type> type) {
+		m_types[identifier].push_back(type);
+		m_frames.back().types.push_back(identifier);
+	}
+
+	auto symbol_table::find_variable(utility::string_table_key identifier) const -> handle<variable> {
+		return detail::find_declaration(m_variables, identifier);
+	}
+
+	auto symbol_table::find_type(utility::string_table_key identifier) const -> handle<type> {
+		return detail::find_declaration(m_types, identifier);
+	}
+} // namespace sigma
@@ -0,0 +1,38 @@
+#pragma once
+#include "compiler/compiler/type_system/scope.h"
+
+namespace sigma {
+	/**
+	 * \brief Flat table of all declarations which are visible from the active scope. Every identifier
+	 * maps to a stack of its active declarations (the innermost one being on top), which means that
+	 * lookups don't depend on the depth of the scope tree.
+	 */
+	class symbol_table {
+	public:
+		void push_scope();
+		void pop_scope();
+
+		/**
+		 * \brief Pushes a new scope and makes all declarations contained in \b scope visible, used when
+		 * entering scopes which have already been populated.
+		 * \param scope Scope to enter
+		 */
+		void enter_scope(handle<scope> scope);
+
+		void declare_variable(utility::string_table_key identifier, handle<variable> variable);
+		void declare_type(utility::string_table_key identifier, handle<type> type);
+
+		auto find_variable(utility::string_table_key identifier) const -> handle<variable>;
+		auto find_type(utility::string_table_key identifier) const -> handle<type>;
+	private:
+		// identifiers declared in a single scope, removed once the scope is popped
+		struct frame {
+			std::vector<utility::string_table_key> variables;
+			std::vector<utility::string_table_key> types;
+		};
+
+		std::unordered_map<utility::string_table_key, std::vector<handle<variable>>> m_variables;
+		std::unordered_map<utility::string_table_key, std::vector<handle<type>>> m_types;
+		std::vector<frame> m_frames;
+	};
+} // namespace sigma
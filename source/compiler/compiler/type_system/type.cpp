@@ -1,4 +1,5 @@
 #include "type.h"
+#include "compiler/compiler/type_system/type_table.h"
 
 #include <utility/macros.h>
 
@@ -27,13 +28,16 @@ namespace sigma {
 
 		for (size_t i = 0; i < other.parameter_types.get_size(); ++i) {
 			if (parameter_types[i].type < other.parameter_types[i].type) { return true; }
-			if (parameter_types[i].type < other.parameter_types[i].type) { return false; }
+			if (other.parameter_types[i].type < parameter_types[i].type) { return false; }
 		}
 
 		return has_var_args < other.has_var_args;
 	}
 
 	namespace detail {
+		auto hash_combine(u64 seed, u64 value) -> u64 {
+			return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+		}
 
 		auto get_larger_type(type a, type b) -> type {
 			if (a.is_unknown() || b.is_unknown() || a.is_promote() || b.is_promote()) {
@@ -115,70 +119,56 @@ namespace sigma {
 			case token_type::CHAR: m_kind = CHAR; break;
 			case token_type::IDENTIFIER: {
 				// custom types, resolved in the type checker
-				m_kind = UNRESOLVED;
-				m_unresolved = token.symbol_key;
-				break;
+				*this = create_unresolved(token.symbol_key, pointer_level);
+				return;
 			}
 			default: PANIC("undefined token -> type conversion for token '{}'", token.tok.to_string());
 		}
+
+		m_id = type_table::get_primitive_id(m_kind, m_pointer_level);
 	}
 
 	type::type(kind kind, u8 pointer_level)
-		: m_kind(kind), m_pointer_level(pointer_level) {}
+		: m_id(type_table::get_primitive_id(kind, pointer_level)), m_kind(kind), m_pointer_level(pointer_level) {}
 
-	type::type() : m_kind(UNKNOWN) {}
+	type::type() : type(UNKNOWN, 0) {}
 
-	auto type::operator==(const type& other) const -> bool {
-		if(m_kind == other.m_kind && m_pointer_level == other.m_pointer_level) {
-			if(is_struct()) {
-				return m_identifier == other.m_identifier && m_namespaces == other.m_namespaces;
-			}
+	type::type(u32 id) : m_id(id) {
+		const type_descriptor& descriptor = type_table::get(id);
 
-			return true;
-		}
+		m_kind = descriptor.kind;
+		m_pointer_level = descriptor.pointer_level;
+	}
 
-		return false;
+	auto type::operator==(const type& other) const -> bool {
+		return m_id == other.m_id;
 	}
 
 	auto type::operator<(const type& other) const -> bool {
-		if(m_pointer_level < other.m_pointer_level) {
-			return true;
-		}
-
-		if(m_pointer_level > other.m_pointer_level) {
-			return false;
-		}
-
-		if(m_kind < other.m_kind) {
-			return true;
-		}
-
-		if(m_kind > other.m_kind) {
-			return false;
-		}
-
-		return m_identifier < other.m_identifier;
+		// order by id, just like we compare by id. ids of primitive types are reserved up front,
+		// ids of other types depend on the order in which they were interned, but overloads can
+		// only tie on the cost of integer casts, so overload resolution stays deterministic
+		return m_id < other.m_id;
 	}
 
 	auto type::create_member(const type& ty, utility::string_table_key identifier) -> type {
-		type member_ty = { ty.m_kind, ty.m_pointer_level };
+		type member_ty = ty;
 		member_ty.m_identifier = identifier;
 
-		if(ty.m_kind == UNRESOLVED) {
-			member_ty.m_unresolved = ty.m_unresolved;
-		}
-
 		return member_ty;
 	}
 
 	auto type::create_struct(const utility::memory_view<type, u8>& members, utility::string_table_key identifier) -> type {
-		type struct_ty = { STRUCT, 0 };
-		struct_ty.m_struct_members = members;
+		type struct_ty(type_table::intern({ .kind = STRUCT, .identifier = identifier, .members = members }));
 		struct_ty.m_identifier = identifier;
 
 		return struct_ty;
 	}
 
+	auto type::create_unresolved(utility::string_table_key identifier, u8 pointer_level) -> type {
+		return type(type_table::intern({ .kind = UNRESOLVED, .pointer_level = pointer_level, .identifier = identifier }));
+	}
+
 	auto type::create_unknown() -> type {
 		return { UNKNOWN, 0 };
 	}
@@ -233,23 +223,14 @@ namespace sigma {
 
 	auto type::get_member_offset(utility::string_table_key identifier) const -> u16 {
 		ASSERT(m_kind == STRUCT, "cannot calculate struct member offset on a non-struct type");
-		u16 offset = 0;
-
-		for (const auto& member : m_struct_members) {
-			// calculate padding based on alignment
-			const u16 alignment = member.get_alignment();
-			if (alignment != 0) {
-				const u16 padding = (alignment - (offset % alignment)) % alignment;
-				offset += padding;
-			}
+		const type_descriptor& descriptor = type_table::get(m_id);
 
-			// check if this is the target member
-			if (member.m_identifier == identifier) {
-				return offset;
-			}
+		ASSERT(descriptor.has_layout, "cannot calculate struct member offset on an unresolved type");
 
-			// add the size of the current member
-			offset += member.get_size();
+		for(u8 i = 0; i < descriptor.members.get_size(); ++i) {
+			if(descriptor.members[i].m_identifier == identifier) {
+				return descriptor.member_offsets[i];
+			}
 		}
 
 		PANIC("unknown member");
@@ -257,82 +238,23 @@ namespace sigma {
 	}
 
 	auto type::get_alignment() const -> u16 {
-		if (m_pointer_level > 0) {
-			return 8;
-		}
+		const type_descriptor& descriptor = type_table::get(m_id);
 
-		switch(m_kind) {
-			case VAR_ARG_PROMOTE: return 0;
-			case UNKNOWN:         return 0;
-			case VOID:            return 0;
-			case I8:              return 1;
-			case I16:             return 2;
-			case I32:             return 4;
-			case I64:             return 8;
-			case U8:              return 1;
-			case U16:             return 2;
-			case U32:             return 4;
-			case U64:             return 8;
-			case BOOL:            return 1;
-			case CHAR:            return 1;
-			case STRUCT: {
-				u16 max_alignment = 0;
-
-				for (const auto& member : m_struct_members) {
-					max_alignment = std::max(max_alignment, member.get_alignment());
-				}
-
-				return max_alignment;
-			}
-			default: PANIC("undefined byte width for type '{}'", to_string());
+		if(!descriptor.has_layout) {
+			PANIC("undefined byte width for type '{}'", to_string());
 		}
 
-		return 0;
+		return descriptor.alignment;
 	}
 
 	auto type::get_size() const -> u16 {
-		if (m_pointer_level > 0) {
-			return 8;
-		}
-
-		switch (m_kind) {
-			case VAR_ARG_PROMOTE: return 0;
-			case UNKNOWN:         return 0;
-			case VOID:            return 0;
-			case I8:              return 1;
-			case I16:             return 2;
-			case I32:             return 4;
-			case I64:             return 8;
-			case U8:              return 1;
-			case U16:             return 2;
-			case U32:             return 4;
-			case U64:             return 8;
-			case BOOL:            return 1;
-			case CHAR:            return 1;
-			case STRUCT: {
-				u16 total_size = 0;
-				u16 max_alignment = 0;
+		const type_descriptor& descriptor = type_table::get(m_id);
 
-				for (const auto& member : m_struct_members) {
-					const u16 alignment = member.get_alignment();
-					const u16 padding = (alignment - (total_size % alignment)) % alignment;
-
-					max_alignment = std::max(max_alignment, alignment);
-
-					// align the current total size to the member's alignment requirement
-					total_size += padding + member.get_size();
-				}
-
-				// align the total size of the struct to the largest member's alignment
-				const u16 struct_padding = (max_alignment - (total_size % max_alignment)) % max_alignment;
-				total_size += struct_padding;
-
-				return total_size;
-			}
-			default: PANIC("undefined byte size for type '{}'", to_string());
+		if(!descriptor.has_layout) {
+			PANIC("undefined byte size for type '{}'", to_string());
 		}
 
-		return 0;
+		return descriptor.size;
 	}
 
 	auto type::get_member_identifier() const -> utility::string_table_key {
@@ -341,21 +263,16 @@ namespace sigma {
 
 	auto type::get_struct_members() const -> const utility::memory_view<type, u8>& {
 		ASSERT(m_kind == STRUCT, "cannot get struct members from a non-struct type");
-		return m_struct_members;
-	}
-
-	auto type::get_struct_members() -> utility::memory_view<type, u8>& {
-		ASSERT(m_kind == STRUCT, "cannot get struct members from a non-struct type");
-		return m_struct_members;
+		return type_table::get(m_id).members;
 	}
 
 	auto type::get_unresolved() const -> utility::string_table_key {
 		ASSERT(m_kind == UNRESOLVED, "cannot get unresolved typename from a resolved type");
-		return m_unresolved;
+		return type_table::get(m_id).identifier;
 	}
 
 	auto type::get_namespaces() const -> const namespace_list& {
-		return m_namespaces;
+		return type_table::get(m_id).namespaces;
 	}
 
 	auto type::get_pointer_level() const -> u8 {
@@ -366,22 +283,45 @@ namespace sigma {
 		return m_kind;
 	}
 
-	void type::set_struct_members(const utility::memory_view<type, u8>& members) {
-		m_struct_members = members;
+	auto type::get_id() const -> u32 {
+		return m_id;
 	}
 
 	void type::set_namespaces(const namespace_list& namespaces) {
-		m_namespaces = namespaces;
-	}
+		if(namespaces.empty() && get_namespaces().empty()) {
+			return;
+		}
+
+		type_descriptor descriptor = type_table::get(m_id);
+		descriptor.namespaces = namespaces;
 
-	void type::set_kind(kind kind) {
-		m_kind = kind;
+		m_id = type_table::intern(descriptor);
 	}
 
 	auto type::dereference(u8 level) const -> type {
-		ASSERT(m_pointer_level - level >= 0, "cannot create a negative pointer level");
-		const u8 new_pointer_level = m_pointer_level - level;
-		return { m_kind, new_pointer_level };
+		ASSERT(m_pointer_level >= level, "cannot create a negative pointer level");
+		return with_pointer_level(m_pointer_level - level);
+	}
+
+	auto type::create_pointer(u8 level) const -> type {
+		return with_pointer_level(m_pointer_level + level);
+	}
+
+	auto type::with_pointer_level(u8 pointer_level) const -> type {
+		type result;
+
+		if(type_table::is_primitive_id(m_id)) {
+			result = { m_kind, pointer_level };
+		}
+		else {
+			type_descriptor descriptor = type_table::get(m_id);
+			descriptor.pointer_level = pointer_level;
+
+			result = type(type_table::intern(descriptor));
+		}
+
+		result.m_identifier = m_identifier;
+		return result;
 	}
 
 	auto type::to_string() const -> std::string {
@@ -404,7 +344,7 @@ namespace sigma {
 			case UNRESOLVED:      result = "unresolved"; break;
 			case STRUCT: {
 				result = "struct{ ";
-				for (const auto& member : m_struct_members) {
+				for (const auto& member : get_struct_members()) {
 					result += member.to_string() + " ";
 				}
 
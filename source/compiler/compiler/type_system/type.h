@@ -32,6 +32,7 @@ namespace sigma {
 		static auto create_struct(const utility::memory_view<type, u8>& members, utility::string_table_key identifier) -> type;
 		static auto create_member(const type& ty, utility::string_table_key identifier) -> type;
 
+		static auto create_unresolved(utility::string_table_key identifier, u8 pointer_level = 0) -> type;
 		static auto create_unknown() -> type;
 		static auto create_promote() -> type;
 
@@ -55,17 +56,16 @@ namespace sigma {
 
 		auto get_member_identifier() const -> utility::string_table_key;
 		auto get_struct_members() const -> const utility::memory_view<type, u8>&;
-		auto get_struct_members() -> utility::memory_view<type, u8>&;
 		auto get_unresolved() const -> utility::string_table_key;
 		auto get_namespaces() const -> const namespace_list&;
 		auto get_pointer_level() const -> u8;
 		auto get_kind() const -> kind;
+		auto get_id() const -> u32;
 
-		void set_struct_members(const utility::memory_view<type, u8>& members);
 		void set_namespaces(const namespace_list& namespaces);
-		void set_kind(kind kind);
 
 		auto dereference(u8 level) const -> type;
+		auto create_pointer(u8 level) const -> type;
 		auto to_string() const -> std::string;
 
 		auto is_pure_void() const -> bool;
@@ -90,25 +90,23 @@ namespace sigma {
 		auto operator==(const type& other) const -> bool;
 		auto operator<(const type& other) const -> bool;
 	private:
+		explicit type(u32 id);
+
+		auto with_pointer_level(u8 pointer_level) const -> type;
+	private:
+		// the type itself is interned in the type table (see type_table.h), the kind and pointer
+		// level are kept around, since they're queried all the time
+		u32 m_id;
 		kind m_kind;
 		u8 m_pointer_level; // level of indirection
 
-		// struct member identifiers
-		// struct name identifier
-		utility::string_table_key m_identifier;
-		namespace_list m_namespaces = {};
-
-		union {
-			// UNRESOLVED
-			// unresolved types only provide the type name
-			utility::string_table_key m_unresolved;
-
-			// STRUCT
-			utility::memory_view<type, u8> m_struct_members;
-		};
+		// member identifier, or struct name identifier, not a part of the type itself
+		utility::string_table_key m_identifier = {};
 	};
 
 	namespace detail {
+		auto hash_combine(u64 seed, u64 value) -> u64;
+
 		auto get_larger_type(type a, type b) -> type;
 		auto promote_type(type ty) -> type;
 	} // namespace detail
@@ -0,0 +1,206 @@
+#include "type_table.h"
+
+#include <utility/macros.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace sigma {
+	auto type_descriptor::operator==(const type_descriptor& other) const -> bool {
+		if(
+			kind != other.kind ||
+			pointer_level != other.pointer_level ||
+			identifier != other.identifier ||
+			!(namespaces == other.namespaces) ||
+			members.get_size() != other.members.get_size()
+		) {
+			return false;
+		}
+
+		// members are part of the layout, their identifiers therefore have to match as well
+		for(u8 i = 0; i < members.get_size(); ++i) {
+			if(
+				members[i].get_id() != other.members[i].get_id() ||
+				members[i].get_member_identifier() != other.members[i].get_member_identifier()
+			) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	auto type_descriptor::hash() const -> u64 {
+		u64 hash = static_cast<u64>(kind) << 8 | pointer_level;
+		hash = detail::hash_combine(hash, std::hash<utility::string_table_key>{}(identifier));
+
+		for(const utility::string_table_key key : namespaces) {
+			hash = detail::hash_combine(hash, std::hash<utility::string_table_key>{}(key));
+		}
+
+		for(const type& member : members) {
+			hash = detail::hash_combine(hash, member.get_id());
+			hash = detail::hash_combine(hash, std::hash<utility::string_table_key>{}(member.get_member_identifier()));
+		}
+
+		return hash;
+	}
+
+	auto type_table::intern(const type_descriptor& descriptor) -> u32 {
+		if(
+			descriptor.identifier == utility::string_table_key{} &&
+			descriptor.namespaces.empty() &&
+			descriptor.members.get_size() == 0
+		) {
+			return get_primitive_id(descriptor.kind, descriptor.pointer_level);
+		}
+
+		type_table& table = get_instance();
+		const u64 hash = descriptor.hash();
+
+		std::lock_guard lock(table.m_mutex);
+		const auto [first, last] = table.m_ids.equal_range(hash);
+
+		for(auto it = first; it != last; ++it) {
+			if(table.get_descriptor(it->second) == descriptor) {
+				return it->second;
+			}
+		}
+
+		const u32 id = table.insert(descriptor);
+		table.m_ids.emplace(hash, id);
+		return id;
+	}
+
+	auto type_table::get(u32 id) -> const type_descriptor& {
+		return get_instance().get_descriptor(id);
+	}
+
+	type_table::type_table() : m_allocator(1024) {
+		// reserve ids of all primitive types
+		for(u32 kind = 0; kind <= type::STRUCT; ++kind) {
+			for(u32 pointer_level = 0; pointer_level <= std::numeric_limits<u8>::max(); ++pointer_level) {
+				insert({ .kind = static_cast<type::kind>(kind), .pointer_level = static_cast<u8>(pointer_level) });
+			}
+		}
+	}
+
+	type_table::~type_table() {
+		for(const std::atomic<type_descriptor*>& segment : m_segments) {
+			delete[] segment.load();
+		}
+	}
+
+	auto type_table::get_instance() -> type_table& {
+		static type_table table;
+		return table;
+	}
+
+	auto type_table::insert(const type_descriptor& descriptor) -> u32 {
+		ASSERT(m_size < std::numeric_limits<u32>::max() - (1u << first_segment_bits), "type table overflow");
+		const u32 id = m_size++;
+		const u32 segment = std::bit_width((id >> first_segment_bits) + 1) - 1;
+
+		if(m_segments[segment].load(std::memory_order_relaxed) == nullptr) {
+			m_segments[segment].store(new type_descriptor[1ull << (first_segment_bits + segment)], std::memory_order_release);
+		}
+
+		type_descriptor& target = get_descriptor(id);
+
+		target.kind = descriptor.kind;
+		target.pointer_level = descriptor.pointer_level;
+		target.identifier = descriptor.identifier;
+
+		// the source descriptor may refer to memory which doesn't outlive the table
+		utility::memory_view<utility::string_table_key> namespaces(m_allocator, descriptor.namespaces.size());
+		utility::copy(namespaces, descriptor.namespaces);
+		target.namespaces = namespaces;
+
+		utility::memory_view<type, u8> members(m_allocator, descriptor.members.get_size());
+		utility::copy(members, descriptor.members);
+		target.members = members;
+
+		compute_layout(target);
+		return id;
+	}
+
+	auto type_table::get_descriptor(u32 id) const -> type_descriptor& {
+		const u32 segment = std::bit_width((id >> first_segment_bits) + 1) - 1;
+		const u32 offset = id - (((1u << segment) - 1) << first_segment_bits);
+
+		return m_segments[segment].load(std::memory_order_acquire)[offset];
+	}
+
+	void type_table::compute_layout(type_descriptor& descriptor) {
+		switch(descriptor.kind) {
+			case type::VAR_ARG_PROMOTE:
+			case type::UNKNOWN:
+			case type::VOID: descriptor.size = 0; descriptor.alignment = 0; break;
+			case type::I8:
+			case type::U8:
+			case type::BOOL:
+			case type::CHAR: descriptor.size = 1; descriptor.alignment = 1; break;
+			case type::I16:
+			case type::U16:  descriptor.size = 2; descriptor.alignment = 2; break;
+			case type::I32:
+			case type::U32:  descriptor.size = 4; descriptor.alignment = 4; break;
+			case type::I64:
+			case type::U64:  descriptor.size = 8; descriptor.alignment = 8; break;
+			case type::STRUCT: {
+				const bool has_member_layouts = std::ranges::all_of(descriptor.members, [](const type& member) {
+					return get(member.get_id()).has_layout;
+				});
+
+				// structs containing unresolved types can't be laid out yet, pointers to them can
+				if(!has_member_layouts) {
+					if(descriptor.pointer_level == 0) {
+						return;
+					}
+
+					break;
+				}
+
+				u16 offset = 0;
+				u16 max_alignment = 0;
+
+				descriptor.member_offsets.reserve(descriptor.members.get_size());
+
+				for(const type& member : descriptor.members) {
+					const type_descriptor& member_descriptor = get(member.get_id());
+					const u16 alignment = member_descriptor.alignment;
+
+					// align the current offset to the member's alignment requirement
+					if(alignment != 0) {
+						offset += (alignment - (offset % alignment)) % alignment;
+					}
+
+					max_alignment = std::max(max_alignment, alignment);
+					descriptor.member_offsets.push_back(offset);
+					offset += member_descriptor.size;
+				}
+
+				// align the total size of the struct to the largest member's alignment
+				if(max_alignment != 0) {
+					offset += (max_alignment - (offset % max_alignment)) % max_alignment;
+				}
+
+				descriptor.size = offset;
+				descriptor.alignment = max_alignment;
+				break;
+			}
+			default: {
+				// unresolved and floating point types don't have a layout
+				if(descriptor.pointer_level == 0) {
+					return;
+				}
+			}
+		}
+
+		if(descriptor.pointer_level > 0) {
+			descriptor.size = 8;
+			descriptor.alignment = 8;
+		}
+
+		descriptor.has_layout = true;
+	}
+} // namespace sigma
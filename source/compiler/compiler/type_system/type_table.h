@@ -0,0 +1,89 @@
+#pragma once
+#include <utility/allocators/block_allocator.h>
+
+#include "compiler/compiler/type_system/type.h"
+
+#include <atomic>
+#include <array>
+#include <mutex>
+
+namespace sigma {
+	/**
+	 * \brief Structure of a single interned type, together with its layout.
+	 */
+	struct type_descriptor {
+		auto operator==(const type_descriptor& other) const -> bool;
+		auto hash() const -> u64;
+
+		type::kind kind = type::UNKNOWN;
+		u8 pointer_level = 0;
+
+		utility::string_table_key identifier = {}; // struct/unresolved type name
+		namespace_list namespaces;                 // namespaces the type name was qualified with
+		utility::memory_view<type, u8> members;    // struct members, in declaration order
+
+		// layout, computed once the type is interned, types which contain unresolved types don't
+		// have a layout
+		bool has_layout = false;
+		u16 size = 0;
+		u16 alignment = 0;
+		std::vector<u16> member_offsets;
+	};
+
+	/**
+	 * \brief Global table of hash-consed types. Every distinct type is stored exactly once and
+	 * referenced by a 32-bit id, which means that types can be compared by comparing their ids.
+	 * Interning is thread safe, and descriptors never move once they've been interned, so they can be
+	 * read without any synchronization.
+	 */
+	class type_table {
+	public:
+		/**
+		 * \brief Looks up the id of \b descriptor, the descriptor is copied into the table if it
+		 * hasn't been interned yet.
+		 * \param descriptor Descriptor to intern, the layout doesn't have to be filled in
+		 * \return Id of the interned type.
+		 */
+		static auto intern(const type_descriptor& descriptor) -> u32;
+		static auto get(u32 id) -> const type_descriptor&;
+
+		/**
+		 * \brief Ids of types which are only described by their kind and pointer level are reserved
+		 * up front, and can therefore be computed without touching the table.
+		 */
+		static constexpr auto get_primitive_id(type::kind kind, u8 pointer_level) -> u32 {
+			return static_cast<u32>(kind) << 8 | pointer_level;
+		}
+
+		static constexpr auto is_primitive_id(u32 id) -> bool {
+			return id < primitive_count;
+		}
+	private:
+		type_table();
+		~type_table();
+
+		static auto get_instance() -> type_table&;
+
+		auto insert(const type_descriptor& descriptor) -> u32;
+		auto get_descriptor(u32 id) const -> type_descriptor&;
+
+		static void compute_layout(type_descriptor& descriptor);
+	private:
+		static constexpr u32 primitive_count = (type::STRUCT + 1) << 8;
+
+		// descriptors are stored in segments which double in size, segment i holds
+		// 2^(first_segment_bits + i) descriptors, existing segments are never reallocated
+		static constexpr u32 first_segment_bits = 12;
+		static constexpr u32 segment_count = 32 - first_segment_bits;
+
+		std::mutex m_mutex;
+		std::array<std::atomic<type_descriptor*>, segment_count> m_segments = {};
+		u32 m_size = 0;
+
+		// descriptor hash -> ids of descriptors with that hash
+		std::unordered_multimap<u64, u32> m_ids;
+
+		// storage for namespaces and members of interned descriptors
+		utility::block_allocator m_allocator;
+	};
+} // namespace sigma
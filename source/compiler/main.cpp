@@ -5,7 +5,7 @@ using namespace utility::types;
 
 i32 compile(const parametric::parameters& params) {
 	const sigma::compiler_description description {
-		.source_path = params.get<filepath>("file"),
+		.source_paths = params.get<std::vector<filepath>>("files"),
 		.emit_path = params.get<filepath>("emit"),
 
 		// default to x64 win for now
@@ -13,6 +13,11 @@ i32 compile(const parametric::parameters& params) {
 			params.get<sigma::ir::arch>("arch"),
 			params.get<sigma::ir::system>("system")
 		},
+
+		.job_count = params.get<u64>("jobs"),
+		.token_chunk_size = params.get<u64>("token-chunk-size"),
+		.token_stream_size = params.get<u64>("token-stream-size"),
+		.cache_path = params.get<filepath>("cache")
 	};
 
 	// compile the specified description, check for errors after we finish
@@ -26,6 +31,34 @@ i32 compile(const parametric::parameters& params) {
 	return 0;
 }
 
+i32 run(const parametric::parameters& params) {
+	// the program is executed in-process, so we always compile for the host
+#ifdef SYSTEM_WINDOWS
+	constexpr sigma::ir::system host_system = sigma::ir::system::WINDOWS;
+#else
+	constexpr sigma::ir::system host_system = sigma::ir::system::LINUX;
+#endif
+
+	const sigma::compiler_description description {
+		.source_paths = params.get<std::vector<filepath>>("files"),
+		.target = { sigma::ir::arch::X64, host_system },
+		.job_count = params.get<u64>("jobs"),
+		.token_chunk_size = params.get<u64>("token-chunk-size"),
+		.token_stream_size = params.get<u64>("token-stream-size"),
+		.cache_path = params.get<filepath>("cache")
+	};
+
+	// compile and run the specified description, forward the exit code of the program
+	const auto result = sigma::compiler::run(description);
+
+	if (result.has_error()) {
+		utility::console::printerr("{}\n", result.get_error().get_message());
+		return 1;
+	}
+
+	return result.get_value();
+}
+
 i32 show_docs(const parametric::parameters& params) {
 	SUPPRESS_C4100(params);
 
@@ -46,12 +79,23 @@ auto main(i32 argc, char* argv[]) -> i32 {
 	// compilation
 	auto& compile_command = program.add_command("compile", "compile the specified source file", compile);
 
-	compile_command.add_positional_argument<filepath>("file", "source file to compile");
+	compile_command.add_positional_argument<std::vector<filepath>>("files", "comma separated list of source files to compile");
 	compile_command.add_flag<filepath>("emit", "filepath to emit to", "e", "./a.obj");
 	compile_command.add_flag<sigma::ir::arch>("arch", "CPU architecture to compile for [x64]", "", sigma::ir::arch::X64);
 	compile_command.add_flag<sigma::ir::system>("system", "operating system to compile for [windows, linux]", "", sigma::ir::system::WINDOWS);
-
-	// TODO: add support for emitting multiple files at once
+	compile_command.add_flag<u64>("jobs", "number of threads to compile with (0 = all hardware threads)", "j", 1);
+	compile_command.add_flag<u64>("token-chunk-size", "size of source files above which they're tokenized in parallel chunks, in bytes", "", 4 * 1024 * 1024);
+	compile_command.add_flag<u64>("token-stream-size", "size of source files above which they're tokenized while being parsed, in bytes", "", 1024 * 1024);
+	compile_command.add_flag<filepath>("cache", "directory to cache parsed source files in (empty = disabled)", "", "");
+
+	// in-process execution
+	auto& run_command = program.add_command("run", "compile and run the specified source file, without emitting anything", run);
+
+	run_command.add_positional_argument<std::vector<filepath>>("files", "comma separated list of source files to run");
+	run_command.add_flag<u64>("jobs", "number of threads to compile with (0 = all hardware threads)", "j", 1);
+	run_command.add_flag<u64>("token-chunk-size", "size of source files above which they're tokenized in parallel chunks, in bytes", "", 4 * 1024 * 1024);
+	run_command.add_flag<u64>("token-stream-size", "size of source files above which they're tokenized while being parsed, in bytes", "", 1024 * 1024);
+	run_command.add_flag<filepath>("cache", "directory to cache parsed source files in (empty = disabled)", "", "");
 
 	// documentation
 	program.add_command("docs", "show project documentation", show_docs);
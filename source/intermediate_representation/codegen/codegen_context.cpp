@@ -16,13 +16,30 @@ namespace sigma::ir {
 		return static_cast<symbol_patch*>(function->allocator.allocate_zero(sizeof(symbol_patch)));
 	}
 
+	void codegen_context::allocate_node_tables() {
+		const u64 node_count = function->node_count;
+
+		virtual_values.assign(node_count, virtual_value());
+		defined_virtual_values.assign(node_count, false);
+		stack_slots.assign(node_count, invalid_stack_slot);
+		schedule.assign(node_count, nullptr);
+	}
+
 	auto codegen_context::lookup_virtual_value(handle<node> value) -> handle<virtual_value> {
-		const auto it = virtual_values.find(value->global_value_index);
-		if(it == virtual_values.end()) {
+		if(!defined_virtual_values[value->global_value_index]) {
 			return nullptr;
 		}
 
-		return &it->second;
+		return &virtual_values[value->global_value_index];
+	}
+
+	auto codegen_context::define_virtual_value(handle<node> value) -> handle<virtual_value> {
+		defined_virtual_values[value->global_value_index] = true;
+		return &virtual_values[value->global_value_index];
+	}
+
+	auto codegen_context::get_machine_block(handle<node> node) -> handle<machine_block> {
+		return &machine_blocks[graph.get_traversal_index(node)];
 	}
 
 	auto codegen_context::allocate_stack(u64 size, u64 alignment) -> i32 {
@@ -31,19 +48,17 @@ namespace sigma::ir {
 	}
 
 	auto codegen_context::get_stack_slot(handle<node> node) -> i32 {
-		// check if a stack slot for the node already exists 
-		const auto it = stack_slots.find(node);
+		i32& slot = stack_slots[node->global_value_index];
 
-		// if it exists, return the stack position
-		if (it != stack_slots.end()) {
-			return it->second;
+		// if a stack slot for the node already exists, return the stack position
+		if (slot != invalid_stack_slot) {
+			return slot;
 		}
 
 		// allocate a new stack slot for the given node
 		const local& local_prop = node->get<local>();
-		const i32 position = allocate_stack(local_prop.size, local_prop.alignment);
-		stack_slots[node] = position;
+		slot = allocate_stack(local_prop.size, local_prop.alignment);
 
-		return position;
+		return slot;
 	}
 } // namespace sigma::ir
@@ -9,13 +9,33 @@
 
 namespace sigma::ir {
 	struct codegen_context {
+		/**
+		 * \brief Allocates the side tables which are indexed by the global value index of
+		 * individual nodes. Has to be called before the control flow graph is generated.
+		 */
+		void allocate_node_tables();
+
 		/**
 		 * \brief Looks up a virtual value for the given node.
 		 * \param value Node to look for
-		 * \return Respective virtual value.
+		 * \return Respective virtual value, nullptr if the node doesn't define one.
 		 */
 		auto lookup_virtual_value(handle<node> value) -> handle<virtual_value>;
 
+		/**
+		 * \brief Marks the given node as one which defines a virtual value.
+		 * \param value Node to define a virtual value for
+		 * \return Respective virtual value (existing values are kept).
+		 */
+		auto define_virtual_value(handle<node> value) -> handle<virtual_value>;
+
+		/**
+		 * \brief Retrieves the machine block which starts at the given \b node.
+		 * \param node Basic block entry node
+		 * \return Respective machine block.
+		 */
+		auto get_machine_block(handle<node> node) -> handle<machine_block>;
+
 		/**
 		 * \brief Allocates \b size bytes of stack space aligned with to \b alignment.
 		 * \param size Number of bytes to allocate
@@ -98,13 +118,20 @@ namespace sigma::ir {
 		std::vector<u32> labels; 
 
 		// virtual values which represent physical memory / values which are passed around when the
-		// program runs 
-		std::unordered_map<u64, virtual_value> virtual_values;
-		std::unordered_map<handle<node>, i32> stack_slots;
+		// program runs, indexed by the global value index of the respective node
+		std::vector<virtual_value> virtual_values;
+		std::vector<bool> defined_virtual_values;
+
+		// stack positions of locals, indexed by the global value index of the respective node
+		std::vector<i32> stack_slots;
+
+		// schedule generated by the scheduler, indexed by the global value index of the given node
+		std::vector<handle<basic_block>> schedule;
+
+		// machine blocks, indexed by the reverse post order index of the respective basic block
+		std::vector<machine_block> machine_blocks;
 
-		// schedule generated by the scheduler
-		std::unordered_map<handle<node>, handle<basic_block>> schedule;
-		std::unordered_map<handle<node>, machine_block> machine_blocks;
+		static constexpr i32 invalid_stack_slot = std::numeric_limits<i32>::max();
 
 		// NOTE: potentially replace with a linked list?
 		handle<instruction> first;
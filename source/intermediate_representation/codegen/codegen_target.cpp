@@ -9,9 +9,13 @@
 #include "intermediate_representation/target/outputs/coff.h"
 #include "intermediate_representation/target/outputs/elf.h"
 
+// executables
+#include "intermediate_representation/target/outputs/elf_executable.h"
+
 namespace sigma::ir {
 	codegen_target::codegen_target(target target) : m_target(target) {
 		m_object_file_emitter = pick_object_file_emitter(m_target.get_system());
+		m_executable_emitter  = pick_executable_emitter(m_target.get_system());
 		m_architecture        = pick_architecture(m_target.get_arch());
 		m_disassembler        = pick_disassembler(m_target.get_arch());
 	}
@@ -55,6 +59,15 @@ namespace sigma::ir {
 		return m_object_file_emitter->emit(module);
 	}
 
+	auto codegen_target::emit_executable(module& module) const -> utility::byte_buffer {
+		ASSERT(m_executable_emitter != nullptr, "executables are not supported for the given target");
+		return m_executable_emitter->emit(module);
+	}
+
+	auto codegen_target::supports_executables(system system) -> bool {
+		return pick_executable_emitter(system) != nullptr;
+	}
+
 	auto codegen_target::pick_object_file_emitter(system system) -> s_ptr<object_file_emitter> {
 		switch (system) {
 			case system::WINDOWS: return std::make_shared<coff_file_emitter>();
@@ -65,6 +78,16 @@ namespace sigma::ir {
 		return nullptr;
 	}
 
+	auto codegen_target::pick_executable_emitter(system system) -> s_ptr<object_file_emitter> {
+		switch (system) {
+			case system::WINDOWS: return nullptr; // not supported yet, link the object file instead
+			case system::LINUX:   return std::make_shared<elf_executable_emitter>();
+		}
+
+		NOT_IMPLEMENTED();
+		return nullptr;
+	}
+
 	auto codegen_target::pick_architecture(arch arch) -> s_ptr<architecture> {
 		switch (arch) {
 			case arch::X64: return std::make_shared<x64_architecture>();
@@ -20,8 +20,17 @@ namespace sigma::ir {
 		auto generate_sections(module& module) const -> module_output;
 		auto disassemble(const utility::byte_buffer& bytecode, const codegen_context& context) const -> std::stringstream;
 		auto emit_object_file(module& module) const -> utility::byte_buffer;
+		auto emit_executable(module& module) const -> utility::byte_buffer;
+
+		/**
+		 * \brief Checks whether executables can be emitted for the given \b system.
+		 * \param system System to check
+		 * \return True if an executable emitter exists for the given system.
+		 */
+		static auto supports_executables(system system) -> bool;
 	private:
 		static auto pick_object_file_emitter(system system) -> s_ptr<object_file_emitter>;
+		static auto pick_executable_emitter(system system) -> s_ptr<object_file_emitter>;
 		static auto pick_architecture(arch arch) -> s_ptr<architecture>;
 		static auto pick_disassembler(arch arch) -> s_ptr<disassembler>;
 
@@ -29,6 +38,7 @@ namespace sigma::ir {
 		static auto generate_linux_sections() -> module_output;
 	private:
 		s_ptr<object_file_emitter> m_object_file_emitter;
+		s_ptr<object_file_emitter> m_executable_emitter;
 		s_ptr<architecture> m_architecture;
 		s_ptr<disassembler> m_disassembler;
 
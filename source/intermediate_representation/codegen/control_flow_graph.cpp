@@ -2,19 +2,23 @@
 #include "intermediate_representation/codegen/codegen_context.h"
 
 namespace sigma::ir {
+	auto control_flow_graph::get_block(handle<node> target) -> handle<basic_block> {
+		const u64 index = try_get_traversal_index(target);
+		return index != invalid_index ? &blocks[index] : nullptr;
+	}
+
 	auto control_flow_graph::get_immediate_dominator(handle<node> target) -> handle<node> {
-		const auto it = blocks.find(target);
-		if (it == blocks.end()) {
+		const handle<basic_block> block = get_block(target);
+		if (block == nullptr) {
 			return nullptr;
 		}
 
-		const handle<basic_block> dom = it->second.dominator;
+		const handle<basic_block> dom = block->dominator;
 		return dom ? dom->start : nullptr;
 	}
 
 	auto control_flow_graph::get_predecessor(handle<node> target, u64 index) -> handle<node> {
-		const auto it = blocks.find(target->inputs[index]);
-		if (it != blocks.end()) {
+		if (get_block(target->inputs[index])) {
 			return target->inputs[index];
 		}
 
@@ -22,16 +26,21 @@ namespace sigma::ir {
 	}
 
 	auto control_flow_graph::try_get_traversal_index(handle<node> target) -> u64 {
-		const auto it = blocks.find(target);
-		if (it == blocks.end()) {
-			return std::numeric_limits<u64>::max();
+		if (target->global_value_index >= block_indices.size()) {
+			return invalid_index;
 		}
 
-		return it->second.id;
+		return block_indices[target->global_value_index];
 	}
 
 	auto control_flow_graph::get_traversal_index(handle<node> target) const -> u64 {
-		return blocks.at(target).id;
+		ASSERT(
+			target->global_value_index < block_indices.size() &&
+			block_indices[target->global_value_index] != invalid_index,
+			"node does not start a basic block"
+		);
+
+		return block_indices[target->global_value_index];
 	}
 
 	auto control_flow_graph::resolve_dominator_depth(handle<node> basic_block) -> i32 {
@@ -42,12 +51,12 @@ namespace sigma::ir {
 
 		// depth should be higher that its parent
 		const i32 parent = resolve_dominator_depth(get_immediate_dominator(basic_block));
-		blocks.at(basic_block).dominator_depth = parent + 1;
+		get_block(basic_block)->dominator_depth = parent + 1;
 		return parent + 1;
 	}
 
 	auto control_flow_graph::get_dominator_depth(handle<node> target) const -> i32 {
-		return blocks.at(target).dominator_depth;
+		return blocks[get_traversal_index(target)].dominator_depth;
 	}
 
 	auto control_flow_graph::compute_reverse_post_order(const codegen_context& context) -> control_flow_graph {
@@ -59,6 +68,8 @@ namespace sigma::ir {
 		std::vector<handle<node>> stack;
 		control_flow_graph graph;
 
+		graph.block_indices.assign(context.function->node_count, invalid_index);
+
 		const handle<node> entry = context.function->entry_node;
 		context.work.visit(entry);
 		stack.push_back(entry);
@@ -108,7 +119,8 @@ namespace sigma::ir {
 				basic_block.end             = top;
 
 				context.work.items.push_back(block_entry);
-				graph.blocks[block_entry] = basic_block;
+				graph.block_indices[block_entry->global_value_index] = basic_block.id;
+				graph.blocks.push_back(basic_block);
 			}
 
 			// add successors
@@ -5,6 +5,8 @@ namespace sigma::ir {
 	struct codegen_context;
 
 	struct control_flow_graph {
+		auto get_block(handle<node> target) -> handle<basic_block>;
+
 		auto get_immediate_dominator(handle<node> target) -> handle<node>;
 		auto get_predecessor(handle<node> target, u64 index) -> handle<node>;
 
@@ -15,6 +17,13 @@ namespace sigma::ir {
 
 		static auto compute_reverse_post_order(const codegen_context& context) -> control_flow_graph;
 
-		std::unordered_map<handle<node>, basic_block> blocks;
+		// basic blocks in reverse post order
+		std::vector<basic_block> blocks;
+
+		// reverse post order index of every block entry, indexed by the global value index of the
+		// entry node (invalid_index for nodes which don't start a block)
+		std::vector<u64> block_indices;
+
+		static constexpr u64 invalid_index = std::numeric_limits<u64>::max();
 	};
 } // namespace sigma::ir
@@ -45,8 +45,8 @@ namespace sigma::ir {
 		void set_type(type type);
 		auto get_type() const -> type;
 
-		u8 reg;
-		u8 index;
+		reg::id_type reg;
+		reg::id_type index;
 		memory_scale scale;
 
 		i32 immediate; // TODO: investigate whether we actually need this
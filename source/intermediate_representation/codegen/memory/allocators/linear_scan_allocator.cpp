@@ -15,8 +15,7 @@ namespace sigma::ir {
 
 		// create intervals 
 		for (u64 i = context.basic_block_order.size(); i-- > 0;) {
-			handle<node> basic_block = context.work.items[context.basic_block_order[i]];
-			const handle machine_block = &context.machine_blocks.at(basic_block);
+			const handle machine_block = &context.machine_blocks[context.basic_block_order[i]];
 			const u64 block_start = machine_block->start;
 			const u64 black_end = machine_block->end + 2;
 			auto& live_out = machine_block->live_out;
@@ -51,23 +50,20 @@ namespace sigma::ir {
 
 		mark_callee_saved_constraints(context);
 
-		// generate unhandled interval list (sorted by starting point)
+		// generate unhandled interval list (ordered by starting point)
 		for(u64 i = 0; i < interval_count; ++i) {
 			context.intervals[i].active_range = context.intervals[i].ranges.size() - 1;
-			m_unhandled.push_back(i);
+			m_unhandled.emplace_back(context.intervals[i].get_start(), i);
 		}
 
-		quick_sort_definitions(
-			context.intervals, 0, static_cast<ptr_diff>(interval_count) - 1, m_unhandled
-		);
+		std::ranges::make_heap(m_unhandled, std::greater<>());
 
 		// linear scan main loop
 		while(!m_unhandled.empty()) {
-			const u64 register_index = m_unhandled.back();
+			const u64 register_index = pop_unhandled();
 
 			handle interval = &context.intervals[register_index];
 			u64 time = interval->ranges[interval->active_range].start;
-			m_unhandled.pop_back();
 
 			ASSERT(time != std::numeric_limits<u64>::max(), "panic");
 
@@ -118,8 +114,7 @@ namespace sigma::ir {
 
 		// move the resolver
 		for(const u64 block_order : context.basic_block_order) {
-			handle<node> basic_block = context.work.items[block_order];
-			auto machine_block = &context.machine_blocks.at(basic_block);
+			auto machine_block = &context.machine_blocks[block_order];
 			const auto end_node = machine_block->end_node;
 
 			for(handle<user> use = end_node->use; use; use = use->next_user) {
@@ -128,7 +123,7 @@ namespace sigma::ir {
 				}
 
 				const handle<node> successor = use->target->get_fallthrough();
-				auto target = &context.machine_blocks.at(successor);
+				auto target = context.get_machine_block(successor);
 
 				// for all live-ins, we should check if we need to insert a move
 				foreach_set(target->live_in, [&](u64 k) {
@@ -275,59 +270,17 @@ namespace sigma::ir {
 		}
 	}
 
-	u64 linear_scan_allocator::partition(
-		const std::vector<live_interval>& intervals, 
-		ptr_diff lo, 
-		ptr_diff hi, 
-		std::vector<u64>& arr
-	) {
-		const u64 pivot = intervals[arr[(hi - lo) / 2 + lo]].get_start(); // middle
-
-		ptr_diff i = lo - 1;
-		ptr_diff j = hi + 1;
-
-		for(;;) {
-			// move the left index to the right at least once and while the element
-			// at the left index is less than the pivot
-			do {
-				i += 1; 
-			} while (intervals[arr[i]].get_start() > pivot);
-
-			// move the right index to the left at least once and while the element
-			// at the right index is greater than the pivot
-			do {
-				j -= 1; 
-			} while (intervals[arr[j]].get_start() < pivot);
-
-			// if the indices crossed, return
-			if (i >= j) {
-				return j;
-			}
-
-			// swap the elements at the left and right indices
-			std::swap(arr[i], arr[j]);
-		}
+	void linear_scan_allocator::push_unhandled(u64 start, u64 index) {
+		m_unhandled.emplace_back(start, index);
+		std::ranges::push_heap(m_unhandled, std::greater<>());
 	}
 
-	void linear_scan_allocator::quick_sort_definitions(
-		std::vector<live_interval>& intervals,
-		ptr_diff lo, 
-		ptr_diff hi, 
-		std::vector<u64>& arr
-	) {
-		if(lo >= 0 && hi >= 0 && lo < hi) {
-			// get pivot
-			const u64 pivot = partition(intervals, lo, hi, arr);
-
-			// sort both sides
-			quick_sort_definitions(
-				intervals, lo, static_cast<ptr_diff>(pivot), arr
-			);
+	auto linear_scan_allocator::pop_unhandled() -> u64 {
+		std::ranges::pop_heap(m_unhandled, std::greater<>());
+		const u64 index = m_unhandled.back().second;
 
-			quick_sort_definitions(
-				intervals, static_cast<ptr_diff>(pivot) + 1, hi, arr
-			);
-		}
+		m_unhandled.pop_back();
+		return index;
 	}
 
 	bool linear_scan_allocator::update_interval(
@@ -467,11 +420,13 @@ namespace sigma::ir {
 			it.spill = -1;
 		}
 
-		it.reg = classified_reg();
+		// the split keeps the register class, but not the register itself
+		it.reg.id = reg::invalid_id;
 
 		it.assigned = reg();
 		ASSERT(it.assigned != 1, "x");
 
+		it.ranges.clear();
 		it.ranges.reserve(4);
 		it.uses.clear();
 		it.target = nullptr;
@@ -485,46 +440,15 @@ namespace sigma::ir {
 		interval->split_child = static_cast<i32>(new_reg);
 		it.add_range(utility::range<u64>::max());
 
-		context.intervals.push_back(it);
-		interval = &context.intervals[old_reg];
-
-		if(!is_spill) {
-			// since the split is starting at pos and pos is at the top of the
-			// unhandled list we can push this to the top wit no problem
-			// find the position where the new element should be inserted
-			const auto unhandled_it = std::ranges::find_if(
-				m_unhandled.begin(), m_unhandled.end(), [&](const u64 index) {
-					return pos > context.intervals[index].get_start();
-				}
-			);
-
-			// insert the new element at the found position
-			m_unhandled.insert(unhandled_it, new_reg);
-
-			// we know where to insert
-		}
-
-		const u64 use_count = interval->uses.size();
-		// loop through the uses in reverse
-
-		for (u64 i = use_count; i-- > 0;) {
-			const u64 split_count = use_count - (i + 1);
-
-			if (interval->uses[i].position > pos && split_count > 0) {
-				// create a new vector for the split uses
-				std::vector uses(
-					interval->uses.begin() + i + 1, interval->uses.end()
-				);
-
-				// resize the original vector
-				uses.resize(i + 1);
-
-				// update it uses and interval uses
-				it.uses = uses;
-				interval->uses = uses;
-				break;
+		// uses are stored in reverse order, move the ones past pos over to the split
+		const auto first_kept_use = std::ranges::find_if(
+			interval->uses, [&](const use_position& use) {
+				return use.position <= pos;
 			}
-		}
+		);
+
+		it.uses.assign(interval->uses.begin(), first_kept_use);
+		interval->uses.erase(interval->uses.begin(), first_kept_use);
 
 		// split ranges
 		for (u64 i = 1; i < interval->ranges.size();) {
@@ -533,7 +457,6 @@ namespace sigma::ir {
 			if (interval_range.start > pos) {
 				// append the range to it ranges
 				it.add_range(interval_range);
-				interval = &context.intervals[old_reg];
 
 				// remove and shift
 				interval->ranges.erase(interval->ranges.begin() + i);
@@ -550,15 +473,26 @@ namespace sigma::ir {
 
 				// add the new range to it ranges
 				it.add_range(r);
-
-				// update the interval
-				interval = &context.intervals[old_reg];
 				continue;
 			}
 
 			++i;
 		}
 
+		// the ranges we've moved over were in front of the active range, move the active
+		// range back so that it points to a valid range which doesn't end past pos
+		interval->active_range = std::min(interval->active_range, interval->ranges.size() - 1);
+		it.active_range = it.ranges.size() - 1;
+
+		context.intervals.push_back(it);
+		interval = &context.intervals[old_reg];
+
+		if(!is_spill) {
+			// the split starts at pos, push it into the unhandled heap so that it gets
+			// processed once we reach it
+			push_unhandled(pos, new_reg);
+		}
+
 		// insert move (the control flow aware moves are inserted later)
 		insert_split_move(context, pos, old_reg, new_reg);
 
@@ -646,10 +580,10 @@ namespace sigma::ir {
 		}
 
 		if(m_callee_saved[register_class] & (1ull << highest.id)) {
-			m_callee_saved[register_class] &= (1ull << highest.id);
+			m_callee_saved[register_class] &= ~(1ull << highest.id);
 
 			const u8 size = register_class ? 16 : 8;
-			u8 virtual_reg = highest.id;
+			reg::id_type virtual_reg = highest.id;
 
 			if(register_class) {
 				virtual_reg += x64::register_class::FIRST_XMM;
@@ -692,10 +626,129 @@ namespace sigma::ir {
 	reg linear_scan_allocator::allocate_blocked_reg(
 		codegen_context& context, handle<live_interval> interval
 	) {
-		SUPPRESS_C4100(context);
-		SUPPRESS_C4100(interval);
+		const auto register_class = interval->reg.cl;
+		const ptr_diff register_index = interval.get() - context.intervals.data();
+		const u64 start = interval->get_start();
+
+		// position at which the given register is needed next, and the position at which
+		// it gets blocked by a fixed interval
+		std::array<u64, 16> use_positions;
+		std::array<u64, 16> block_positions;
+
+		use_positions.fill(std::numeric_limits<u64>::max());
+		block_positions.fill(std::numeric_limits<u64>::max());
+
+		foreach_set(m_active_set[register_class], [&](u64 i) {
+			const auto it = &context.intervals[m_active[register_class][i]];
+
+			// fixed intervals and intervals defined at the current position can't be split
+			if(it->reg.is_valid() || it->get_start() >= start) {
+				use_positions[i] = 0;
+				block_positions[i] = 0;
+			}
+			else {
+				use_positions[i] = get_next_use(it, start);
+			}
+		});
+
+		for(const ptr_diff i : m_inactive) {
+			const auto it = &context.intervals[i];
+
+			if(it->reg.cl != register_class) {
+				continue;
+			}
+
+			const ptr_diff intersect = interval_intersect(interval, it);
+
+			if(intersect < 0) {
+				continue;
+			}
+
+			const u64 id = it->assigned.id;
+
+			if(it->reg.is_valid()) {
+				block_positions[id] = std::min(block_positions[id], static_cast<u64>(intersect));
+				use_positions[id] = std::min(use_positions[id], block_positions[id]);
+			}
+			else {
+				use_positions[id] = std::min(use_positions[id], get_next_use(it, start));
+			}
+		}
+
+		if(register_class == x64::register_class::GPR) {
+			// reserved registers
+			use_positions[static_cast<u8>(x64::gpr::RBP)] = 0;
+			use_positions[static_cast<u8>(x64::gpr::RSP)] = 0;
+		}
+
+		// pick the register which is needed the furthest in the future
+		reg highest = 0;
+
+		for(u8 i = 1; i < 16; ++i) {
+			if(use_positions[i] > use_positions[highest.id]) {
+				highest = i;
+			}
+		}
+
+		const u64 first_use = get_next_use(interval, start);
+
+		// every register is needed before the current interval needs one, spill the interval
+		// itself and reload it before its first use. the same goes for intervals starting at
+		// the first position, since there's nothing in front of them to split the holders at
+		if(start == 0 || use_positions[highest.id] < first_use) {
+			constexpr u8 size = 8;
+			context.stack_usage = utility::align(context.stack_usage + size, size);
+			interval->spill = static_cast<i32>(context.stack_usage);
+
+			if(first_use != std::numeric_limits<u64>::max() && first_use > start) {
+				split_intersecting(context, start, first_use - 1, interval, false);
+			}
+
+			return reg();
+		}
+
+		// spill intervals which currently occupy the register, they get reloaded before their
+		// next use
+		if(m_active_set[register_class].get(highest.id)) {
+			const ptr_diff active_index = m_active[register_class][highest.id];
+			split_intersecting(context, start, start - 1, &context.intervals[active_index], true);
+		}
+
+		for(u64 i = 0; i < m_inactive.size(); ++i) {
+			const auto it = &context.intervals[m_inactive[i]];
+
+			if(
+				it->reg.cl == register_class &&
+				it->reg.is_valid() == false &&
+				it->assigned == highest &&
+				it->split_child < 0 &&
+				interval_intersect(&context.intervals[register_index], it) >= 0
+			) {
+				split_intersecting(context, start, start - 1, it, true);
+			}
+		}
+
+		interval = &context.intervals[register_index];
+
+		// the register is blocked by a fixed interval before the current interval ends
+		if(interval->get_end() > block_positions[highest.id]) {
+			interval->assigned = highest;
+			split_intersecting(context, start, block_positions[highest.id] - 1, interval, true);
+		}
+
+		return highest;
+	}
+
+	auto linear_scan_allocator::get_next_use(handle<live_interval> interval, u64 time) -> u64 {
+		// uses are stored in reverse order, the first one we find is the closest one
+		for(u64 i = interval->uses.size(); i-- > 0;) {
+			const use_position& use = interval->uses[i];
+
+			if(use.position >= time && use.type == use_position::REG) {
+				return use.position;
+			}
+		}
 
-		NOT_IMPLEMENTED();
-		return reg();
+		return std::numeric_limits<u64>::max();
 	}
 } // namespace sigma::ir
@@ -26,19 +26,8 @@ namespace sigma::ir {
 
 		void mark_callee_saved_constraints(const codegen_context& context);
 
-		static auto partition(
-			const std::vector<live_interval>& intervals, 
-			ptr_diff lo,
-			ptr_diff hi,
-			std::vector<u64>& arr
-		) -> u64;
-
-		static void quick_sort_definitions(
-			std::vector<live_interval>& intervals, 
-			ptr_diff lo,
-			ptr_diff hi,
-			std::vector<u64>& arr
-		);
+		void push_unhandled(u64 start, u64 index);
+		auto pop_unhandled() -> u64;
 
 		auto update_interval(
 			const codegen_context& context, 
@@ -59,6 +48,14 @@ namespace sigma::ir {
 			bool is_spill
 		) -> u64;
 
+		/**
+		 * \brief Retrieves the position of the next use of \b interval, which requires a register.
+		 * \param interval Interval to search
+		 * \param time Position to start searching from (inclusive)
+		 * \return Position of the next use, u64 max if there is none.
+		 */
+		static auto get_next_use(handle<live_interval> interval, u64 time) -> u64;
+
 		auto allocate_free_reg(codegen_context& context, handle<live_interval> interval) -> reg;
 		auto allocate_blocked_reg(codegen_context& context, handle<live_interval> interval) -> reg;
 	private:
@@ -69,7 +66,9 @@ namespace sigma::ir {
 
 		std::vector<ptr_diff> m_free_positions;
 		std::vector<ptr_diff> m_inactive;
-		std::vector<u64> m_unhandled;
+
+		// min-heap of intervals which haven't been processed yet, ordered by their start positions
+		std::vector<std::pair<u64, u64>> m_unhandled;
 
 		handle<instruction> m_cache;
 	};
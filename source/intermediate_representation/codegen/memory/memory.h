@@ -5,7 +5,7 @@ namespace sigma::ir {
 	using namespace utility::types;
 
 	struct reg {
-		using id_type = u8;
+		using id_type = u32;
 
 		reg() = default;
 		reg(id_type id);
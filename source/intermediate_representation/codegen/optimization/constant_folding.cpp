@@ -0,0 +1,84 @@
+#include "constant_folding.h"
+
+namespace sigma::ir {
+	auto mask_to_width(u64 value, u8 bit_width) -> u64 {
+		return bit_width >= 64 ? value : value & ((UINT64_C(1) << bit_width) - 1);
+	}
+
+	auto sign_extend(u64 value, u8 bit_width) -> i64 {
+		if(bit_width == 0 || bit_width >= 64) {
+			return static_cast<i64>(value);
+		}
+
+		const u64 shift = 64 - bit_width;
+		return static_cast<i64>(value << shift) >> shift;
+	}
+
+	auto get_integer_constant(handle<node> n, u64& value) -> bool {
+		if(n == nullptr || n != node::type::INTEGER_CONSTANT) {
+			return false;
+		}
+
+		value = mask_to_width(n->get<integer>().value, n->dt.get_bit_width());
+		return true;
+	}
+
+	auto evaluate_integer_operation(handle<node> n, u64 a, u64 b, u64& result) -> bool {
+		if(n->dt != data_type::base::INTEGER) {
+			return false;
+		}
+
+		switch(n->get_type()) {
+			case node::type::ADD: result = a + b; break;
+			case node::type::SUB: result = a - b; break;
+			case node::type::MUL: result = a * b; break;
+			case node::type::AND: result = a & b; break;
+			case node::type::OR:  result = a | b; break;
+			case node::type::XOR: result = a ^ b; break;
+			case node::type::NEG: result = ~a + 1; break;
+			case node::type::CMP_EQ:
+			case node::type::CMP_NE:
+			case node::type::CMP_ULT:
+			case node::type::CMP_ULE:
+			case node::type::CMP_SLT:
+			case node::type::CMP_SLE: {
+				const data_type cmp_dt = n->get<compare_op>().cmp_dt;
+
+				if(cmp_dt != data_type::base::INTEGER) {
+					return false;
+				}
+
+				const i64 signed_a = sign_extend(a, cmp_dt.get_bit_width());
+				const i64 signed_b = sign_extend(b, cmp_dt.get_bit_width());
+
+				switch(n->get_type()) {
+					case node::type::CMP_EQ:  result = a == b; break;
+					case node::type::CMP_NE:  result = a != b; break;
+					case node::type::CMP_ULT: result = a < b;  break;
+					case node::type::CMP_ULE: result = a <= b; break;
+					case node::type::CMP_SLT: result = signed_a < signed_b;  break;
+					case node::type::CMP_SLE: result = signed_a <= signed_b; break;
+					default: return false;
+				}
+
+				break;
+			}
+			case node::type::TRUNCATE:
+			case node::type::ZERO_EXTEND: {
+				// the source value is already masked to its own width
+				result = a;
+				break;
+			}
+			case node::type::SIGN_EXTEND: {
+				result = static_cast<u64>(sign_extend(a, n->inputs[1]->dt.get_bit_width()));
+				break;
+			}
+			default: {
+				return false;
+			}
+		}
+
+		result = mask_to_width(result, n->dt.get_bit_width());
+		return true;
+	}
+} // namespace sigma::ir
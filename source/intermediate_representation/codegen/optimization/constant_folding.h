@@ -0,0 +1,26 @@
+#pragma once
+#include "intermediate_representation/node_hierarchy/node.h"
+
+namespace sigma::ir {
+	auto mask_to_width(u64 value, u8 bit_width) -> u64;
+	auto sign_extend(u64 value, u8 bit_width) -> i64;
+
+	/**
+	 * \brief Retrieves the value of an integer constant, masked to its bit width.
+	 * \param n Node to check
+	 * \param value Output value
+	 * \return True if \b n is an integer constant, false otherwise.
+	 */
+	auto get_integer_constant(handle<node> n, u64& value) -> bool;
+
+	/**
+	 * \brief Evaluates an integer operation, assuming that its operands (inputs[1] and
+	 * inputs[2]) evaluate to \b a and \b b. Unary operations ignore \b b.
+	 * \param n Operation to evaluate
+	 * \param a Value of the first operand
+	 * \param b Value of the second operand
+	 * \param result Output value, masked to the bit width of \b n
+	 * \return True if the operation could be evaluated, false otherwise.
+	 */
+	auto evaluate_integer_operation(handle<node> n, u64 a, u64 b, u64& result) -> bool;
+} // namespace sigma::ir
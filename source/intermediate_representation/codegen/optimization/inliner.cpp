@@ -0,0 +1,345 @@
+#include "inliner.h"
+
+#include <utility/containers/stack.h>
+
+namespace sigma::ir {
+	namespace detail {
+		template<typename extra_type>
+		auto clone_node_as(handle<function> target, handle<node> source) -> handle<node> {
+			const handle<node> clone = target->create_node<extra_type>(source->get_type(), source->inputs.get_size());
+
+			clone->get<extra_type>() = source->get<extra_type>();
+			clone->dt = source->dt;
+
+			return clone;
+		}
+
+		auto is_entry_projection(handle<function> function, handle<node> n) -> bool {
+			return n == node::type::PROJECTION && n->inputs[0] == function->entry_node;
+		}
+
+		auto lookup(const std::unordered_map<handle<node>, handle<node>>& map, handle<node> n) -> handle<node> {
+			const auto it = map.find(n);
+			return it != map.end() ? it->second : nullptr;
+		}
+
+		auto is_continuation(handle<function> function, handle<node> n) -> bool {
+			return is_entry_projection(function, n) && n->get<projection>().index == 2;
+		}
+	} // namespace detail
+
+	void inliner::apply(const std::vector<handle<function>>& functions) {
+		for(const handle<function> caller : functions) {
+			inline_calls(caller);
+		}
+
+		m_sizes.clear();
+	}
+
+	void inliner::inline_calls(handle<function> caller) {
+		for(u64 depth = 0; depth < max_depth; ++depth) {
+			std::unordered_map<handle<node>, handle<node>> replacements;
+			u64 caller_size = get_size(caller);
+
+			for(const call_site& site : collect_call_sites(caller)) {
+				if(!should_inline(caller, site, caller_size)) {
+					continue;
+				}
+
+				inline_call(caller, site, replacements);
+				caller_size += get_size(site.callee);
+			}
+
+			if(replacements.empty()) {
+				break;
+			}
+
+			apply_replacements(caller, replacements);
+			m_sizes.erase(caller);
+		}
+	}
+
+	void inliner::inline_call(handle<function> caller, const call_site& site, std::unordered_map<handle<node>, handle<node>>& replacements) {
+		const handle<function> callee = site.callee;
+		const handle<node> call = site.call;
+
+		std::unordered_map<handle<node>, handle<node>> clones;
+		const std::vector<handle<node>> nodes = collect_nodes(callee);
+
+		// map the entry of the callee onto the call site, and clone everything else
+		for(const handle<node> n : nodes) {
+			if(n == callee->exit_node) {
+				continue;
+			}
+
+			if(n == callee->entry_node) {
+				// locals are allocated in the stack frame of the caller
+				clones[n] = caller->entry_node;
+			}
+			else if(detail::is_entry_projection(callee, n)) {
+				const u64 index = n->get<projection>().index;
+
+				switch(index) {
+					case 0:  clones[n] = call->inputs[0]; break; // control
+					case 1:  clones[n] = call->inputs[1]; break; // memory
+					case 2:  break;                              // continuation, only used by the exit
+					default: clones[n] = call->inputs[index]; break; // parameters
+				}
+			}
+			else {
+				clones[n] = clone_node(caller, n);
+			}
+		}
+
+		// wire up the cloned nodes
+		for(const handle<node> n : nodes) {
+			if(n == callee->exit_node || n == callee->entry_node || detail::is_entry_projection(callee, n)) {
+				continue;
+			}
+
+			const handle<node> clone = clones.at(n);
+
+			for(u64 i = 0; i < n->inputs.get_size(); ++i) {
+				clone->inputs[i] = n->inputs[i] ? clones.at(n->inputs[i]) : nullptr;
+			}
+
+			// properties which refer to other nodes
+			switch(clone->get_type()) {
+				case node::type::REGION: {
+					auto& property = clone->get<region>();
+					property.memory_in = detail::lookup(clones, property.memory_in);
+					property.memory_out = detail::lookup(clones, property.memory_out);
+					break;
+				}
+				case node::type::CALL:
+				case node::type::SYSTEM_CALL: {
+					for(handle<node>& projection : clone->get<function_call>().projections) {
+						projection = detail::lookup(clones, projection);
+					}
+
+					break;
+				}
+				case node::type::BRANCH: {
+					for(handle<node>& successor : clone->get<branch>().successors) {
+						successor = detail::lookup(clones, successor);
+					}
+
+					break;
+				}
+				default: {
+					break;
+				}
+			}
+		}
+
+		// branches of the callee end blocks in the caller now, the exit is replaced by the
+		// control flow following the call
+		for(const handle<node> terminator : callee->terminators) {
+			if(terminator == node::type::BRANCH) {
+				caller->terminators.push_back(clones.at(terminator));
+			}
+		}
+
+		// map the projections of the call onto the exit of the callee
+		const handle<node> exit = callee->exit_node;
+		const auto& projections = call->get<function_call>().projections;
+
+		replacements[projections[0]] = clones.at(exit->inputs[0]); // exit region
+		replacements[projections[1]] = clones.at(exit->inputs[1]); // memory phi
+
+		for(u64 i = 3; i < exit->inputs.get_size(); ++i) {
+			if(const handle<node> value = projections[i - 1]) {
+				replacements[value] = clones.at(exit->inputs[i]);
+			}
+		}
+	}
+
+	auto inliner::collect_call_sites(handle<function> caller) const -> std::vector<call_site> {
+		std::vector<call_site> sites;
+
+		for(const handle<node> n : collect_nodes(caller)) {
+			if(n != node::type::CALL || n->inputs[2] != node::type::SYMBOL) {
+				continue;
+			}
+
+			const handle<symbol> target = n->inputs[2]->get<handle<symbol>>();
+
+			if(target->type != symbol::FUNCTION) {
+				continue;
+			}
+
+			sites.push_back({ n, reinterpret_cast<function*>(target.get()) });
+		}
+
+		return sites;
+	}
+
+	auto inliner::should_inline(handle<function> caller, const call_site& site, u64 caller_size) -> bool {
+		const handle<function> callee = site.callee;
+
+		// recursion, functions without a body and variadic functions can't be inlined
+		if(
+			callee == caller ||
+			callee->exit_node == nullptr ||
+			callee->signature.has_var_args ||
+			callee->return_count > 1
+		) {
+			return false;
+		}
+
+		const u64 size = get_size(callee);
+
+		if(caller_size + size > max_caller_size || uses_continuation(callee)) {
+			return false;
+		}
+
+		// constant arguments make inlining more profitable
+		u64 bonus = 0;
+
+		for(u64 i = 3; i < site.call->inputs.get_size(); ++i) {
+			if(site.call->inputs[i] == node::type::INTEGER_CONSTANT) {
+				bonus += constant_argument_bonus;
+			}
+		}
+
+		return size <= size_threshold + bonus;
+	}
+
+	auto inliner::get_size(handle<function> function) -> u64 {
+		const auto it = m_sizes.find(function);
+
+		if(it != m_sizes.end()) {
+			return it->second;
+		}
+
+		const u64 size = collect_nodes(function).size();
+		m_sizes[function] = size;
+		return size;
+	}
+
+	auto inliner::uses_continuation(handle<function> function) -> bool {
+		// the continuation of the callee has no counterpart at the call site, we can only map
+		// it away when the exit is its only user
+		for(const handle<node> n : collect_nodes(function)) {
+			if(n == function->exit_node) {
+				continue;
+			}
+
+			for(const handle<node>& input : n->inputs) {
+				if(input && detail::is_continuation(function, input)) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	auto inliner::collect_nodes(handle<function> function) -> std::vector<handle<node>> {
+		std::unordered_set<handle<node>> visited;
+		std::vector<handle<node>> nodes;
+		utility::stack<handle<node>> stack;
+
+		for(const handle<node> end : function->terminators) {
+			if(!visited.insert(end).second) {
+				continue;
+			}
+
+			stack.push_back(end);
+
+			while(!stack.is_empty()) {
+				const handle<node> n = stack.pop_back();
+				nodes.push_back(n);
+
+				for(const handle<node>& input : n->inputs) {
+					if(input && visited.insert(input).second) {
+						stack.push_back(input);
+					}
+				}
+			}
+		}
+
+		return nodes;
+	}
+
+	auto inliner::clone_node(handle<function> target, handle<node> source) -> handle<node> {
+		switch(source->get_type()) {
+			case node::type::INTEGER_CONSTANT: return detail::clone_node_as<integer>(target, source);
+			case node::type::F32_CONSTANT:     return detail::clone_node_as<floating_point_32>(target, source);
+			case node::type::F64_CONSTANT:     return detail::clone_node_as<floating_point_64>(target, source);
+			case node::type::PROJECTION:       return detail::clone_node_as<projection>(target, source);
+			case node::type::REGION:           return detail::clone_node_as<region>(target, source);
+			case node::type::BRANCH:           return detail::clone_node_as<branch>(target, source);
+			case node::type::LOCAL:            return detail::clone_node_as<local>(target, source);
+			case node::type::SYMBOL:           return detail::clone_node_as<handle<symbol>>(target, source);
+			case node::type::ARRAY_ACCESS:     return detail::clone_node_as<array>(target, source);
+			case node::type::MEMBER_ACCESS:    return detail::clone_node_as<member>(target, source);
+			case node::type::CALL:
+			case node::type::SYSTEM_CALL:
+				return detail::clone_node_as<function_call>(target, source);
+			case node::type::LOAD:
+			case node::type::STORE:
+			case node::type::READ:
+			case node::type::WRITE:
+				return detail::clone_node_as<memory_access>(target, source);
+			case node::type::ADD:
+			case node::type::SUB:
+			case node::type::MUL:
+			case node::type::AND:
+			case node::type::OR:
+				return detail::clone_node_as<binary_integer_op>(target, source);
+			case node::type::CMP_EQ:
+			case node::type::CMP_NE:
+			case node::type::CMP_ULT:
+			case node::type::CMP_ULE:
+			case node::type::CMP_SLT:
+			case node::type::CMP_SLE:
+			case node::type::CMP_FLT:
+			case node::type::CMP_FLE:
+				return detail::clone_node_as<compare_op>(target, source);
+			default:
+				return detail::clone_node_as<utility::empty_property>(target, source);
+		}
+	}
+
+	void inliner::apply_replacements(handle<function> caller, const std::unordered_map<handle<node>, handle<node>>& replacements) {
+		// replacements may chain (ie. a cloned argument refers to the result of another inlined
+		// call), resolve them all the way through
+		const auto resolve = [&](handle<node> n) {
+			for(auto it = replacements.find(n); it != replacements.end(); it = replacements.find(n)) {
+				n = it->second;
+			}
+
+			return n;
+		};
+
+		std::unordered_set<handle<node>> visited;
+		utility::stack<handle<node>> stack;
+
+		for(handle<node>& end : caller->terminators) {
+			end = resolve(end);
+
+			if(visited.insert(end).second) {
+				stack.push_back(end);
+			}
+		}
+
+		// walk the graph as it's being rewritten, cloned nodes are only reachable through the
+		// replaced inputs
+		while(!stack.is_empty()) {
+			const handle<node> n = stack.pop_back();
+
+			for(handle<node>& input : n->inputs) {
+				if(input == nullptr) {
+					continue;
+				}
+
+				input = resolve(input);
+
+				if(visited.insert(input).second) {
+					stack.push_back(input);
+				}
+			}
+		}
+	}
+} // namespace sigma::ir
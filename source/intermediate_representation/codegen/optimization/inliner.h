@@ -0,0 +1,52 @@
+#pragma once
+#include "intermediate_representation/node_hierarchy/function.h"
+
+namespace sigma::ir {
+	/**
+	 * \brief Module level pass which replaces calls to small functions with a copy of the
+	 * callee's node graph. The callee's entry projections are mapped onto the arguments and
+	 * the control/memory state of the call site, the projections of the call itself are
+	 * mapped onto the callee's exit region and its PHIs. \n\n
+	 * Since the inliner reads the graphs of other functions it has to run before any of
+	 * the functions are compiled (and before use lists are generated).
+	 */
+	class inliner {
+	public:
+		/**
+		 * \brief Inlines eligible call sites in all \b functions. Functions are processed in
+		 * order, which keeps the result deterministic.
+		 * \param functions Functions to inline calls into
+		 */
+		void apply(const std::vector<handle<function>>& functions);
+	private:
+		struct call_site {
+			handle<node> call;
+			handle<function> callee;
+		};
+
+		void inline_calls(handle<function> caller);
+		void inline_call(handle<function> caller, const call_site& site, std::unordered_map<handle<node>, handle<node>>& replacements);
+
+		auto collect_call_sites(handle<function> caller) const -> std::vector<call_site>;
+		auto should_inline(handle<function> caller, const call_site& site, u64 caller_size) -> bool;
+		auto get_size(handle<function> function) -> u64;
+
+		static auto uses_continuation(handle<function> function) -> bool;
+		static auto collect_nodes(handle<function> function) -> std::vector<handle<node>>;
+		static auto clone_node(handle<function> target, handle<node> source) -> handle<node>;
+		static void apply_replacements(handle<function> caller, const std::unordered_map<handle<node>, handle<node>>& replacements);
+	private:
+		// calls exposed by inlining get inlined as well, up to this depth
+		static constexpr u64 max_depth = 4;
+
+		// maximum node count of a callee which is considered for inlining
+		static constexpr u64 size_threshold = 64;
+		// every constant argument is likely to fold away a part of the callee
+		static constexpr u64 constant_argument_bonus = 8;
+		// don't let callers grow past this node count
+		static constexpr u64 max_caller_size = 4096;
+
+		// cached node counts of individual functions
+		std::unordered_map<handle<function>, u64> m_sizes;
+	};
+} // namespace sigma::ir
@@ -0,0 +1,237 @@
+#include "mem2reg.h"
+
+namespace sigma::ir {
+	void mem2reg::apply(transformation_context& context) {
+		m_function = context.function;
+
+		std::erase_if(context.locals, [&](handle<node> local) {
+			if(!is_promotable(local)) {
+				return false;
+			}
+
+			promote(local);
+			return true;
+		});
+	}
+
+	auto mem2reg::is_promotable(handle<node> local) -> bool {
+		if(local->use == nullptr) {
+			return false;
+		}
+
+		data_type access_type;
+		bool has_access_type = false;
+
+		for(handle<user> u = local->use; u; u = u->next_user) {
+			const handle<node> target = u->target;
+
+			// the local has to be used as an address, anything else (member/array accesses, call
+			// arguments, being stored somewhere) means that the address escapes
+			if(u->slot != 2) {
+				return false;
+			}
+
+			data_type type;
+
+			if(target == node::type::LOAD) {
+				type = target->dt;
+			}
+			else if(target == node::type::STORE) {
+				type = target->inputs[3]->dt;
+			}
+			else {
+				return false;
+			}
+
+			if(type != data_type::base::INTEGER && type != data_type::base::POINTER) {
+				return false;
+			}
+
+			// all accesses have to agree on the type of the local
+			if(has_access_type && type != access_type) {
+				return false;
+			}
+
+			access_type = type;
+			has_access_type = true;
+		}
+
+		return true;
+	}
+
+	void mem2reg::promote(handle<node> local) {
+		m_local = local;
+		m_undefined = nullptr;
+		m_values.clear();
+		m_open_phis.clear();
+		m_referenced_phis.clear();
+
+		std::vector<handle<node>> loads;
+		std::vector<handle<node>> stores;
+
+		for(handle<user> u = local->use; u; u = u->next_user) {
+			if(u->target == node::type::LOAD) {
+				loads.push_back(u->target);
+			}
+			else {
+				stores.push_back(u->target);
+			}
+		}
+
+		m_data_type = loads.empty() ? stores.front()->inputs[3]->dt : loads.front()->dt;
+
+		// resolve the values of all loads before the memory chain is modified
+		std::unordered_map<handle<node>, handle<node>> replacements;
+
+		for(const handle<node> load : loads) {
+			replacements[load] = get_value(load->inputs[1]);
+		}
+
+		for(const handle<node> load : loads) {
+			handle<node> value = replacements[load];
+
+			// the stored value may itself be a load of this local (ie. 'x = x')
+			while(value == node::type::LOAD && value->inputs[2] == local) {
+				value = replacements[value];
+			}
+
+			m_function->replace_uses(load, value);
+			m_function->detach_inputs(load);
+		}
+
+		// remove the stores from the memory chain
+		for(const handle<node> store : stores) {
+			m_function->replace_uses(store, store->inputs[1]);
+			m_function->detach_inputs(store);
+		}
+
+		m_function->detach_inputs(local);
+	}
+
+	auto mem2reg::get_value(handle<node> memory) -> handle<node> {
+		// memory states we've walked through, all of them see the same value
+		std::vector<handle<node>> visited;
+		handle<node> value = nullptr;
+
+		while(value == nullptr) {
+			const auto it = m_values.find(memory);
+
+			if(it != m_values.end()) {
+				value = it->second;
+
+				if(m_open_phis.contains(value)) {
+					m_referenced_phis.insert(value);
+				}
+
+				break;
+			}
+
+			switch(memory->get_type()) {
+				case node::type::STORE: {
+					if(memory->inputs[2] == m_local) {
+						value = memory->inputs[3];
+						break;
+					}
+
+					[[fallthrough]];
+				}
+				case node::type::WRITE:
+				case node::type::MEMCPY:
+				case node::type::MEMSET: {
+					visited.push_back(memory);
+					memory = memory->inputs[1];
+					break;
+				}
+				case node::type::PROJECTION: {
+					const handle<node> source = memory->inputs[0];
+
+					if(source == node::type::ENTRY) {
+						// read before the first store
+						value = get_undefined_value();
+						break;
+					}
+
+					// calls and volatile reads, the local can't be modified by them since its
+					// address doesn't escape
+					visited.push_back(memory);
+					memory = source->inputs[1];
+					break;
+				}
+				case node::type::PHI: {
+					value = get_phi_value(memory);
+					break;
+				}
+				default: {
+					PANIC("unhandled memory node");
+				}
+			}
+		}
+
+		m_values[memory] = value;
+
+		for(const handle<node> state : visited) {
+			m_values[state] = value;
+		}
+
+		return value;
+	}
+
+	auto mem2reg::get_phi_value(handle<node> memory_phi) -> handle<node> {
+		const u64 input_count = memory_phi->inputs.get_size();
+
+		// create the phi before resolving its inputs, so that cyclic memory chains terminate
+		const handle<node> phi = m_function->create_node<utility::empty_property>(node::type::PHI, input_count);
+		phi->dt = m_data_type;
+		phi->inputs[0] = memory_phi->inputs[0];
+
+		m_values[memory_phi] = phi;
+		m_open_phis.insert(phi);
+
+		handle<node> same = nullptr;
+		bool is_trivial = true;
+
+		for(u64 i = 1; i < input_count; ++i) {
+			const handle<node> value = get_value(memory_phi->inputs[i]);
+			phi->inputs[i] = value;
+
+			if(value == phi || value == same) {
+				continue;
+			}
+
+			if(same) {
+				is_trivial = false;
+			}
+
+			same = value;
+		}
+
+		m_open_phis.erase(phi);
+
+		// all predecessors see the same value, we don't need a phi (unless something already
+		// references it)
+		if(is_trivial && !m_referenced_phis.contains(phi)) {
+			const handle<node> value = same ? same : get_undefined_value();
+			m_values[memory_phi] = value;
+			return value;
+		}
+
+		for(u64 i = 0; i < input_count; ++i) {
+			phi->add_user(phi->inputs[i], i, nullptr, &m_function->allocator);
+		}
+
+		return phi;
+	}
+
+	auto mem2reg::get_undefined_value() -> handle<node> {
+		if(m_undefined) {
+			return m_undefined;
+		}
+
+		// reads of uninitialized locals are undefined, zero is as good of a value as any
+		m_undefined = m_function->create_node<integer>(node::type::INTEGER_CONSTANT, 1);
+		m_undefined->dt = m_data_type;
+		m_undefined->get<integer>().bit_width = m_data_type.get_bit_width();
+
+		return m_undefined;
+	}
+} // namespace sigma::ir
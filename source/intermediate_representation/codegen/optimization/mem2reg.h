@@ -0,0 +1,37 @@
+#pragma once
+#include "intermediate_representation/codegen/optimization/optimization_pass_list.h"
+
+namespace sigma::ir {
+	/**
+	 * \brief Promotes locals whose address never escapes (they're only accessed through
+	 * plain loads and stores) to SSA values. Loads are replaced with the last value stored
+	 * along the memory chain, PHI nodes are inserted at regions which merge different
+	 * values, and the stores themselves are removed from the memory chain.
+	 */
+	class mem2reg : public optimization_pass {
+	public:
+		void apply(transformation_context& context) override;
+	private:
+		static auto is_promotable(handle<node> local) -> bool;
+
+		void promote(handle<node> local);
+		auto get_value(handle<node> memory) -> handle<node>;
+		auto get_phi_value(handle<node> memory_phi) -> handle<node>;
+		auto get_undefined_value() -> handle<node>;
+	private:
+		handle<function> m_function;
+
+		// state of the local which is currently being promoted
+		handle<node> m_local;
+		handle<node> m_undefined;
+		data_type m_data_type;
+
+		// memory state -> value of the local at that point
+		std::unordered_map<handle<node>, handle<node>> m_values;
+
+		// phis whose inputs are still being resolved, and the ones among them which were
+		// referenced during that time (cycles), these can't be removed even if they're trivial
+		std::unordered_set<handle<node>> m_open_phis;
+		std::unordered_set<handle<node>> m_referenced_phis;
+	};
+} // namespace sigma::ir
@@ -0,0 +1,472 @@
+#include "peephole.h"
+#include "intermediate_representation/codegen/optimization/constant_folding.h"
+
+namespace sigma::ir {
+	namespace detail {
+		auto is_constant(handle<node> n, u64 value) -> bool {
+			u64 constant;
+			return get_integer_constant(n, constant) && constant == mask_to_width(value, n->dt.get_bit_width());
+		}
+
+		auto is_commutative(node::type type) -> bool {
+			switch(type) {
+				case node::type::ADD:
+				case node::type::MUL:
+				case node::type::AND:
+				case node::type::OR:
+				case node::type::XOR:
+				case node::type::CMP_EQ:
+				case node::type::CMP_NE:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		auto hash_combine(u64 seed, u64 value) -> u64 {
+			return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+		}
+
+		auto hash_data_type(data_type dt) -> u64 {
+			return static_cast<u64>(dt.get_base().get_underlying()) << 8 | dt.get_bit_width();
+		}
+	} // namespace detail
+
+	void peephole::apply(transformation_context& context) {
+		m_function = context.function;
+		m_work = &context.work;
+
+		// start off with every reachable node, the work list doubles as our queue
+		context.work.push_all(m_function);
+
+		while(!context.work.items.empty()) {
+			const handle<node> n = context.work.items.back();
+
+			context.work.items.pop_back();
+			context.work.forget(n);
+
+			process(n);
+		}
+
+		m_values.clear();
+		context.work.clear();
+	}
+
+	void peephole::process(handle<node> n) {
+		if(is_dead(n)) {
+			kill(n);
+			return;
+		}
+
+		if(!is_value_node(n)) {
+			return;
+		}
+
+		// the node may change below, take it out of the value table so that it doesn't end up
+		// stored under a stale hash
+		forget(n);
+
+		while(true) {
+			const handle<node> ideal = idealize(n);
+
+			if(ideal == nullptr) {
+				break;
+			}
+
+			if(ideal != n) {
+				subsume(n, ideal);
+				return;
+			}
+		}
+
+		if(const handle<node> folded = fold_constant(n)) {
+			subsume(n, folded);
+			return;
+		}
+
+		if(const handle<node> same = identity(n)) {
+			subsume(n, same);
+			return;
+		}
+
+		const handle<node> existing = value_number(n);
+
+		if(existing != n) {
+			subsume(n, existing);
+		}
+	}
+
+	auto peephole::idealize(handle<node> n) -> handle<node> {
+		const node::type type = n->get_type();
+
+		if(type == node::type::PHI || n->inputs.get_size() != 3) {
+			return nullptr;
+		}
+
+		const handle<node> left = n->inputs[1];
+		const handle<node> right = n->inputs[2];
+
+		u64 left_constant;
+		u64 right_constant;
+
+		const bool is_left_constant = get_integer_constant(left, left_constant);
+		const bool is_right_constant = get_integer_constant(right, right_constant);
+
+		// canonicalize constants to the right hand side, this simplifies all of the rules
+		// below, and lets instruction selection use an immediate operand
+		if(detail::is_commutative(type) && is_left_constant && !is_right_constant) {
+			m_function->set_input(n, 1, right);
+			m_function->set_input(n, 2, left);
+			return n;
+		}
+
+		if(type >= node::type::CMP_EQ && type <= node::type::CMP_FLE) {
+			// comparisons of identical integers
+			if(left != right || n->get<compare_op>().cmp_dt != data_type::base::INTEGER) {
+				return nullptr;
+			}
+
+			switch(type) {
+				case node::type::CMP_EQ:
+				case node::type::CMP_ULE:
+				case node::type::CMP_SLE:
+					return create_constant(BOOL_TYPE, 1);
+				case node::type::CMP_NE:
+				case node::type::CMP_ULT:
+				case node::type::CMP_SLT:
+					return create_constant(BOOL_TYPE, 0);
+				default:
+					return nullptr;
+			}
+		}
+
+		if(n->dt != data_type::base::INTEGER) {
+			return nullptr;
+		}
+
+		const u8 bit_width = n->dt.get_bit_width();
+
+		switch(type) {
+			case node::type::SUB: {
+				// x - x => 0
+				if(left == right) {
+					return create_constant(n->dt, 0);
+				}
+
+				// x - c => x + (-c), lets us reassociate additions
+				if(is_right_constant && !is_left_constant && right_constant != 0) {
+					return create_binary(node::type::ADD, left, create_constant(n->dt, ~right_constant + 1));
+				}
+
+				break;
+			}
+			case node::type::ADD: {
+				// (x + c1) + c2 => x + (c1 + c2)
+				u64 inner_constant;
+
+				if(
+					is_right_constant &&
+					left == node::type::ADD &&
+					get_integer_constant(left->inputs[2], inner_constant)
+				) {
+					return create_binary(node::type::ADD, left->inputs[1], create_constant(n->dt, inner_constant + right_constant));
+				}
+
+				break;
+			}
+			case node::type::XOR: {
+				// x ^ x => 0
+				if(left == right) {
+					return create_constant(n->dt, 0);
+				}
+
+				break;
+			}
+			case node::type::MUL:
+			case node::type::AND: {
+				// x * 0 => 0, x & 0 => 0
+				if(is_right_constant && right_constant == 0) {
+					return right;
+				}
+
+				break;
+			}
+			case node::type::OR: {
+				// x | ~0 => ~0
+				if(is_right_constant && right_constant == mask_to_width(~UINT64_C(0), bit_width)) {
+					return right;
+				}
+
+				break;
+			}
+			default: {
+				break;
+			}
+		}
+
+		return nullptr;
+	}
+
+	auto peephole::fold_constant(handle<node> n) -> handle<node> {
+		if(n->inputs.get_size() < 2) {
+			return nullptr;
+		}
+
+		u64 a;
+		u64 b = 0;
+		u64 result;
+
+		if(
+			!get_integer_constant(n->inputs[1], a) ||
+			(n->inputs.get_size() > 2 && !get_integer_constant(n->inputs[2], b)) ||
+			!evaluate_integer_operation(n, a, b, result)
+		) {
+			return nullptr;
+		}
+
+		return create_constant(n->dt, result);
+	}
+
+	auto peephole::identity(handle<node> n) -> handle<node> {
+		switch(n->get_type()) {
+			case node::type::ADD:
+			case node::type::SUB:
+			case node::type::OR:
+			case node::type::XOR: {
+				// x + 0, x - 0, x | 0, x ^ 0 => x
+				if(detail::is_constant(n->inputs[2], 0)) {
+					return n->inputs[1];
+				}
+
+				// x | x => x
+				if(n->get_type() == node::type::OR && n->inputs[1] == n->inputs[2]) {
+					return n->inputs[1];
+				}
+
+				return nullptr;
+			}
+			case node::type::MUL: {
+				// x * 1 => x
+				return detail::is_constant(n->inputs[2], 1) ? n->inputs[1] : nullptr;
+			}
+			case node::type::AND: {
+				// x & ~0 => x, x & x => x
+				if(
+					detail::is_constant(n->inputs[2], ~UINT64_C(0)) ||
+					n->inputs[1] == n->inputs[2]
+				) {
+					return n->inputs[1];
+				}
+
+				return nullptr;
+			}
+			case node::type::TRUNCATE:
+			case node::type::ZERO_EXTEND:
+			case node::type::SIGN_EXTEND: {
+				// casts to the same type
+				return n->inputs[1]->dt == n->dt ? n->inputs[1] : nullptr;
+			}
+			case node::type::MEMBER_ACCESS: {
+				return n->get<member>().offset == 0 ? n->inputs[1] : nullptr;
+			}
+			case node::type::ARRAY_ACCESS: {
+				return detail::is_constant(n->inputs[2], 0) ? n->inputs[1] : nullptr;
+			}
+			case node::type::PHI: {
+				// phis which only ever see a single value (ignoring themselves)
+				handle<node> same = nullptr;
+
+				for(u64 i = 1; i < n->inputs.get_size(); ++i) {
+					const handle<node> input = n->inputs[i];
+
+					if(input == n || input == same) {
+						continue;
+					}
+
+					if(same != nullptr) {
+						return nullptr;
+					}
+
+					same = input;
+				}
+
+				return same;
+			}
+			default: {
+				return nullptr;
+			}
+		}
+	}
+
+	auto peephole::value_number(handle<node> n) -> handle<node> {
+		return *m_values.insert(n).first;
+	}
+
+	void peephole::subsume(handle<node> target, handle<node> replacement) {
+		ASSERT(target != replacement, "cannot subsume a node with itself");
+
+		// the inputs of all users are about to change, remove them from the value table and
+		// revisit them later
+		for(handle<user> u = target->use; u; u = u->next_user) {
+			forget(u->target);
+			push(u->target);
+		}
+
+		m_function->replace_uses(target, replacement);
+		push(replacement);
+		kill(target);
+	}
+
+	void peephole::kill(handle<node> n) {
+		forget(n);
+
+		// inputs may have become dead
+		for(u64 i = 0; i < n->inputs.get_size(); ++i) {
+			if(const handle<node> input = n->inputs[i]) {
+				push(input);
+			}
+		}
+
+		m_function->detach_inputs(n);
+	}
+
+	void peephole::push(handle<node> n) const {
+		if(m_work->visit(n)) {
+			m_work->items.push_back(n);
+		}
+	}
+
+	void peephole::forget(handle<node> n) {
+		if(!is_value_node(n)) {
+			return;
+		}
+
+		const auto it = m_values.find(n);
+
+		if(it != m_values.end() && *it == n) {
+			m_values.erase(it);
+		}
+	}
+
+	auto peephole::create_binary(node::type type, handle<node> left, handle<node> right) -> handle<node> {
+		const handle<node> n = m_function->create_node<binary_integer_op>(type, 3);
+		n->dt = left->dt;
+
+		m_function->set_input(n, 1, left);
+		m_function->set_input(n, 2, right);
+
+		push(right);
+		return n;
+	}
+
+	auto peephole::create_constant(data_type dt, u64 value) -> handle<node> {
+		const handle<node> n = m_function->create_node<integer>(node::type::INTEGER_CONSTANT, 1);
+		n->dt = dt;
+
+		auto& property = n->get<integer>();
+		property.bit_width = dt.get_bit_width();
+		property.value = mask_to_width(value, dt.get_bit_width());
+
+		return n;
+	}
+
+	auto peephole::is_value_node(handle<node> n) -> bool {
+		switch(n->get_type()) {
+			case node::type::INTEGER_CONSTANT:
+			case node::type::SYMBOL:
+			case node::type::MEMBER_ACCESS:
+			case node::type::ARRAY_ACCESS:
+			case node::type::ADD:
+			case node::type::SUB:
+			case node::type::MUL:
+			case node::type::AND:
+			case node::type::OR:
+			case node::type::XOR:
+			case node::type::NOT:
+			case node::type::NEG:
+			case node::type::CMP_EQ:
+			case node::type::CMP_NE:
+			case node::type::CMP_ULT:
+			case node::type::CMP_ULE:
+			case node::type::CMP_SLT:
+			case node::type::CMP_SLE:
+			case node::type::CMP_FLT:
+			case node::type::CMP_FLE:
+			case node::type::TRUNCATE:
+			case node::type::SIGN_EXTEND:
+			case node::type::ZERO_EXTEND:
+				return true;
+			case node::type::PHI:
+				return n->dt != data_type::base::MEMORY;
+			default:
+				return false;
+		}
+	}
+
+	auto peephole::is_dead(handle<node> n) -> bool {
+		return n->use == nullptr && (is_value_node(n) || n == node::type::LOAD);
+	}
+
+	auto peephole::node_hash::operator()(handle<node> n) const -> u64 {
+		u64 hash = detail::hash_combine(n->get_type(), detail::hash_data_type(n->dt));
+
+		for(const handle<node>& input : n->inputs) {
+			hash = detail::hash_combine(hash, reinterpret_cast<u64>(input.get()));
+		}
+
+		switch(n->get_type()) {
+			case node::type::INTEGER_CONSTANT:
+				return detail::hash_combine(hash, n->get<integer>().value);
+			case node::type::SYMBOL:
+				return detail::hash_combine(hash, reinterpret_cast<u64>(n->get<handle<symbol>>().get()));
+			case node::type::MEMBER_ACCESS:
+				return detail::hash_combine(hash, n->get<member>().offset);
+			case node::type::ARRAY_ACCESS:
+				return detail::hash_combine(hash, n->get<array>().stride);
+			default:
+				return hash;
+		}
+	}
+
+	auto peephole::node_equal::operator()(handle<node> a, handle<node> b) const -> bool {
+		if(
+			a->get_type() != b->get_type() ||
+			a->dt != b->dt ||
+			a->inputs.get_size() != b->inputs.get_size()
+		) {
+			return false;
+		}
+
+		for(u64 i = 0; i < a->inputs.get_size(); ++i) {
+			if(a->inputs[i] != b->inputs[i]) {
+				return false;
+			}
+		}
+
+		switch(a->get_type()) {
+			case node::type::INTEGER_CONSTANT:
+				return a->get<integer>().value == b->get<integer>().value;
+			case node::type::SYMBOL:
+				return a->get<handle<symbol>>() == b->get<handle<symbol>>();
+			case node::type::MEMBER_ACCESS:
+				return a->get<member>().offset == b->get<member>().offset;
+			case node::type::ARRAY_ACCESS:
+				return a->get<array>().stride == b->get<array>().stride;
+			case node::type::ADD:
+			case node::type::SUB:
+			case node::type::MUL:
+				return a->get<binary_integer_op>().behaviour == b->get<binary_integer_op>().behaviour;
+			case node::type::CMP_EQ:
+			case node::type::CMP_NE:
+			case node::type::CMP_ULT:
+			case node::type::CMP_ULE:
+			case node::type::CMP_SLT:
+			case node::type::CMP_SLE:
+			case node::type::CMP_FLT:
+			case node::type::CMP_FLE:
+				return a->get<compare_op>().cmp_dt == b->get<compare_op>().cmp_dt;
+			default:
+				return true;
+		}
+	}
+} // namespace sigma::ir
@@ -0,0 +1,55 @@
+#pragma once
+#include "intermediate_representation/codegen/optimization/optimization_pass_list.h"
+
+namespace sigma::ir {
+	/**
+	 * \brief Worklist driven peephole optimizer. Every node is run through a set of
+	 * idealization, constant folding and identity rules, after which it's hash-consed
+	 * (global value numbering) against all other nodes with the same type, inputs and
+	 * extra property. Any node whose users change is revisited, which means the pass
+	 * runs until a fixpoint is reached.
+	 */
+	class peephole : public optimization_pass {
+	public:
+		void apply(transformation_context& context) override;
+	private:
+		void process(handle<node> n);
+
+		/**
+		 * \brief Attempts to rewrite \b n into a simpler form.
+		 * \param n Node to idealize
+		 * \return nullptr if nothing changed, \b n if it was modified in place, or a different
+		 * node which should replace \b n.
+		 */
+		auto idealize(handle<node> n) -> handle<node>;
+		auto fold_constant(handle<node> n) -> handle<node>;
+		static auto identity(handle<node> n) -> handle<node>;
+		auto value_number(handle<node> n) -> handle<node>;
+
+		// graph manipulation
+		void subsume(handle<node> target, handle<node> replacement);
+		void kill(handle<node> n);
+		void push(handle<node> n) const;
+		void forget(handle<node> n);
+
+		auto create_binary(node::type type, handle<node> left, handle<node> right) -> handle<node>;
+		auto create_constant(data_type dt, u64 value) -> handle<node>;
+
+		static auto is_value_node(handle<node> n) -> bool;
+		static auto is_dead(handle<node> n) -> bool;
+	private:
+		struct node_hash {
+			auto operator()(handle<node> n) const -> u64;
+		};
+
+		struct node_equal {
+			auto operator()(handle<node> a, handle<node> b) const -> bool;
+		};
+
+		handle<function> m_function;
+		handle<work_list> m_work;
+
+		// value table, contains at most one node of every equivalence class
+		std::unordered_set<handle<node>, node_hash, node_equal> m_values;
+	};
+} // namespace sigma::ir
@@ -0,0 +1,311 @@
+#include "sccp.h"
+#include "intermediate_representation/codegen/optimization/constant_folding.h"
+
+namespace sigma::ir {
+	auto sccp::lattice::operator==(const lattice& other) const -> bool {
+		return state == other.state && (state != CONSTANT || value == other.value);
+	}
+
+	void sccp::apply(transformation_context& context) {
+		m_function = context.function;
+		m_work = &context.work;
+
+		context.work.push_all(m_function);
+		const std::vector<handle<node>> nodes = context.work.items;
+		context.work.clear();
+
+		// every node starts off as TOP
+		m_values.assign(m_function->node_count, lattice{});
+
+		solve(nodes);
+		rewrite(nodes);
+		remove_dead_nodes(nodes);
+
+		m_values.clear();
+	}
+
+	void sccp::solve(const std::vector<handle<node>>& nodes) {
+		for(const handle<node> n : nodes) {
+			if(m_work->visit(n)) {
+				m_work->items.push_back(n);
+			}
+		}
+
+		while(!m_work->items.empty()) {
+			const handle<node> n = m_work->items.back();
+
+			m_work->items.pop_back();
+			m_work->forget(n);
+
+			const lattice& old_value = get(n);
+			const lattice new_value = meet(old_value, evaluate(n));
+
+			if(new_value == old_value) {
+				continue;
+			}
+
+			m_values[n->global_value_index] = new_value;
+
+			// revisit all users
+			for(handle<user> u = n->use; u; u = u->next_user) {
+				revisit(u->target);
+
+				// projections of branches depend on the condition, and phis depend on the
+				// reachability of region inputs, neither of which are their direct inputs
+				if(u->target == node::type::BRANCH || u->target == node::type::REGION) {
+					for(handle<user> dependent = u->target->use; dependent; dependent = dependent->next_user) {
+						revisit(dependent->target);
+					}
+				}
+			}
+		}
+
+		m_work->clear();
+	}
+
+	void sccp::revisit(handle<node> n) const {
+		if(m_work->visit(n)) {
+			m_work->items.push_back(n);
+		}
+	}
+
+	void sccp::rewrite(const std::vector<handle<node>>& nodes) {
+		// fold branches with constant conditions, the live successor is connected to the
+		// control node preceding the branch
+		for(const handle<node> n : nodes) {
+			if(n != node::type::BRANCH || !is_reachable(n) || get(n->inputs[1]).state != lattice::CONSTANT) {
+				continue;
+			}
+
+			handle<node> live_successor = nullptr;
+
+			for(handle<user> u = n->use; u; u = u->next_user) {
+				if(u->target == node::type::PROJECTION && is_reachable(u->target)) {
+					live_successor = u->target;
+				}
+			}
+
+			ASSERT(live_successor != nullptr, "branch without a reachable successor");
+			m_function->replace_uses(live_successor, n->inputs[0]);
+			std::erase(m_function->terminators, n);
+		}
+
+		for(const handle<node> n : nodes) {
+			if(n == node::type::REGION && is_reachable(n)) {
+				remove_dead_predecessors(n);
+			}
+		}
+
+		// replace values which are known to be constant
+		for(const handle<node> n : nodes) {
+			const lattice& value = get(n);
+
+			if(value.state != lattice::CONSTANT || n == node::type::INTEGER_CONSTANT) {
+				continue;
+			}
+
+			const handle<node> constant = m_function->create_node<integer>(node::type::INTEGER_CONSTANT, 1);
+			constant->dt = n->dt;
+
+			auto& property = constant->get<integer>();
+			property.bit_width = n->dt.get_bit_width();
+			property.value = value.value;
+
+			m_function->replace_uses(n, constant);
+			m_function->detach_inputs(n);
+		}
+
+		std::erase_if(m_function->terminators, [&](handle<node> terminator) {
+			return !is_reachable(terminator);
+		});
+	}
+
+	void sccp::remove_dead_predecessors(handle<node> region) {
+		std::vector<handle<node>> phis;
+
+		for(handle<user> u = region->use; u; u = u->next_user) {
+			if(u->target == node::type::PHI && u->slot == 0) {
+				phis.push_back(u->target);
+			}
+		}
+
+		for(u64 i = region->inputs.get_size(); i-- > 0;) {
+			if(is_reachable(region->inputs[i])) {
+				continue;
+			}
+
+			for(const handle<node> phi : phis) {
+				ASSERT(phi->inputs.get_size() == region->inputs.get_size() + 1, "phi/region input mismatch");
+				m_function->remove_input(phi, i + 1);
+			}
+
+			m_function->remove_input(region, i);
+		}
+	}
+
+	void sccp::remove_dead_nodes(const std::vector<handle<node>>& nodes) const {
+		// unreachable nodes may still be registered as users of live nodes, unlink them so
+		// that later passes don't see them
+		m_work->push_all(m_function);
+
+		for(const handle<node> n : nodes) {
+			if(!m_work->is_visited(n)) {
+				m_function->detach_inputs(n);
+			}
+		}
+
+		m_work->clear();
+	}
+
+	auto sccp::evaluate(handle<node> n) const -> lattice {
+		switch(n->get_type()) {
+			case node::type::ENTRY: {
+				return { lattice::BOTTOM };
+			}
+			case node::type::REGION: {
+				for(const handle<node>& input : n->inputs) {
+					if(is_reachable(input)) {
+						return { lattice::BOTTOM };
+					}
+				}
+
+				return { lattice::TOP };
+			}
+			case node::type::PHI: {
+				return evaluate_phi(n);
+			}
+			case node::type::PROJECTION: {
+				return evaluate_projection(n);
+			}
+			case node::type::INTEGER_CONSTANT: {
+				return { lattice::CONSTANT, mask_to_width(n->get<integer>().value, n->dt.get_bit_width()) };
+			}
+			default: {
+				break;
+			}
+		}
+
+		// pinned nodes are unreachable as long as their control input is
+		if(n->inputs.get_size() > 0 && n->inputs[0] && !is_reachable(n->inputs[0])) {
+			return { lattice::TOP };
+		}
+
+		switch(n->get_type()) {
+			case node::type::ADD:
+			case node::type::SUB:
+			case node::type::MUL:
+			case node::type::AND:
+			case node::type::OR:
+			case node::type::XOR:
+			case node::type::NEG:
+			case node::type::CMP_EQ:
+			case node::type::CMP_NE:
+			case node::type::CMP_ULT:
+			case node::type::CMP_ULE:
+			case node::type::CMP_SLT:
+			case node::type::CMP_SLE:
+			case node::type::TRUNCATE:
+			case node::type::SIGN_EXTEND:
+			case node::type::ZERO_EXTEND: {
+				const lattice a = get(n->inputs[1]);
+				const lattice b = n->inputs.get_size() > 2 ? get(n->inputs[2]) : lattice{ lattice::CONSTANT };
+
+				if(a.state == lattice::TOP || b.state == lattice::TOP) {
+					return { lattice::TOP };
+				}
+
+				u64 result;
+
+				if(
+					a.state == lattice::CONSTANT &&
+					b.state == lattice::CONSTANT &&
+					evaluate_integer_operation(n, a.value, b.value, result)
+				) {
+					return { lattice::CONSTANT, result };
+				}
+
+				return { lattice::BOTTOM };
+			}
+			default: {
+				return { lattice::BOTTOM };
+			}
+		}
+	}
+
+	auto sccp::evaluate_phi(handle<node> phi) const -> lattice {
+		const handle<node> region = phi->inputs[0];
+
+		if(!is_reachable(region)) {
+			return { lattice::TOP };
+		}
+
+		if(phi->dt == data_type::base::MEMORY) {
+			return { lattice::BOTTOM };
+		}
+
+		ASSERT(phi->inputs.get_size() == region->inputs.get_size() + 1, "phi/region input mismatch");
+		lattice result;
+
+		// only consider values flowing in from reachable predecessors
+		for(u64 i = 1; i < phi->inputs.get_size(); ++i) {
+			if(is_reachable(region->inputs[i - 1])) {
+				result = meet(result, get(phi->inputs[i]));
+			}
+		}
+
+		return result;
+	}
+
+	auto sccp::evaluate_projection(handle<node> projection) const -> lattice {
+		const handle<node> source = projection->inputs[0];
+
+		if(!is_reachable(source)) {
+			return { lattice::TOP };
+		}
+
+		if(source != node::type::BRANCH || projection->dt != data_type::base::CONTROL) {
+			return { lattice::BOTTOM };
+		}
+
+		const auto& branch = source->get<ir::branch>();
+		const lattice& condition = get(source->inputs[1]);
+
+		if(condition.state == lattice::TOP) {
+			return { lattice::TOP };
+		}
+
+		if(condition.state == lattice::BOTTOM || branch.keys.size() != 1) {
+			return { lattice::BOTTOM };
+		}
+
+		// the first successor is taken when the condition doesn't match the key
+		const u64 taken = condition.value != branch.keys[0] ? 0 : 1;
+		const u64 index = projection->get<ir::projection>().index;
+
+		return { index == taken ? lattice::BOTTOM : lattice::TOP };
+	}
+
+	auto sccp::get(handle<node> n) const -> const lattice& {
+		return m_values[n->global_value_index];
+	}
+
+	auto sccp::is_reachable(handle<node> n) const -> bool {
+		return get(n).state == lattice::BOTTOM;
+	}
+
+	auto sccp::meet(const lattice& a, const lattice& b) -> lattice {
+		if(a.state == lattice::TOP) {
+			return b;
+		}
+
+		if(b.state == lattice::TOP) {
+			return a;
+		}
+
+		if(a.state == lattice::CONSTANT && b == a) {
+			return a;
+		}
+
+		return { lattice::BOTTOM };
+	}
+} // namespace sigma::ir
@@ -0,0 +1,50 @@
+#pragma once
+#include "intermediate_representation/codegen/optimization/optimization_pass_list.h"
+
+namespace sigma::ir {
+	/**
+	 * \brief Sparse conditional constant propagation. Optimistically assumes every node is
+	 * unreachable/undefined and propagates values and reachability along the use lists.
+	 * Branches on constant conditions are folded, unreachable predecessors are removed from
+	 * their regions (along with the respective PHI inputs), and values which turn out to be
+	 * constant are replaced by integer constants.
+	 */
+	class sccp : public optimization_pass {
+	public:
+		void apply(transformation_context& context) override;
+	private:
+		struct lattice {
+			enum state_type : u8 {
+				TOP,      // undefined value/unreachable control
+				CONSTANT, // known integer value
+				BOTTOM    // unknown value/reachable control
+			};
+
+			auto operator==(const lattice& other) const -> bool;
+
+			state_type state = TOP;
+			u64 value = 0;
+		};
+
+		void solve(const std::vector<handle<node>>& nodes);
+		void revisit(handle<node> n) const;
+		void rewrite(const std::vector<handle<node>>& nodes);
+		void remove_dead_predecessors(handle<node> region);
+		void remove_dead_nodes(const std::vector<handle<node>>& nodes) const;
+
+		auto evaluate(handle<node> n) const -> lattice;
+		auto evaluate_phi(handle<node> phi) const -> lattice;
+		auto evaluate_projection(handle<node> projection) const -> lattice;
+
+		auto get(handle<node> n) const -> const lattice&;
+		auto is_reachable(handle<node> n) const -> bool;
+
+		static auto meet(const lattice& a, const lattice& b) -> lattice;
+	private:
+		handle<function> m_function;
+		handle<work_list> m_work;
+
+		// lattice values, indexed by the global value index of the given node
+		std::vector<lattice> m_values;
+	};
+} // namespace sigma::ir
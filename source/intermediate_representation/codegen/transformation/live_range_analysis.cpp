@@ -6,11 +6,10 @@ namespace sigma::ir {
 		u64 epilogue = std::numeric_limits<u64>::max();
 
 		// find block boundaries in sequences
-		context.machine_blocks.reserve(context.basic_block_order.size());
+		context.machine_blocks.resize(context.graph.blocks.size());
 
 		for(const u64 block_order : context.basic_block_order) {
-			auto target = context.work.items[block_order];
-			const auto basic_block = &context.graph.blocks.at(target);
+			const auto basic_block = &context.graph.blocks[block_order];
 
 			const machine_block machine_block{
 				.end_node = basic_block->end,
@@ -20,7 +19,7 @@ namespace sigma::ir {
 				.live_out = utility::dense_set(interval_count)
 			};
 
-			context.machine_blocks[target] = machine_block;
+			context.machine_blocks[block_order] = machine_block;
 		}
 	
 		if (context.first) {
@@ -29,7 +28,7 @@ namespace sigma::ir {
 
 			// initial label
 			auto basic_block = context.work.items.front();
-			auto machine_block = &context.machine_blocks.at(basic_block);
+			auto machine_block = context.get_machine_block(basic_block);
 			u64 timeline = 4;
 
 			machine_block->first = inst;
@@ -39,13 +38,13 @@ namespace sigma::ir {
 
 			for (; inst; inst = inst->next_instruction) {
 				if (inst == instruction::type::LABEL) {
-					context.machine_blocks.at(basic_block).end = timeline;
+					machine_block->end = timeline;
 					timeline += 4;
 
 					ASSERT(inst->flags & instruction::NODE, "instruction does not contain a node");
 
 					basic_block = inst->get<handle<node>>();
-					machine_block = &context.machine_blocks.at(basic_block);
+					machine_block = context.get_machine_block(basic_block);
 					machine_block->first = inst->next_instruction;
 					machine_block->start = timeline;
 				}
@@ -87,7 +86,7 @@ namespace sigma::ir {
 			auto n = context.work.items[block_order];
 			context.work.items.push_back(n);
 
-			const auto machine_block = &context.machine_blocks.at(n);
+			const auto machine_block = &context.machine_blocks[block_order];
 			machine_block->live_in.copy(machine_block->gen);
 		}
 
@@ -96,7 +95,7 @@ namespace sigma::ir {
 			handle<node> basic_block = context.work.items.back();
 			context.work.items.pop_back();
 
-			const auto machine_block = &context.machine_blocks.at(basic_block);
+			const auto machine_block = context.get_machine_block(basic_block);
 			const auto block_end = machine_block->end_node;
 			auto& live_out = machine_block->live_out;
 
@@ -108,14 +107,14 @@ namespace sigma::ir {
 					if (user->target == node::type::PROJECTION) {
 						// union with successor's lives
 						handle<node> successor = user->target->get_next_block();
-						live_out.set_union(context.machine_blocks.at(successor).live_in);
+						live_out.set_union(context.get_machine_block(successor)->live_in);
 					}
 				}
 			}
 			else if (block_end != node::type::EXIT && block_end != node::type::UNREACHABLE) {
 				// union with successor's lives
 				handle<node> successor = block_end->get_next_control();
-				live_out.set_union(context.machine_blocks.at(successor).live_in);
+				live_out.set_union(context.get_machine_block(successor)->live_in);
 			}
 
 			auto& live_in = machine_block->live_in;
@@ -22,20 +22,18 @@ namespace sigma::ir {
 		}
 
 		// start at the entry point
-		handle best = context.schedule.at(context.work.items[0]);
+		handle best = context.schedule[context.work.items[0]->global_value_index];
 		i32 best_depth = 0;
 
 		// choose deepest block
 		for (u64 i = 0; i < target->inputs.get_size(); ++i) {
 			if (const handle<node> input = target->inputs[i]) {
-				auto it = context.schedule.find(input);
+				const handle<basic_block> basic_block = context.schedule[input->global_value_index];
 
-				if (it == context.schedule.end()) {
+				if (basic_block == nullptr) {
 					continue;
 				}
 
-				const handle<basic_block> basic_block = it->second;
-
 				if (best_depth < basic_block->dominator_depth) {
 					best_depth = basic_block->dominator_depth;
 					best = basic_block;
@@ -44,7 +42,7 @@ namespace sigma::ir {
 		}
 
 		best->items.insert(target);
-		context.schedule[target] = best;
+		context.schedule[target->global_value_index] = best;
 	}
 
 	void schedule_late(codegen_context& context, const handle<node>& target) {
@@ -59,13 +57,11 @@ namespace sigma::ir {
 		for (handle<user> use = target->use; use; use = use->next_user) {
 			handle<node> user_node = use->target;
 
-			auto it = context.schedule.find(user_node);
-			if (it == context.schedule.end()) {
+			handle<basic_block> use_block = context.schedule[user_node->global_value_index];
+			if (use_block == nullptr) {
 				continue; // node is dead
 			}
 
-			handle<basic_block> use_block = it->second;
-
 			if (user_node == node::type::PHI) {
 				const handle<node> use_node = user_node->inputs[0];
 				ASSERT(use_node == node::type::REGION, "user block expects a region node");
@@ -78,9 +74,8 @@ namespace sigma::ir {
 					}
 				}
 
-				it = context.schedule.find(use_node->inputs[j - 1]);
-				if (it != context.schedule.end()) {
-					use_block = it->second;
+				if (const handle<basic_block> predecessor_block = context.schedule[use_node->inputs[j - 1]->global_value_index]) {
+					use_block = predecessor_block;
 				}
 			}
 
@@ -88,16 +83,17 @@ namespace sigma::ir {
 		}
 
 		if (least_common_ancestor) {
-			const auto it = context.schedule.find(target);
+			const handle<basic_block> old = context.schedule[target->global_value_index];
+			context.schedule[target->global_value_index] = least_common_ancestor;
+
+			// move the node over to its new block, nodes which aren't a part of any block get
+			// rematerialized at every use
+			if (old != least_common_ancestor) {
+				if (old) {
+					old->items.erase(target);
+				}
 
-			if (it != context.schedule.end()) {
-				// replace the old ancestor
-				const handle<basic_block> old = it->second;
-				context.schedule[target] = least_common_ancestor;
-				old->items.erase(target);
-			}
-			else {
-				context.schedule[target] = least_common_ancestor;
+				least_common_ancestor->items.insert(target);
 			}
 		}
 	}
@@ -105,27 +101,27 @@ namespace sigma::ir {
 	void schedule_node_hierarchy(codegen_context& context) {
 		// generate graph dominators 
 		context.work.compute_dominators(context.graph);
-		context.work.visited_items.clear();
+		context.work.clear_visited();
 
-		for (u64 i = 0; i < context.graph.blocks.size(); ++i) {
-			context.graph.blocks.at(context.work.items[i]).items.reserve(32);
+		for (basic_block& block : context.graph.blocks) {
+			block.items.reserve(32);
 		}
 
 		for (u64 i = context.graph.blocks.size(); i-- > 0;) {
 			handle<node> basic_block_node = context.work.items[i];
-			const handle basic_block = &context.graph.blocks[basic_block_node];
+			const handle basic_block = &context.graph.blocks[i];
 			handle<node> basic_block_end = basic_block->end;
 
 			if (i == 0) {
 				// schedule the entry node
 				handle<node> start = context.function->entry_node;
 				basic_block->items.insert(start);
-				context.schedule[start] = basic_block;
+				context.schedule[start->global_value_index] = basic_block;
 			}
 
 			while(true) {
 				basic_block->items.insert(basic_block_end);
-				context.schedule[basic_block_end] = basic_block;
+				context.schedule[basic_block_end->global_value_index] = basic_block;
 
 				// add projections to the same block
 				for (handle<user> use = basic_block_end->use; use; use = use->next_user) {
@@ -135,9 +131,9 @@ namespace sigma::ir {
 						use->slot == 0 &&
 						(projection == node::type::PROJECTION || projection == node::type::PHI)
 					) {
-						if (!context.schedule.contains(projection)) {
+						if (context.schedule[projection->global_value_index] == nullptr) {
 							basic_block->items.insert(projection);
-							context.schedule[projection] = basic_block;
+							context.schedule[projection->global_value_index] = basic_block;
 						}
 					}
 				}
@@ -151,7 +147,7 @@ namespace sigma::ir {
 		}
 
 		for (u64 i = context.graph.blocks.size(); i-- > 0;) {
-			schedule_early(context, context.graph.blocks.at(context.work.items[i]).end);
+			schedule_early(context, context.graph.blocks[i].end);
 		}
 
 		for (u64 i = context.graph.blocks.size(); i < context.work.items.size(); ++i) {
@@ -159,7 +155,7 @@ namespace sigma::ir {
 		}
 
 		context.work.items.resize(context.graph.blocks.size());
-		context.work.visited_items.clear();
+		context.work.clear_visited();
 		context.labels.resize(context.graph.blocks.size());
 	}
 } // namespace sigma::ir
\ No newline at end of file
@@ -24,7 +24,7 @@ namespace sigma::ir {
 	}
 
 	void work_list::compute_dominators(control_flow_graph& cfg) const {
-		const handle entry = &cfg.blocks.at(items[0]);
+		const handle entry = &cfg.blocks[0];
 		bool changed = true;
 
 		entry->dominator = entry;
@@ -79,13 +79,13 @@ namespace sigma::ir {
 				}
 
 				ASSERT(new_immediate_dominator != nullptr, "panic");
-				const auto basic_block = &cfg.blocks.at(block);
+				const auto basic_block = &cfg.blocks[i];
 
 				if (
 					basic_block->dominator == nullptr || 
 					basic_block->dominator->start != new_immediate_dominator
 				) {
-					basic_block->dominator = &cfg.blocks.at(new_immediate_dominator);
+					basic_block->dominator = cfg.get_block(new_immediate_dominator);
 					changed = true;
 				}
 			}
@@ -124,11 +124,42 @@ namespace sigma::ir {
 	}
 
 	auto work_list::visit(handle<node> node) -> bool {
-		return visited_items.insert(node).second;
+		const u64 word = node->global_value_index / 64;
+		const u64 bit = 1ull << (node->global_value_index % 64);
+
+		// nodes may be created while the list is in use, grow on demand
+		if(word >= visited_items.size()) {
+			visited_items.resize(word + 1, 0);
+		}
+
+		if(visited_items[word] & bit) {
+			return false;
+		}
+
+		visited_items[word] |= bit;
+		return true;
+	}
+
+	auto work_list::is_visited(handle<node> node) const -> bool {
+		const u64 word = node->global_value_index / 64;
+		return word < visited_items.size() && (visited_items[word] & (1ull << (node->global_value_index % 64)));
+	}
+
+	void work_list::forget(handle<node> node) {
+		const u64 word = node->global_value_index / 64;
+
+		if(word < visited_items.size()) {
+			visited_items[word] &= ~(1ull << (node->global_value_index % 64));
+		}
+	}
+
+	void work_list::clear_visited() {
+		// keep the memory around, the list is reused by all passes of a function
+		std::ranges::fill(visited_items, 0);
 	}
 
 	void work_list::clear() {
-		visited_items.clear();
+		clear_visited();
 		items.clear();
 	}
 } // namespace sigma::ir
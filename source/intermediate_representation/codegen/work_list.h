@@ -5,12 +5,16 @@ namespace sigma::ir {
 	struct work_list {
 		auto mark_next_control(handle<node> target) -> handle<node>;
 		auto visit(handle<node> node) -> bool;
+		auto is_visited(handle<node> node) const -> bool;
+		void forget(handle<node> node);
 
 		void compute_dominators(control_flow_graph& cfg) const;
 		void push_all(handle<function> function);
+		void clear_visited();
 		void clear();
 
-		std::unordered_set<handle<node>> visited_items;
+		// bitset of visited nodes, indexed by the global value index of the given node
+		std::vector<u64> visited_items;
 		std::vector<handle<node>> items;
 	};
 }// namespace sigma::ir
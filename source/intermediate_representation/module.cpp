@@ -5,6 +5,10 @@
 
 // transformation passes
 #include "intermediate_representation/codegen/optimization/optimization_pass_list.h"
+#include "intermediate_representation/codegen/optimization/inliner.h"
+#include "intermediate_representation/codegen/optimization/mem2reg.h"
+#include "intermediate_representation/codegen/optimization/peephole.h"
+#include "intermediate_representation/codegen/optimization/sccp.h"
 #include "intermediate_representation/codegen/transformation/live_range_analysis.h"
 #include "intermediate_representation/codegen/transformation/scheduler.h"
 #include "intermediate_representation/codegen/transformation/use_list.h"
@@ -22,108 +26,155 @@ namespace sigma::ir {
 		}
 	}
 
-	void module::compile() const {
-		// specify individual optimization passes
-		const optimization_pass_list optimizations({});
-		const auto register_allocator = std::make_shared<linear_scan_allocator>();
-		std::stringstream assembly;
+	void module::compile(const executor& execute, bool disassemble) const {
+		// the inliner reads the node graphs of callees, which means it has to run before any of
+		// the functions start being modified by their own passes
+		inliner().apply(m_functions);
+
+		// functions don't share any mutable state during codegen (every function has its own
+		// allocator, and the output is written into the function itself), which means we can
+		// compile them in parallel, the final layout is determined by the order of m_functions
+		execute(m_functions.size(), [&](u64 index) {
+			compile_function(m_functions[index], disassemble);
+		});
+	}
 
-		// go through all declared functions and run codegen
-		for (const handle<function> function : m_functions) {
-			// every function has its own unique work list (thread safe), this list is reused in all passes
-			// of the given function so that we don't have to reallocate memory needlessly
-			work_list function_work_list;
-
-			// initialize the transformation pass
-			transformation_context transformation {
-				.function = function,
-				.work = function_work_list
-			};
-
-			// run our transformations
-			generate_use_lists(transformation); // mandatory (move over to an optimization?)
-			optimizations.apply(transformation);
-			 
-			// initialize the code generation pass
-			codegen_context codegen {
-				.function = function,
-				.target = m_codegen.get_target(),
-				.work = function_work_list,
-				.intervals = m_codegen.get_register_intervals()
-			};
-			
-			// generate a control flow graph
-			codegen.graph = control_flow_graph::compute_reverse_post_order(codegen);
-
-			// schedule nodes
-			schedule_node_hierarchy(codegen);
-
-			// select instructions for the architecture specified by the target
-			m_codegen.select_instructions(codegen);
-
-			// allocate registers (determine live ranges, use these ranges to construct live
-			// intervals, which are then used by the selected register allocator.
-			determine_live_ranges(codegen);
-			register_allocator->allocate(codegen);
-
-			// generate a bytecode representation of the given function for the specified target
-			const utility::byte_buffer bytecode = m_codegen.emit_bytecode(codegen);
-
-			// for(const auto b : bytecode) {
-			// 	std::cout << b.to_hex() << ' ';
-			// }
-			// 
-			// std::cout << '\n';
-			
-			// DEBUG
-			// assembly << m_codegen.disassemble(bytecode, codegen).str();
-			
-			// finally, emit the compiled function
-			function->output = {
-				.parent = function,
-				.prologue_length = codegen.prologue_length,
-				.stack_usage = codegen.stack_usage,
-				.bytecode = bytecode,
-				.patch_count = codegen.patch_count,
-				.first_patch = codegen.first_patch,
-				.last_patch = codegen.last_patch
-			};
+	void module::compile_function(handle<function> function, bool disassemble) const {
+		// specify individual optimization passes
+		const optimization_pass_list optimizations({
+			std::make_shared<mem2reg>(),
+			std::make_shared<sccp>(),
+			std::make_shared<peephole>()
+		});
+
+		// the register allocator keeps track of its state, use a unique one for every function
+		linear_scan_allocator register_allocator;
+
+		// every function has its own unique work list (thread safe), this list is reused in all passes
+		// of the given function so that we don't have to reallocate memory needlessly
+		work_list function_work_list;
+
+		// initialize the transformation pass
+		transformation_context transformation {
+			.function = function,
+			.work = function_work_list
+		};
+
+		// run our transformations
+		generate_use_lists(transformation); // mandatory (move over to an optimization?)
+		optimizations.apply(transformation);
+
+		// initialize the code generation pass
+		codegen_context codegen {
+			.function = function,
+			.target = m_codegen.get_target(),
+			.work = function_work_list,
+			.intervals = m_codegen.get_register_intervals()
+		};
+
+		// side tables of the code generator are indexed by global value indices of nodes
+		codegen.allocate_node_tables();
+
+		// generate a control flow graph
+		codegen.graph = control_flow_graph::compute_reverse_post_order(codegen);
+
+		// schedule nodes
+		schedule_node_hierarchy(codegen);
+
+		// select instructions for the architecture specified by the target
+		m_codegen.select_instructions(codegen);
+
+		// allocate registers (determine live ranges, use these ranges to construct live
+		// intervals, which are then used by the selected register allocator.
+		determine_live_ranges(codegen);
+		register_allocator.allocate(codegen);
+
+		// generate a bytecode representation of the given function for the specified target
+		const utility::byte_buffer bytecode = m_codegen.emit_bytecode(codegen);
+
+		// the disassembler relies on the codegen context, which doesn't outlive this function
+		std::string assembly;
+
+		if(disassemble) {
+			assembly = m_codegen.disassemble(bytecode, codegen).str();
 		}
 
-		// DEBUG
-		// utility::console::print("{}\n", assembly.str());
+		// finally, emit the compiled function
+		function->output = {
+			.parent = function,
+			.prologue_length = codegen.prologue_length,
+			.stack_usage = codegen.stack_usage,
+			.bytecode = bytecode,
+			.patch_count = codegen.patch_count,
+			.first_patch = codegen.first_patch,
+			.last_patch = codegen.last_patch,
+			.assembly = std::move(assembly)
+		};
 	}
 
 	auto module::generate_object_file() -> utility::byte_buffer {
 		return m_codegen.emit_object_file(*this);
 	}
 
+	auto module::generate_assembly() const -> std::string {
+		std::string assembly;
+
+		for(const handle<function>& function : m_functions) {
+			assembly += function->output.assembly;
+		}
+
+		return assembly;
+	}
+
+	auto module::generate_executable() -> utility::byte_buffer {
+		return m_codegen.emit_executable(*this);
+	}
+
 	auto module::create_external(const std::string& name, linkage linkage) -> handle<external> {
+		const std::lock_guard lock(m_mutex);
 		const handle external = m_allocator.emplace<ir::external>();
 
 		// construct the external symbol
 		external->symbol = symbol(symbol::EXTERNAL, std::string(name), this, linkage);
+		external->symbol.ordinal = get_next_ordinal();
 		
 		m_symbols.emplace_back(&external->symbol);
 		return external;
 	}
 
 	auto module::create_global(const std::string& name, linkage linkage) -> handle<global> {
+		return create_global(name, linkage, get_next_ordinal());
+	}
+
+	auto module::create_global(const std::string& name, linkage linkage, u64 ordinal) -> handle<global> {
+		const std::lock_guard lock(m_mutex);
 		const handle global = m_allocator.emplace<ir::global>(
 			symbol(symbol::GLOBAL, std::string(name), this, linkage)
 		);
 
+		global->symbol.ordinal = ordinal;
+
 		m_globals.emplace_back(global);
 		m_symbols.emplace_back(&global->symbol);
 
 		return global;
 	}
 
+	auto module::get_next_ordinal() -> u64 {
+		return m_next_ordinal.fetch_add(ordinal_stride);
+	}
+
 	auto module::create_function(const function_signature& signature, linkage linkage) -> handle<function> {
-		const handle function = m_allocator.emplace<ir::function>(signature.identifier, linkage, get_text_section());
+		handle<function> function;
+
+		{
+			const std::lock_guard lock(m_mutex);
+			function = m_allocator.emplace<ir::function>(signature.identifier, linkage, get_text_section());
+			function->symbol.ordinal = get_next_ordinal();
 
-		m_functions.push_back(function);
-		m_symbols.emplace_back(&function->symbol);
+			m_functions.push_back(function);
+			m_symbols.emplace_back(&function->symbol);
+		}
 
 		// allocate the entry node
 		const handle<node> entry_node = function->create_node<region>(node::type::ENTRY, 0);
@@ -158,7 +209,10 @@ namespace sigma::ir {
 	}
 
 	auto module::create_string(handle<function> function, const std::string& value) -> handle<node> {
-		const handle<global> dummy = create_global("", linkage::PRIVATE);
+		// functions are only ever modified by a single thread, the ordinal is therefore independent
+		// of the order in which functions create their strings
+		const u64 ordinal = function->symbol.ordinal + ++function->symbol_count;
+		const handle<global> dummy = create_global("", linkage::PRIVATE, ordinal);
 		dummy->set_storage(get_rdata_section(), static_cast<u32>(value.size() + 1), 1, 1);
 
 		const auto destination = static_cast<char*>(dummy->add_region(0, static_cast<u32>(value.size() + 1)));
@@ -182,6 +236,12 @@ namespace sigma::ir {
 	auto module::generate_externals() -> std::vector<handle<external>> {
 		std::vector<handle<external>> externals = {};
 
+		// symbols might have been created in parallel, restore the order in which they'd be created
+		// by a single thread
+		std::ranges::stable_sort(m_symbols, {}, [](const handle<symbol>& symbol) {
+			return symbol->ordinal;
+		});
+
 		for(const handle<symbol>& symbol : m_symbols) {
 			switch(symbol->type) {
 				case symbol::symbol_type::FUNCTION: {
@@ -208,18 +268,9 @@ namespace sigma::ir {
 			}
 		}
 
-		// TODO: actually assign ordinals
+		// symbols were sorted by their ordinals, functions and globals were therefore appended to
+		// their sections in a deterministic order, which doesn't depend on the number of threads
 		for(module_section& section : m_output.sections) {
-			// // sort functions
-			// std::ranges::sort(section.functions, [](const handle<compiled_function>& a, const handle<compiled_function>& b) {
-			// 	return a->ordinal < b->ordinal;
-			// });
-			// 
-			// // sort globals
-			// std::ranges::sort(section.globals, [](const handle<global>& a, const handle<global>& b) {
-			// 	return reinterpret_cast<symbol*>(a.get())->ordinal < reinterpret_cast<symbol*>(b.get())->ordinal;
-			// });
-
 			// place functions first
 			u32 offset = 0;
 			for(const handle<compiled_function>& function : section.functions) {
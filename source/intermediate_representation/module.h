@@ -1,5 +1,8 @@
 #pragma once
 #include "intermediate_representation/codegen/codegen_target.h"
+#include <functional>
+#include <atomic>
+#include <mutex>
 
 // The entire IR system is based off of an implementation in Cuik's Tilde backend
 // (https://github.com/RealNeGate/Cuik/tree/master/tb)
@@ -22,16 +25,53 @@ namespace sigma::ir {
 	 */
 	class module {
 	public:
+		/**
+		 * \brief Invokes a function for every index in the range [0, count) and returns once all
+		 * invocations have finished, invocations may run in parallel.
+		 */
+		using executor = std::function<void(u64 count, const std::function<void(u64)>& function)>;
+
 		module(target target);
 		~module();
 
-		void compile() const;
+		/**
+		 * \brief Runs codegen for all functions contained in the module. Functions are compiled
+		 * independently of each other, the resulting output is deterministic regardless of the
+		 * number of threads used.
+		 * \param execute Executor used to distribute the individual functions across threads
+		 * \param disassemble Keep a disassembly of every compiled function (see generate_assembly)
+		 */
+		void compile(const executor& execute, bool disassemble = false) const;
 		auto generate_object_file() -> utility::byte_buffer;
 
+		/**
+		 * \brief Concatenates the disassembly of all functions, in the order in which they were
+		 * created. The module has to be compiled with disassembly enabled.
+		 * \return Human readable assembly of the module.
+		 */
+		auto generate_assembly() const -> std::string;
+
+		/**
+		 * \brief Links the compiled module into an executable, without relying on an external linker.
+		 * \return Executable image for the target system.
+		 */
+		auto generate_executable() -> utility::byte_buffer;
+
+		// symbols can be created from multiple threads, the final layout is determined by the order in
+		// which the symbols were created, symbols created by parallel threads should therefore be
+		// created on behalf of a function (ie. strings)
 		auto create_external(const std::string& name, linkage linkage) -> handle<external>;
 		auto create_function(const function_signature& signature, linkage linkage) -> handle<function>;
 
 		auto create_global(const std::string& name, linkage linkage) -> handle<global>;
+
+		/**
+		 * \brief Creates a new read-only string, which is placed right after \b function. Different
+		 * functions can create their strings in parallel.
+		 * \param function Function which references the string
+		 * \param value Value of the string
+		 * \return Node containing the address of the string.
+		 */
 		auto create_string(handle<function> function, const std::string& value) -> handle<node>;
 
 		[[nodiscard]] auto get_target() const -> target;
@@ -41,6 +81,11 @@ namespace sigma::ir {
 
 		auto generate_externals() -> std::vector<handle<external>>;
 
+		void compile_function(handle<function> function, bool disassemble) const;
+
+		auto create_global(const std::string& name, linkage linkage, u64 ordinal) -> handle<global>;
+		auto get_next_ordinal() -> u64;
+
 		static constexpr u8 get_text_section()  { return 0; }
 		static constexpr u8 get_data_section()  { return 1; }
 		static constexpr u8 get_rdata_section() { return 2; }
@@ -66,7 +111,17 @@ namespace sigma::ir {
 		std::vector<handle<symbol>> m_symbols;
 		std::vector<handle<global>> m_globals;
 
+		// guards the allocator and the symbol lists
+		std::mutex m_mutex;
+
+		// ordinals of symbols, which aren't created on behalf of a function, are spread out, so that
+		// symbols of a function can be ordered right after it
+		static constexpr u64 ordinal_stride = u64(1) << 32;
+		std::atomic<u64> m_next_ordinal = 0;
+
 		friend class coff_file_emitter;
 		friend class elf_file_emitter;
+		friend class elf_executable_emitter;
+		friend class jit;
 	};
 } // namespace sigma::ir
@@ -432,4 +432,63 @@ namespace sigma::ir {
 
 		add_input_late(property.memory_in, mem_state);
 	}
+
+	void function::set_input(handle<node> n, u64 slot, handle<node> input) {
+		// unlink the previous input and reuse its user entry, if there is one
+		const handle<user> recycled = n->remove_user(slot);
+		n->inputs[slot] = input;
+
+		if(input) {
+			n->add_user(input, slot, recycled, &allocator);
+		}
+	}
+
+	void function::replace_uses(handle<node> target, handle<node> replacement) {
+		ASSERT(target != replacement, "cannot replace a node with itself");
+
+		handle<user> u = target->use;
+		target->use = nullptr;
+
+		// move every user over to the replacement node
+		while(u) {
+			const handle<user> next = u->next_user;
+
+			u->target->inputs[u->slot] = replacement;
+			u->target->add_user(replacement, u->slot, u, &allocator);
+			u = next;
+		}
+	}
+
+	void function::detach_inputs(handle<node> n) {
+		for(u64 i = 0; i < n->inputs.get_size(); ++i) {
+			n->remove_user(i);
+			n->inputs[i] = nullptr;
+		}
+	}
+
+	void function::remove_input(handle<node> n, u64 slot) {
+		const u64 old_count = n->inputs.get_size();
+		ASSERT(slot < old_count, "input slot out of range");
+
+		// the slots of all following inputs are about to change, unlink them first
+		for(u64 i = slot; i < old_count; ++i) {
+			n->remove_user(i);
+		}
+
+		utility::memory_view<handle<node>> new_inputs(allocator, old_count - 1);
+
+		for(u64 i = 0, j = 0; i < old_count; ++i) {
+			if(i != slot) {
+				new_inputs[j++] = n->inputs[i];
+			}
+		}
+
+		n->inputs = new_inputs;
+
+		for(u64 i = slot; i < old_count - 1; ++i) {
+			if(n->inputs[i]) {
+				n->add_user(n->inputs[i], i, nullptr, &allocator);
+			}
+		}
+	}
 } // namespace sigma::ir
@@ -27,6 +27,8 @@ namespace sigma::ir {
 		u64 patch_count;
 		handle<symbol_patch> first_patch;
 		handle<symbol_patch> last_patch;
+
+		std::string assembly; // only present if the module was compiled with disassembly enabled
 	};
 
 	struct function {
@@ -38,6 +40,12 @@ namespace sigma::ir {
 		void add_input_late(handle<node> n, handle<node> input);
 		void add_memory_edge(handle<node> n, handle<node> mem_state, handle<node> target);
 
+		// use list manipulation, only valid after use lists have been generated
+		void set_input(handle<node> n, u64 slot, handle<node> input);
+		void replace_uses(handle<node> target, handle<node> replacement);
+		void detach_inputs(handle<node> n);
+		void remove_input(handle<node> n, u64 slot);
+
 		auto get_symbol_address(handle<symbol> target) -> handle<node>;
 
 		// node hierarchy
@@ -113,6 +121,7 @@ namespace sigma::ir {
 		u64 parameter_count = 0;
 		u64 return_count = 0;
 		u64 node_count = 0;
+		u64 symbol_count = 0; // number of symbols created on behalf of the function (ie. strings)
 
 		// list of nodes which are considered parameters
 		// 0 - m_parameter_count             : actual parameters
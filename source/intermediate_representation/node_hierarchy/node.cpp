@@ -156,8 +156,8 @@ namespace sigma::ir {
 
 	auto node::get_next_control() const -> handle<node> {
 		for (auto u = use; u; u = u->next_user) {
-			if (use->target->is_control()) {
-				return use->target;
+			if (u->target->is_control()) {
+				return u->target;
 			}
 		}
 
@@ -177,7 +177,7 @@ namespace sigma::ir {
 			else if (inst == instruction::type::LABEL) {
 				const handle<node> basic_block = inst->get<handle<node>>();
 				const u32 position = static_cast<u32>(bytecode.get_size());
-				const u64 id = context.graph.blocks.at(basic_block).id;
+				const u64 id = context.graph.get_traversal_index(basic_block);
 
 				bytecode.resolve_relocation_dword(&context.labels[id], position);
 			}
@@ -551,7 +551,7 @@ namespace sigma::ir {
 		}
 		else if (r == instruction_operand::type::MEM) {
 			const i32 displacement = r->immediate;
-			const u8 index = r->index;
+			const reg::id_type index = r->index;
 			const u8 base = r->reg;
 			memory_scale s = r->scale;
 
@@ -791,7 +791,7 @@ namespace sigma::ir {
 		}
 		else if (a == instruction_operand::type::MEM) {
 			const u8 base = a->reg;
-			const u8 index = a->index;
+			const reg::id_type index = a->index;
 			memory_scale scale = a->scale;
 			const i32 displacement = a->immediate;
 			const bool needs_index = (index != reg::invalid_id) || (base & 7) == x64::gpr::RSP;
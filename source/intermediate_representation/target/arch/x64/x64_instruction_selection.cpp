@@ -19,12 +19,12 @@ namespace sigma::ir {
 				const handle<node> use_node = use->target;
 
 				if (use_node == node::type::PHI && use_node->dt != data_type::base::MEMORY) {
-					context.virtual_values[use_node->global_value_index] = virtual_value();
+					context.define_virtual_value(use_node);
 					context.work.visit(use_node);
 				}
 			}
 
-			const handle<node> basic_block_end = context.graph.blocks.at(basic_block).end;
+			const handle<node> basic_block_end = context.graph.blocks[i].end;
 
 			if (basic_block_end == node::type::EXIT) {
 				stop_block = i;
@@ -56,14 +56,14 @@ namespace sigma::ir {
 				context.first = context.head = label;
 			}
 
-			const handle<node> block_end = context.graph.blocks.at(basic_block).end;
+			const handle<node> block_end = context.graph.blocks[context.basic_block_order[i]].end;
 			select_instructions_region(context, basic_block, block_end, i);
 		}
 	}
 
 	void x64_architecture::select_instructions_region(codegen_context& context, handle<node> block_entry, handle<node> block_end, u64 rpo_index) {
 		ASSERT(context.work.items.size() == context.graph.blocks.size(), "invalid work list");
-		handle<basic_block> block = context.schedule.at(block_entry);
+		handle<basic_block> block = context.schedule[block_entry->global_value_index];
 
 		// logical schedule
 		dfs_schedule(context, block, block_end, true);
@@ -86,12 +86,12 @@ namespace sigma::ir {
 
 			// track non-dead users
 			for (auto use = block_node->use; use; use = use->next_user) {
-				if (context.schedule.contains(use->target)) {
+				if (context.schedule[use->target->global_value_index]) {
 					use_count++;
 				}
 			}
 
-			context.virtual_values[block_node->global_value_index].use_count = use_count;
+			context.define_virtual_value(block_node)->use_count = use_count;
 		}
 
 		// phi nodes within this block should view themselves as the previous value,
@@ -122,7 +122,7 @@ namespace sigma::ir {
 					reg tmp = allocate_virtual_register(context, nullptr, dt);
 
 					context.append_instruction(create_move(context, dt, tmp, phi.destination));
-					context.virtual_values.at(user_node->global_value_index).virtual_register = tmp;
+					context.lookup_virtual_value(user_node)->virtual_register = tmp;
 				}
 			}
 		}
@@ -247,7 +247,7 @@ namespace sigma::ir {
 				context.append_instruction(create_move(context, dt, phi.destination, src));
 			}
 
-			u64 successor_id = context.graph.blocks.at(successor).id;
+			u64 successor_id = context.graph.get_traversal_index(successor);
 
 			if (context.fallthrough != successor_id) {
 				context.append_instruction(create_jump(context, successor_id));
@@ -310,13 +310,13 @@ namespace sigma::ir {
 							i32 reg_num = is_float ? id : static_cast<i32>(gpr_params[id]);
 							i32 virtual_reg = (is_float ? x64::register_class::FIRST_XMM : 0) + reg_num;
 
-							context.hint_reg(value->virtual_register.id, static_cast<u8>(virtual_reg));
+							context.hint_reg(value->virtual_register.id, static_cast<reg::id_type>(virtual_reg));
 
 							context.append_instruction(create_move(
 								context, 
 								projection->dt, 
 								value->virtual_register,
-								static_cast<u8>(virtual_reg)
+								static_cast<reg::id_type>(virtual_reg)
 							));
 
 							outs[out_count++] = virtual_reg;
@@ -361,7 +361,7 @@ namespace sigma::ir {
 
 					u64 pos = 16 + i * 8;
 
-					context.stack_slots[address] = static_cast<i32>(pos);
+					context.stack_slots[address->global_value_index] = static_cast<i32>(pos);
 
 					if (i >= 4 && context.target.get_abi() == abi::WIN_64) {
 						if (handle<virtual_value> value = context.lookup_virtual_value(store)) {
@@ -588,7 +588,7 @@ namespace sigma::ir {
 					bool use_xmm = dt == data_type::base::FLOAT;
 
 					context.append_instruction(create_move(
-						context, dt, static_cast<u8>(ins[i]), parameter_registers[i]
+						context, dt, static_cast<reg::id_type>(ins[i]), parameter_registers[i]
 					));
 
 					// in win64, float params past the vararg cutoff are duplicated in their
@@ -597,7 +597,7 @@ namespace sigma::ir {
 						u8 phys_reg = descriptor.gpr_registers[i].id;
 
 						context.append_instruction(create_rr(
-							context, instruction::type::MOV_F2I, I64_TYPE, phys_reg, static_cast<u8>(ins[i])
+							context, instruction::type::MOV_F2I, I64_TYPE, phys_reg, static_cast<reg::id_type>(ins[i])
 						));
 
 						ins[in_count++] = x64::register_class::FIRST_GPR + phys_reg;
@@ -1023,7 +1023,7 @@ namespace sigma::ir {
 						// 	has_default = !successor_node->is_unreachable();
 						// }
 
-						successors[index] = context.graph.blocks.at(successor_node).id;
+						successors[index] = context.graph.get_traversal_index(successor_node);
 					}
 				}
 
@@ -1131,7 +1131,7 @@ namespace sigma::ir {
 							n->dt,
 							destination,
 							static_cast<u8>(x64::gpr::RBP),
-							reg::invalid_id, 
+							-1,
 							memory_scale::x1, 
 							16 + index * 8
 						));
@@ -1236,7 +1236,7 @@ namespace sigma::ir {
 		// compute the base
 		if(store_op < 0) {
 			if(has_second_in) {
-				return create_rrm(context, instruction::type::LEA, n->dt, dst, static_cast<u8>(src), base, index, scale, offset);
+				return create_rrm(context, instruction::type::LEA, n->dt, dst, static_cast<reg::id_type>(src), base, index, scale, offset);
 			}
 
 			return create_rm(context, instruction::type::LEA, n->dt, dst, base, index, scale, offset);
@@ -1257,12 +1257,15 @@ namespace sigma::ir {
 	auto x64_architecture::select_array_access_instruction(codegen_context& context, handle<node> n, reg dst, i32 store_op, i32 src) -> handle<instruction> {
 		// compute base
 		if (n == node::type::ARRAY_ACCESS) {
-			if(context.virtual_values.at(n->global_value_index).use_count > 2 || context.virtual_values.at(n->global_value_index).virtual_register.is_valid()) {
+			const handle<virtual_value> value = context.lookup_virtual_value(n);
+			ASSERT(value != nullptr, "missing virtual value");
+
+			if(value->use_count > 2 || value->virtual_register.is_valid()) {
 				const reg base = allocate_node_register(context, n);
 
 				if (store_op < 0) {
 					if (src >= 0) {
-						return create_rrm(context, instruction::type::LEA, PTR_TYPE, dst, static_cast<u8>(src), base, -1, memory_scale::x1, 0);
+						return create_rrm(context, instruction::type::LEA, PTR_TYPE, dst, static_cast<reg::id_type>(src), base, -1, memory_scale::x1, 0);
 					}
 
 					return create_rm(context, instruction::type::LEA, PTR_TYPE, dst, base, -1, memory_scale::x1, 0);
@@ -1369,8 +1372,7 @@ namespace sigma::ir {
 	}
 
 	void x64_architecture::dfs_schedule(codegen_context& context, handle<basic_block> bb, handle<node> n, bool is_end) {
-		const auto it = context.schedule.find(n);
-		if (it == context.schedule.end() || it->second != bb || !context.work.visit(n)) {
+		if (context.schedule[n->global_value_index] != bb || !context.work.visit(n)) {
 			return;
 		}
 
@@ -1394,7 +1396,7 @@ namespace sigma::ir {
 				// find predecessor index and do that edge
 				ptr_diff phi_index = -1;
 				for (u64 j = 0; j < destination->inputs.get_size(); ++j) {
-					if (context.schedule.at(destination->inputs[j]) == bb) {
+					if (context.schedule[destination->inputs[j]->global_value_index] == bb) {
 						phi_index = static_cast<ptr_diff>(j);
 						break;
 					}
@@ -1496,7 +1498,7 @@ namespace sigma::ir {
 		};
 
 		context.intervals.emplace_back(it);
-		ASSERT(index < std::numeric_limits<u8>::max(), "invalid virtual register");
+		ASSERT(index < reg::invalid_id, "invalid virtual register");
 		return { static_cast<reg::id_type>(index)};
 	}
 
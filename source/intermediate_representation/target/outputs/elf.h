@@ -61,6 +61,31 @@ namespace sigma::ir {
 #define ELF64_STB_GLOBAL 1
 #define ELF64_STB_WEAK   2
 
+// P_TYPE
+#define PT_NULL      0          // unused entry
+#define PT_LOAD      1          // loadable segment
+#define PT_DYNAMIC   2          // dynamic linking information
+#define PT_INTERP    3          // path of the program interpreter
+#define PT_GNU_STACK 0x6474e551 // stack executability
+
+// P_FLAGS
+#define PF_X 0x1 // executable
+#define PF_W 0x2 // writable
+#define PF_R 0x4 // readable
+
+// D_TAG
+#define DT_NULL    0  // end of the dynamic section
+#define DT_NEEDED  1  // name of a needed library
+#define DT_HASH    4  // address of the symbol hash table
+#define DT_STRTAB  5  // address of the dynamic string table
+#define DT_SYMTAB  6  // address of the dynamic symbol table
+#define DT_RELA    7  // address of the relocation table
+#define DT_RELASZ  8  // size of the relocation table
+#define DT_RELAENT 9  // size of a relocation entry
+#define DT_STRSZ   10 // size of the dynamic string table
+#define DT_SYMENT  11 // size of a symbol table entry
+#define DT_DEBUG   21 // reserved for the debugger
+
 #define ELF64_ST_INFO(b, t) (((b) << 4) | ((t) & 0xF))
 #define ELF64_R_INFO(s, t) (((u64)(s) << 32ULL) + ((u64)(t) & 0xffffffffULL))
 
@@ -94,6 +119,22 @@ namespace sigma::ir {
 		u64 entsize;
 	};
 
+	struct elf64_p_header {
+		u32 type;
+		u32 flags;
+		u64 offset;
+		u64 vaddr;
+		u64 paddr;
+		u64 filesz;
+		u64 memsz;
+		u64 align;
+	};
+
+	struct elf64_dynamic {
+		i64 tag;
+		u64 value;
+	};
+
 	struct elf64_relocation{
 		u64 offset;
 		u64 info;
@@ -115,6 +156,7 @@ namespace sigma::ir {
 		ELF_X86_64_PC32 = 2,
 		ELF_X86_64_GOT32 = 3,
 		ELF_X86_64_PLT32 = 4,
+		ELF_X86_64_GLOB_DAT = 6,
 		ELF_X86_64_GOTPCREL = 9,
 	};
 
@@ -0,0 +1,409 @@
+#include "elf_executable.h"
+#include "intermediate_representation/module.h"
+
+namespace sigma::ir {
+	namespace detail {
+		// executables are linked at a fixed address (ET_EXEC), and every segment starts on a page
+		// boundary both in the file and in memory, which means that any file offset maps directly
+		// onto a virtual address
+		constexpr u64 base_address = 0x400000;
+		constexpr u64 page_size = 0x1000;
+
+		constexpr u64 program_header_count = 6;
+		constexpr u64 dynamic_entry_count = 11;
+
+		// jmp [rip + got], padded with int3
+		constexpr u64 plt_entry_size = 8;
+
+		constexpr const char* interpreter = "/lib64/ld-linux-x86-64.so.2";
+		constexpr const char* libc = "libc.so.6";
+		constexpr const char* entry_point = "main";
+		constexpr const char* libc_start_main = "__libc_start_main";
+
+		// _start, calls __libc_start_main(main, argc, argv, init, fini, rtld_fini, stack_end), which
+		// initializes libc, calls main and exits with its return value
+		constexpr u8 entry_stub[] = {
+			0x31, 0xed,                               // xor ebp, ebp
+			0x49, 0x89, 0xd1,                         // mov r9, rdx (rtld_fini)
+			0x5e,                                     // pop rsi (argc)
+			0x48, 0x89, 0xe2,                         // mov rdx, rsp (argv)
+			0x48, 0x83, 0xe4, 0xf0,                   // and rsp, -16
+			0x50,                                     // push rax
+			0x54,                                     // push rsp (stack_end)
+			0x45, 0x31, 0xc0,                         // xor r8d, r8d (fini)
+			0x31, 0xc9,                               // xor ecx, ecx (init)
+			0x48, 0x8d, 0x3d, 0x00, 0x00, 0x00, 0x00, // lea rdi, [rip + main]
+			0xff, 0x15, 0x00, 0x00, 0x00, 0x00,       // call [rip + __libc_start_main@GOT]
+			0xf4                                      // hlt
+		};
+
+		// positions of the displacements in the entry stub
+		constexpr u64 entry_stub_main = 23;
+		constexpr u64 entry_stub_libc_start_main = 29;
+
+		enum class segment {
+			READ_ONLY,
+			EXECUTABLE,
+			WRITABLE,
+			THREAD_LOCAL
+		};
+
+		auto get_segment(const module_section& section) -> segment {
+			if(section.flags & module_section::TLS) {
+				return segment::THREAD_LOCAL;
+			}
+
+			if(section.flags & module_section::EXEC) {
+				return segment::EXECUTABLE;
+			}
+
+			if(section.flags & module_section::WRITE) {
+				return segment::WRITABLE;
+			}
+
+			return segment::READ_ONLY;
+		}
+	} // namespace detail
+
+	utility::byte_buffer elf_executable_emitter::emit(module& module) {
+		ASSERT(module.get_target().get_arch() == arch::X64, "unsupported executable architecture");
+
+		collect_imports(module.generate_externals());
+		const module_output& output = module.get_output();
+
+		// relocations in global data which refer to external symbols have to be resolved by the
+		// dynamic loader, everything else is resolved right here
+		u64 data_relocation_count = 0;
+
+		for(const module_section& section : output.sections) {
+			ASSERT(
+				detail::get_segment(section) != detail::segment::THREAD_LOCAL || section.total_size == 0,
+				"thread local storage is not supported in executables"
+			);
+
+			for(const handle<global> global : section.globals) {
+				for(const init_object& object : global->objects) {
+					if(object.type == init_object::RELOCATION && object.relocation->type == symbol::EXTERNAL) {
+						data_relocation_count++;
+					}
+				}
+			}
+		}
+
+		const layout layout = calculate_layout(output, m_imports.size() + data_relocation_count);
+		utility::byte_buffer buffer = utility::byte_buffer::create_zero(layout.data_end);
+		std::vector<elf64_relocation> relocations;
+
+		write_headers(layout, buffer);
+
+		for(u64 i = 0; i < output.sections.size(); ++i) {
+			const module_section& section = output.sections[i];
+
+			if(section.total_size == 0) {
+				continue;
+			}
+
+			helper_write_section(layout.sections[i], &section, static_cast<u32>(layout.sections[i]), buffer);
+
+			// resolve references in code
+			for(const handle<compiled_function>& function : section.functions) {
+				const u64 function_offset = layout.sections[i] + function->code_position;
+
+				for(handle<symbol_patch> patch = function->first_patch; patch; patch = patch->next) {
+					patch_relative(buffer, function_offset + patch->pos, get_symbol_address(layout, patch->target));
+				}
+			}
+
+			// resolve references in data
+			for(const handle<global> global : section.globals) {
+				for(const init_object& object : global->objects) {
+					if(object.type != init_object::RELOCATION) {
+						continue;
+					}
+
+					const u64 offset = layout.sections[i] + global->position + object.offset;
+
+					if(object.relocation->type == symbol::EXTERNAL) {
+						relocations.push_back(elf64_relocation{
+							.offset = get_address(offset),
+							.info = ELF64_R_INFO(object.relocation->id, ELF_X86_64_64),
+							.addend = 0
+						});
+					}
+					else {
+						const u64 address = get_symbol_address(layout, object.relocation);
+						std::memcpy(&buffer[offset], &address, sizeof(u64));
+					}
+				}
+			}
+		}
+
+		// GOT entries are filled in by the dynamic loader at startup
+		for(u64 i = 0; i < m_imports.size(); ++i) {
+			relocations.push_back(elf64_relocation{
+				.offset = get_address(layout.global_offset_table + i * sizeof(u64)),
+				.info = ELF64_R_INFO(i + 1, ELF_X86_64_GLOB_DAT),
+				.addend = 0
+			});
+		}
+
+		ASSERT(relocations.size() == m_imports.size() + data_relocation_count, "invalid relocation count");
+
+		write_dynamic_tables(layout, relocations, buffer);
+		write_entry_stub(layout, output, buffer);
+		write_procedure_linkage_table(layout, buffer);
+
+		return buffer;
+	}
+
+	void elf_executable_emitter::collect_imports(const std::vector<handle<external>>& externals) {
+		std::unordered_map<std::string, u64> indices;
+
+		m_imports.clear();
+		m_dynamic_strings = utility::byte_buffer();
+		m_dynamic_strings.push_back(0); // null string
+
+		m_library_name_position = static_cast<u32>(m_dynamic_strings.get_size());
+		m_dynamic_strings.append_string_nt(detail::libc);
+
+		// returns the dynamic symbol index of the given import
+		const auto add_import = [&](const std::string& name) -> u64 {
+			const auto it = indices.find(name);
+
+			if(it != indices.end()) {
+				return it->second;
+			}
+
+			m_imports.push_back({ name, static_cast<u32>(m_dynamic_strings.get_size()) });
+			m_dynamic_strings.append_string_nt(name);
+
+			indices[name] = m_imports.size();
+			return m_imports.size();
+		};
+
+		// the entry stub hands control over to libc, this import always comes first
+		add_import(detail::libc_start_main);
+
+		for(const handle<external> ex : externals) {
+			ex->symbol.id = add_import(ex->symbol.name);
+		}
+	}
+
+	auto elf_executable_emitter::calculate_layout(const module_output& output, u64 relocation_count) const -> layout {
+		const u64 symbol_count = m_imports.size() + 1; // null symbol
+		layout result;
+
+		result.sections.resize(output.sections.size());
+
+		const auto place_sections = [&](u64 offset, detail::segment segment) {
+			for(u64 i = 0; i < output.sections.size(); ++i) {
+				if(detail::get_segment(output.sections[i]) == segment) {
+					offset = utility::align(offset, 16);
+					result.sections[i] = offset;
+					offset += output.sections[i].total_size;
+				}
+			}
+
+			return offset;
+		};
+
+		// read only segment, starts with the file headers
+		u64 offset = sizeof(elf64_e_header) + detail::program_header_count * sizeof(elf64_p_header);
+
+		result.interpreter = offset;
+		offset += std::strlen(detail::interpreter) + 1;
+
+		// nbucket, nchain, a single bucket and a chain entry for every symbol
+		result.hash = utility::align(offset, 8);
+		offset = result.hash + (3 + symbol_count) * sizeof(u32);
+
+		result.dynamic_symbols = utility::align(offset, 8);
+		offset = result.dynamic_symbols + symbol_count * sizeof(elf64_symbol);
+
+		result.dynamic_strings = offset;
+		offset += m_dynamic_strings.get_size();
+
+		result.relocations = utility::align(offset, 8);
+		offset = result.relocations + relocation_count * sizeof(elf64_relocation);
+
+		result.read_only_end = place_sections(offset, detail::segment::READ_ONLY);
+
+		// executable segment
+		result.code = utility::align(result.read_only_end, detail::page_size);
+		offset = place_sections(result.code, detail::segment::EXECUTABLE);
+
+		result.entry = utility::align(offset, 16);
+		offset = result.entry + sizeof(detail::entry_stub);
+
+		result.procedure_linkage_table = utility::align(offset, 16);
+		result.code_end = result.procedure_linkage_table + m_imports.size() * detail::plt_entry_size;
+
+		// writable segment
+		result.data = utility::align(result.code_end, detail::page_size);
+		offset = place_sections(result.data, detail::segment::WRITABLE);
+
+		result.global_offset_table = utility::align(offset, 8);
+		result.dynamic = result.global_offset_table + m_imports.size() * sizeof(u64);
+		result.data_end = result.dynamic + detail::dynamic_entry_count * sizeof(elf64_dynamic);
+
+		return result;
+	}
+
+	void elf_executable_emitter::write_headers(const layout& layout, utility::byte_buffer& buffer) const {
+		elf64_e_header header = {
+			.type = ET_EXEC,
+			.machine = EM_X86_64,
+			.version = 1,
+			.entry = get_address(layout.entry),
+			.phoff = sizeof(elf64_e_header),
+			.shoff = 0,
+			.flags = 0,
+			.ehsize = sizeof(elf64_e_header),
+			.phentsize = sizeof(elf64_p_header),
+			.phnum = static_cast<u16>(detail::program_header_count),
+			.shentsize = sizeof(elf64_s_header),
+		};
+
+		// setup .ident
+		header.ident[EI_MAG0] = 0x7F;
+		header.ident[EI_MAG1] = 'E';
+		header.ident[EI_MAG2] = 'L';
+		header.ident[EI_MAG3] = 'F';
+		header.ident[EI_CLASS] = 2;
+		header.ident[EI_DATA] = 1;
+		header.ident[EI_VERSION] = 1;
+		header.ident[EI_OSABI] = 0;
+		header.ident[EI_ABIVERSION] = 0;
+
+		const u64 interpreter_size = std::strlen(detail::interpreter) + 1;
+		const u64 code_size = layout.code_end - layout.code;
+		const u64 data_size = layout.data_end - layout.data;
+		const u64 dynamic_size = layout.data_end - layout.dynamic;
+
+		// the interpreter has to precede all loadable segments
+		const elf64_p_header program_headers[] = {
+			{ PT_INTERP,    PF_R,        layout.interpreter, get_address(layout.interpreter), get_address(layout.interpreter), interpreter_size,     interpreter_size,     1                 },
+			{ PT_LOAD,      PF_R,        0,                  get_address(0),                  get_address(0),                  layout.read_only_end, layout.read_only_end, detail::page_size },
+			{ PT_LOAD,      PF_R | PF_X, layout.code,        get_address(layout.code),        get_address(layout.code),        code_size,            code_size,            detail::page_size },
+			{ PT_LOAD,      PF_R | PF_W, layout.data,        get_address(layout.data),        get_address(layout.data),        data_size,            data_size,            detail::page_size },
+			{ PT_DYNAMIC,   PF_R | PF_W, layout.dynamic,     get_address(layout.dynamic),     get_address(layout.dynamic),     dynamic_size,         dynamic_size,         8                 },
+			{ PT_GNU_STACK, PF_R | PF_W, 0,                  0,                               0,                               0,                    0,                    16                }
+		};
+
+		static_assert(sizeof(program_headers) / sizeof(elf64_p_header) == detail::program_header_count);
+
+		std::memcpy(&buffer[0], &header, sizeof(header));
+		std::memcpy(&buffer[sizeof(header)], program_headers, sizeof(program_headers));
+		std::memcpy(&buffer[layout.interpreter], detail::interpreter, interpreter_size);
+	}
+
+	void elf_executable_emitter::write_dynamic_tables(const layout& layout, const std::vector<elf64_relocation>& relocations, utility::byte_buffer& buffer) const {
+		const u64 symbol_count = m_imports.size() + 1;
+
+		// the executable doesn't export anything, so a single empty bucket is enough (chains are
+		// left zeroed)
+		const u32 hash_header[] = { 1, static_cast<u32>(symbol_count), 0 };
+		std::memcpy(&buffer[layout.hash], hash_header, sizeof(hash_header));
+
+		// undefined function symbols, the first entry is the null symbol
+		for(u64 i = 0; i < m_imports.size(); ++i) {
+			const elf64_symbol symbol = {
+				.name = m_imports[i].name_position,
+				.info = static_cast<u8>(ELF64_ST_INFO(ELF64_STB_GLOBAL, ELF64_STT_FUNC))
+			};
+
+			std::memcpy(&buffer[layout.dynamic_symbols + (i + 1) * sizeof(elf64_symbol)], &symbol, sizeof(symbol));
+		}
+
+		std::memcpy(&buffer[layout.dynamic_strings], m_dynamic_strings.get_data(), m_dynamic_strings.get_size());
+		std::memcpy(&buffer[layout.relocations], relocations.data(), relocations.size() * sizeof(elf64_relocation));
+
+		const elf64_dynamic dynamic[] = {
+			{ DT_NEEDED,  m_library_name_position                         },
+			{ DT_HASH,    get_address(layout.hash)                        },
+			{ DT_STRTAB,  get_address(layout.dynamic_strings)             },
+			{ DT_SYMTAB,  get_address(layout.dynamic_symbols)             },
+			{ DT_STRSZ,   m_dynamic_strings.get_size()                    },
+			{ DT_SYMENT,  sizeof(elf64_symbol)                            },
+			{ DT_RELA,    get_address(layout.relocations)                 },
+			{ DT_RELASZ,  relocations.size() * sizeof(elf64_relocation)   },
+			{ DT_RELAENT, sizeof(elf64_relocation)                        },
+			{ DT_DEBUG,   0                                               },
+			{ DT_NULL,    0                                               }
+		};
+
+		static_assert(sizeof(dynamic) / sizeof(elf64_dynamic) == detail::dynamic_entry_count);
+		std::memcpy(&buffer[layout.dynamic], dynamic, sizeof(dynamic));
+	}
+
+	void elf_executable_emitter::write_entry_stub(const layout& layout, const module_output& output, utility::byte_buffer& buffer) const {
+		handle<compiled_function> entry_point = nullptr;
+
+		for(const module_section& section : output.sections) {
+			for(const handle<compiled_function>& function : section.functions) {
+				if(function->parent->symbol.name == detail::entry_point) {
+					entry_point = function;
+				}
+			}
+		}
+
+		ASSERT(entry_point != nullptr, "cannot emit an executable without an entry point ('main')");
+
+		const u64 entry_point_offset = layout.sections[entry_point->parent->parent_section] + entry_point->code_position;
+		std::memcpy(&buffer[layout.entry], detail::entry_stub, sizeof(detail::entry_stub));
+
+		// __libc_start_main is always the first import
+		patch_relative(buffer, layout.entry + detail::entry_stub_main, get_address(entry_point_offset));
+		patch_relative(buffer, layout.entry + detail::entry_stub_libc_start_main, get_address(layout.global_offset_table));
+	}
+
+	void elf_executable_emitter::write_procedure_linkage_table(const layout& layout, utility::byte_buffer& buffer) const {
+		for(u64 i = 0; i < m_imports.size(); ++i) {
+			const u64 entry = layout.procedure_linkage_table + i * detail::plt_entry_size;
+
+			// jmp [rip + got]
+			buffer[entry + 0] = 0xFF;
+			buffer[entry + 1] = 0x25;
+			patch_relative(buffer, entry + 2, get_address(layout.global_offset_table + i * sizeof(u64)));
+
+			// padding
+			buffer[entry + 6] = 0xCC;
+			buffer[entry + 7] = 0xCC;
+		}
+	}
+
+	auto elf_executable_emitter::get_symbol_address(const layout& layout, handle<symbol> target) const -> u64 {
+		switch(target->type) {
+			case symbol::FUNCTION: {
+				const handle<compiled_function> function = &reinterpret_cast<ir::function*>(target.get())->output;
+				return get_address(layout.sections[function->parent->parent_section] + function->code_position);
+			}
+			case symbol::GLOBAL: {
+				const handle<global> global = reinterpret_cast<ir::global*>(target.get());
+				return get_address(layout.sections[global->parent_section] + global->position);
+			}
+			case symbol::EXTERNAL: {
+				// external functions are called through their PLT entry
+				ASSERT(target->id > 0 && target->id <= m_imports.size(), "unknown import");
+				return get_address(layout.procedure_linkage_table + (target->id - 1) * detail::plt_entry_size);
+			}
+			default: {
+				NOT_IMPLEMENTED();
+				return 0;
+			}
+		}
+	}
+
+	auto elf_executable_emitter::get_address(u64 offset) -> u64 {
+		return detail::base_address + offset;
+	}
+
+	void elf_executable_emitter::patch_relative(utility::byte_buffer& buffer, u64 offset, u64 target) {
+		// displacements are relative to the end of the 32-bit field
+		const i64 displacement = static_cast<i64>(target - (get_address(offset) + sizeof(i32)));
+		ASSERT(displacement == static_cast<i32>(displacement), "relative displacement out of range");
+
+		const i32 value = static_cast<i32>(displacement);
+		std::memcpy(&buffer[offset], &value, sizeof(i32));
+	}
+} // namespace sigma::ir
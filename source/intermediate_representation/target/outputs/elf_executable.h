@@ -0,0 +1,67 @@
+#pragma once
+#include "intermediate_representation/target/outputs/elf.h"
+
+namespace sigma::ir {
+	struct module_output;
+	struct external;
+	struct symbol;
+
+	/**
+	 * \brief Links a module into a dynamically linked x64 ELF executable, without going through
+	 * an external linker. References between symbols of the module are resolved directly, calls
+	 * to external functions (libc) go through PLT stubs which jump through GOT entries filled in
+	 * by the dynamic loader.
+	 */
+	class elf_executable_emitter : public object_file_emitter {
+	public:
+		utility::byte_buffer emit(module& module) override;
+	private:
+		struct import {
+			std::string name;
+			u32 name_position;
+		};
+
+		struct layout {
+			// read only segment (headers, dynamic linking tables and read only sections)
+			u64 interpreter;
+			u64 hash;
+			u64 dynamic_symbols;
+			u64 dynamic_strings;
+			u64 relocations;
+			u64 read_only_end;
+
+			// executable segment (code, entry stub and the PLT)
+			u64 code;
+			u64 entry;
+			u64 procedure_linkage_table;
+			u64 code_end;
+
+			// writable segment (data, GOT and the dynamic section)
+			u64 data;
+			u64 global_offset_table;
+			u64 dynamic;
+			u64 data_end;
+
+			// file offsets of individual sections, indexed by the section index
+			std::vector<u64> sections;
+		};
+
+		void collect_imports(const std::vector<handle<external>>& externals);
+		auto calculate_layout(const module_output& output, u64 relocation_count) const -> layout;
+
+		void write_headers(const layout& layout, utility::byte_buffer& buffer) const;
+		void write_dynamic_tables(const layout& layout, const std::vector<elf64_relocation>& relocations, utility::byte_buffer& buffer) const;
+		void write_entry_stub(const layout& layout, const module_output& output, utility::byte_buffer& buffer) const;
+		void write_procedure_linkage_table(const layout& layout, utility::byte_buffer& buffer) const;
+
+		auto get_symbol_address(const layout& layout, handle<symbol> target) const -> u64;
+
+		static auto get_address(u64 offset) -> u64;
+		static void patch_relative(utility::byte_buffer& buffer, u64 offset, u64 target);
+	private:
+		// imported functions, the dynamic symbol index of an import is its index + 1
+		std::vector<import> m_imports;
+		utility::byte_buffer m_dynamic_strings;
+		u32 m_library_name_position = 0;
+	};
+} // namespace sigma::ir
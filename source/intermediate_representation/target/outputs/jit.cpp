@@ -0,0 +1,308 @@
+#include "jit.h"
+#include "intermediate_representation/module.h"
+
+#ifdef SYSTEM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace sigma::ir {
+	namespace detail {
+		// jmp [rip + 0], followed by the absolute address of the external, padded with int3
+		constexpr u8 jit_stub[] = { 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 };
+		constexpr u64 jit_stub_size = 16;
+
+		enum class jit_segment {
+			READ_ONLY,
+			EXECUTABLE,
+			WRITABLE,
+			THREAD_LOCAL
+		};
+
+		auto get_jit_segment(const module_section& section) -> jit_segment {
+			if(section.flags & module_section::TLS) {
+				return jit_segment::THREAD_LOCAL;
+			}
+
+			if(section.flags & module_section::EXEC) {
+				return jit_segment::EXECUTABLE;
+			}
+
+			if(section.flags & module_section::WRITE) {
+				return jit_segment::WRITABLE;
+			}
+
+			return jit_segment::READ_ONLY;
+		}
+	} // namespace detail
+
+	jit::~jit() {
+		release();
+	}
+
+	auto jit::load(module& module) -> std::vector<std::string> {
+		ASSERT(module.get_target().get_arch() == arch::X64, "unsupported jit architecture");
+
+		std::unordered_map<std::string, u64> indices;
+		std::vector<std::string> unresolved;
+
+		release();
+
+		// resolve externals up front, there's no point in mapping anything if some of them are
+		// missing
+		for(const handle<external> ex : module.generate_externals()) {
+			const auto it = indices.find(ex->symbol.name);
+
+			if(it != indices.end()) {
+				ex->symbol.id = it->second;
+				continue;
+			}
+
+			void* address = resolve_external(ex->symbol.name);
+
+			if(address == nullptr) {
+				unresolved.push_back(ex->symbol.name);
+			}
+
+			ex->symbol.id = m_externals.size();
+			indices[ex->symbol.name] = m_externals.size();
+			m_externals.push_back(reinterpret_cast<u64>(address));
+		}
+
+		if(!unresolved.empty()) {
+			return unresolved;
+		}
+
+		const module_output& output = module.get_output();
+		const layout layout = calculate_layout(output);
+
+		// everything is written into a writable mapping first, segments are protected once they
+		// have been linked
+#ifdef SYSTEM_WINDOWS
+		m_memory = static_cast<utility::byte*>(VirtualAlloc(nullptr, layout.size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+		void* memory = mmap(nullptr, layout.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		m_memory = memory == MAP_FAILED ? nullptr : static_cast<utility::byte*>(memory);
+#endif
+
+		ASSERT(m_memory != nullptr, "unable to allocate jit memory");
+		m_size = layout.size;
+
+		const u64 base = reinterpret_cast<u64>(m_memory);
+
+		for(u64 i = 0; i < output.sections.size(); ++i) {
+			const module_section& section = output.sections[i];
+
+			if(section.total_size == 0) {
+				continue;
+			}
+
+			ASSERT(
+				detail::get_jit_segment(section) != detail::jit_segment::THREAD_LOCAL,
+				"thread local storage is not supported by the jit"
+			);
+
+			utility::byte* data = m_memory + layout.sections[i];
+
+			// place functions and resolve references in code
+			for(const handle<compiled_function>& function : section.functions) {
+				std::memcpy(data + function->code_position, function->bytecode.get_data(), function->bytecode.get_size());
+				m_symbols[function->parent->symbol.name] = data + function->code_position;
+
+				for(handle<symbol_patch> patch = function->first_patch; patch; patch = patch->next) {
+					const u64 position = layout.sections[i] + function->code_position + patch->pos;
+
+					// displacements are relative to the end of the 32-bit field
+					const i64 displacement = static_cast<i64>(get_symbol_address(layout, patch->target) - (base + position + sizeof(i32)));
+					ASSERT(displacement == static_cast<i32>(displacement), "relative displacement out of range");
+
+					const i32 value = static_cast<i32>(displacement);
+					std::memcpy(m_memory + position, &value, sizeof(i32));
+				}
+			}
+
+			// place globals and resolve references in data, the mapping is already zeroed
+			for(const handle<global> global : section.globals) {
+				// anonymous globals (ie. string literals) can only be referenced through patches
+				if(!global->symbol.name.empty()) {
+					m_symbols[global->symbol.name] = data + global->position;
+				}
+
+				for(const init_object& object : global->objects) {
+					if(object.type == init_object::REGION) {
+						ASSERT(object.offset + object.region.size <= global->size, "invalid object layout");
+						std::memcpy(data + global->position + object.offset, object.region.ptr, object.region.size);
+					}
+					else if(object.type == init_object::RELOCATION) {
+						// data refers to the external itself, not to its stub
+						const u64 address = object.relocation->type == symbol::EXTERNAL
+							? m_externals[object.relocation->id]
+							: get_symbol_address(layout, object.relocation);
+
+						std::memcpy(data + global->position + object.offset, &address, sizeof(u64));
+					}
+				}
+			}
+		}
+
+		write_stubs(layout);
+
+		protect(layout.code, layout.read_only - layout.code, true, false);
+		protect(layout.read_only, layout.data - layout.read_only, false, false);
+
+		return unresolved;
+	}
+
+	auto jit::get_symbol_address(const std::string& name) const -> void* {
+		const auto it = m_symbols.find(name);
+		return it != m_symbols.end() ? it->second : nullptr;
+	}
+
+	auto jit::run(const std::string& entry_point) const -> i32 {
+		void* address = get_symbol_address(entry_point);
+		ASSERT(address != nullptr, "cannot run a module without an entry point");
+
+		return reinterpret_cast<i32(*)()>(address)();
+	}
+
+	auto jit::calculate_layout(const module_output& output) const -> layout {
+		const u64 page_size = get_page_size();
+		layout result;
+
+		result.sections.resize(output.sections.size());
+
+		const auto place_sections = [&](u64 offset, detail::jit_segment segment) {
+			for(u64 i = 0; i < output.sections.size(); ++i) {
+				if(detail::get_jit_segment(output.sections[i]) == segment) {
+					offset = utility::align(offset, 16);
+					result.sections[i] = offset;
+					offset += output.sections[i].total_size;
+				}
+			}
+
+			return offset;
+		};
+
+		// executable segment, code followed by stubs for all externals
+		result.code = 0;
+		result.stubs = utility::align(place_sections(result.code, detail::jit_segment::EXECUTABLE), 16);
+
+		result.read_only = utility::align(result.stubs + m_externals.size() * detail::jit_stub_size, page_size);
+		result.data = utility::align(place_sections(result.read_only, detail::jit_segment::READ_ONLY), page_size);
+		result.size = utility::align(place_sections(result.data, detail::jit_segment::WRITABLE), page_size);
+
+		// make sure we always map something
+		result.size = std::max(result.size, page_size);
+		return result;
+	}
+
+	auto jit::get_symbol_address(const layout& layout, handle<symbol> target) const -> u64 {
+		const u64 base = reinterpret_cast<u64>(m_memory);
+
+		switch(target->type) {
+			case symbol::FUNCTION: {
+				const handle<compiled_function> function = &reinterpret_cast<ir::function*>(target.get())->output;
+				return base + layout.sections[function->parent->parent_section] + function->code_position;
+			}
+			case symbol::GLOBAL: {
+				const handle<global> global = reinterpret_cast<ir::global*>(target.get());
+				return base + layout.sections[global->parent_section] + global->position;
+			}
+			case symbol::EXTERNAL: {
+				// external functions are called through their stubs
+				ASSERT(target->id < m_externals.size(), "unknown external");
+				return base + layout.stubs + target->id * detail::jit_stub_size;
+			}
+			default: {
+				NOT_IMPLEMENTED();
+				return 0;
+			}
+		}
+	}
+
+	void jit::write_stubs(const layout& layout) const {
+		for(u64 i = 0; i < m_externals.size(); ++i) {
+			utility::byte* stub = m_memory + layout.stubs + i * detail::jit_stub_size;
+
+			std::memset(stub, 0xCC, detail::jit_stub_size);
+			std::memcpy(stub, detail::jit_stub, sizeof(detail::jit_stub));
+			std::memcpy(stub + sizeof(detail::jit_stub), &m_externals[i], sizeof(u64));
+		}
+	}
+
+	void jit::protect(u64 offset, u64 size, bool executable, bool writable) const {
+		if(size == 0) {
+			return;
+		}
+
+#ifdef SYSTEM_WINDOWS
+		DWORD protection = executable ? PAGE_EXECUTE_READ : PAGE_READONLY;
+		DWORD old_protection;
+
+		if(writable) {
+			protection = executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE;
+		}
+
+		const bool result = VirtualProtect(m_memory + offset, size, protection, &old_protection);
+
+		if(executable) {
+			FlushInstructionCache(GetCurrentProcess(), m_memory + offset, size);
+		}
+#else
+		const i32 protection = PROT_READ | (executable ? PROT_EXEC : 0) | (writable ? PROT_WRITE : 0);
+		const bool result = mprotect(m_memory + offset, size, protection) == 0;
+#endif
+
+		ASSERT(result, "unable to protect jit memory");
+	}
+
+	void jit::release() {
+		if(m_memory) {
+#ifdef SYSTEM_WINDOWS
+			VirtualFree(m_memory, 0, MEM_RELEASE);
+#else
+			munmap(m_memory, m_size);
+#endif
+		}
+
+		m_memory = nullptr;
+		m_size = 0;
+
+		m_externals.clear();
+		m_symbols.clear();
+	}
+
+	auto jit::resolve_external(const std::string& name) -> void* {
+#ifdef SYSTEM_WINDOWS
+		// the C runtime isn't necessarily loaded by the host process
+		static const char* libraries[] = { "msvcrt.dll", "kernel32.dll", "ntdll.dll" };
+
+		for(const char* library : libraries) {
+			if(const HMODULE handle = LoadLibraryA(library)) {
+				if(const FARPROC address = GetProcAddress(handle, name.c_str())) {
+					return reinterpret_cast<void*>(address);
+				}
+			}
+		}
+
+		return nullptr;
+#else
+		return dlsym(RTLD_DEFAULT, name.c_str());
+#endif
+	}
+
+	auto jit::get_page_size() -> u64 {
+#ifdef SYSTEM_WINDOWS
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwPageSize;
+#else
+		return static_cast<u64>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+} // namespace sigma::ir
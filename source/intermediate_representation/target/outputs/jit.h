@@ -0,0 +1,80 @@
+#pragma once
+#include <utility/containers/byte_buffer.h>
+#include <utility/handle.h>
+
+namespace sigma::ir {
+	using namespace utility::types;
+
+	struct module_output;
+	struct symbol;
+	class module;
+
+	/**
+	 * \brief Loads a compiled module into executable memory of the current process and links it
+	 * in place, which lets us run it without emitting an object file, linking it and spawning a
+	 * new process. External symbols are resolved against libraries already loaded by the host
+	 * process (libc), calls to them go through absolute jump stubs, since shared libraries are
+	 * usually mapped out of range of a 32-bit displacement.
+	 */
+	class jit {
+	public:
+		jit() = default;
+		~jit();
+
+		jit(const jit&) = delete;
+		jit& operator=(const jit&) = delete;
+
+		/**
+		 * \brief Maps and links \b module, the module has to be compiled for the host system.
+		 * \param module Compiled module to load
+		 * \return Names of external symbols which couldn't be resolved, the module can only be run
+		 * if none are returned.
+		 */
+		auto load(module& module) -> std::vector<std::string>;
+
+		/**
+		 * \brief Looks up the address of a function or a global of the loaded module.
+		 * \param name Name of the symbol to look up
+		 * \return Address of the symbol, nullptr if the module doesn't contain it.
+		 */
+		[[nodiscard]] auto get_symbol_address(const std::string& name) const -> void*;
+
+		/**
+		 * \brief Calls the entry point of the loaded module.
+		 * \param entry_point Name of the entry point, expected to have an 'i32()' signature
+		 * \return Value returned by the entry point.
+		 */
+		auto run(const std::string& entry_point = "main") const -> i32;
+	private:
+		struct layout {
+			// offsets of the individual segments, every segment starts on a page boundary
+			u64 code;
+			u64 stubs;
+			u64 read_only;
+			u64 data;
+			u64 size;
+
+			// offsets of individual sections, indexed by the section index
+			std::vector<u64> sections;
+		};
+
+		auto calculate_layout(const module_output& output) const -> layout;
+		auto get_symbol_address(const layout& layout, handle<symbol> target) const -> u64;
+
+		void write_stubs(const layout& layout) const;
+		void protect(u64 offset, u64 size, bool executable, bool writable) const;
+		void release();
+
+		static auto resolve_external(const std::string& name) -> void*;
+		static auto get_page_size() -> u64;
+	private:
+		utility::byte* m_memory = nullptr;
+		u64 m_size = 0;
+
+		// addresses of externals, indexed by the id of the respective external symbol
+		std::vector<u64> m_externals;
+
+		// addresses of functions and globals defined by the loaded module
+		std::unordered_map<std::string, void*> m_symbols;
+	};
+} // namespace sigma::ir
@@ -1,13 +1,41 @@
 #include "ir_translator.h"
 #include <compiler/compiler/compilation_context.h>
+#include <compiler/compiler/thread_pool.h>
 
 namespace sigma {
-	auto ir_translator::translate(backend_context& context) -> utility::result<void> {
-		return ir_translator(context).translate();
+	auto ir_translator::translate(backend_context& context, thread_pool& pool) -> utility::result<void> {
+		// declare all functions, functions are created in declaration order, which keeps the
+		// layout of the module deterministic
+		context.semantics.reset_active_scope();
+
+		ir_translator declarations(context, context.semantics, context.builder);
+		declarations.translate_declarations();
+
+		// translate function bodies, every body is emitted into its own function using a separate
+		// builder, scopes of the body were already created by the type checker
+		const std::vector<function_task>& functions = declarations.m_functions;
+
+		pool.parallel_for(functions.size(), [&](u64 index) {
+			const function_task& task = functions[index];
+
+			ir::builder builder(context.module);
+			builder.set_insert_point(task.ir_function);
+
+			// the scopes are only traversed, the allocator therefore isn't used
+			semantic_context semantics(context.semantics, task.scope, context.allocator, builder);
+			ir_translator(context, semantics, builder).translate_function_body(task.function);
+		});
+
+		return SUCCESS;
 	}
 
-	ir_translator::ir_translator(backend_context& context) : m_context(context) {
-		m_context.semantics.reset_active_scope();
+	ir_translator::ir_translator(backend_context& context, semantic_context& semantics, ir::builder& builder)
+		: m_context(context), m_semantics(semantics), m_builder(builder) {}
+
+	void ir_translator::translate_declarations() {
+		for(const handle<ast::node>& top_level : m_context.syntax.ast.get_nodes()) {
+			translate_node(top_level);
+		}
 	}
 
 	auto ir_translator::translate_node(handle<ast::node> ast_node) -> handle<ir::node> {
@@ -64,14 +92,21 @@ namespace sigma {
 
 	void ir_translator::translate_function_declaration(handle<ast::node> function_node) {
 		const ast::function& function = function_node->get<ast::function>();
+		const handle<ir::function> ir_function = m_semantics.declare_local_function(function.signature, m_functions.size());
+
+		// the body is translated once all functions have been declared
+		m_semantics.trace_push_scope();
+		m_functions.push_back({ function_node, ir_function, m_semantics.get_active_scope() });
+		m_semantics.trace_pop_scope();
+	}
 
-		m_context.semantics.declare_local_function(function.signature);
-		m_context.semantics.trace_push_scope();
+	void ir_translator::translate_function_body(handle<ast::node> function_node) {
+		const ast::function& function = function_node->get<ast::function>();
 
 		// TODO: handle varargs
 		// declare parameter temporaries
 		for (u64 i = 0; i < function.signature.parameter_types.get_size(); ++i) {
-			const auto variable = m_context.semantics.get_variable(function.signature.parameter_types[i].identifier_key);
+			const auto variable = m_semantics.get_variable(function.signature.parameter_types[i].identifier_key);
 			ASSERT(variable, "function parameter pre declaration is invalid");
 
 			// since we can't update the projection value directly we have to create a proxy for it, this
@@ -81,8 +116,8 @@ namespace sigma {
 			const u16 alignment = parameter_type.get_alignment();
 			const u16 size = parameter_type.get_size();
 
-			variable->value = m_context.builder.create_local(size, alignment);
-			const handle<ir::node> projection = m_context.builder.get_function_parameter(i);
+			variable->value = m_builder.create_local(size, alignment);
+			const handle<ir::node> projection = m_builder.get_function_parameter(i);
 
 			if(parameter_type.is_struct()) {
 				// copy over entire structs
@@ -91,7 +126,7 @@ namespace sigma {
 			else {
 				// copy smaller values over
 				// assign the parameter value to the proxy
-				m_context.builder.create_store(variable->value, projection, alignment, false);
+				m_builder.create_store(variable->value, projection, alignment, false);
 			}
 		}
 
@@ -100,8 +135,7 @@ namespace sigma {
 			translate_node(statement);
 		}
 
-		m_context.semantics.define_implicit_return();
-		m_context.semantics.trace_pop_scope();
+		m_semantics.define_implicit_return();
 	}
 
 	auto ir_translator::translate_variable_declaration(handle<ast::node> variable_node) const -> handle<ir::node>{
@@ -110,25 +144,25 @@ namespace sigma {
 		const u16 alignment = declaration.type.get_alignment();
 		const u16 size = declaration.type.get_size();
 
-		return m_context.semantics.declare_variable(declaration.key, size, alignment);
+		return m_semantics.declare_variable(declaration.key, size, alignment);
 	}
 
 	void ir_translator::translate_namespace_declaration(handle<ast::node> namespace_node) {
-		m_context.semantics.trace_push_scope();
+		m_semantics.trace_push_scope();
 
 		for(const handle<ast::node> statement : namespace_node->children) {
 			translate_node(statement);
 		}
 
-		m_context.semantics.trace_pop_scope();
+		m_semantics.trace_pop_scope();
 	}
 
 	void ir_translator::translate_return(handle<ast::node> return_node) {
 		if (return_node->children.get_size() == 0) {
-			m_context.builder.create_return({}); // TODO: maybe this should return a VOID_TY?
+			m_builder.create_return({}); // TODO: maybe this should return a VOID_TY?
 		}
 		else {
-			m_context.builder.create_return({ translate_node(return_node->children[0]) });
+			m_builder.create_return({ translate_node(return_node->children[0]) });
 		}
 	}
 
@@ -136,30 +170,30 @@ namespace sigma {
 		const ast::type_expression& alignof_value = alignof_node->get<ast::type_expression>();
 		const u16 alignment = alignof_value.type.get_alignment();
 
-		return m_context.builder.create_unsigned_integer(alignment, 64);
+		return m_builder.create_unsigned_integer(alignment, 64);
 	}
 
 	auto ir_translator::translate_sizeof(handle<ast::node> sizeof_node) const -> handle<ir::node> {
 		const ast::type_expression& sizeof_value = sizeof_node->get<ast::type_expression>();
 		const u16 size = sizeof_value.type.get_size();
 
-		return m_context.builder.create_unsigned_integer(size, 64);
+		return m_builder.create_unsigned_integer(size, 64);
 	}
 
 	void ir_translator::translate_conditional_branch(handle<ast::node> branch_node, handle<ir::node> end_control) {
-		const handle<ir::node> true_control = m_context.builder.create_region();
-		end_control = end_control ? end_control : m_context.builder.create_region();
+		const handle<ir::node> true_control = m_builder.create_region();
+		end_control = end_control ? end_control : m_builder.create_region();
 
 		// translate the condition
 		const handle<ir::node> condition = translate_node(branch_node->children[0]);
 
 		// check if there is a successor branch node
 		if (const handle<ast::node> successor = branch_node->children[1]) {
-			const handle<ir::node> false_control = m_context.builder.create_region();
+			const handle<ir::node> false_control = m_builder.create_region();
 
 			// successor node
-			m_context.builder.create_conditional_branch(condition, true_control, false_control);
-			m_context.builder.set_control(false_control);
+			m_builder.create_conditional_branch(condition, true_control, false_control);
+			m_builder.set_control(false_control);
 
 			[[likely]]
 			if (successor->type == ast::node_type::CONDITIONAL_BRANCH) {
@@ -175,41 +209,41 @@ namespace sigma {
 			}
 		}
 		else {
-			m_context.builder.create_conditional_branch(condition, true_control, end_control);
+			m_builder.create_conditional_branch(condition, true_control, end_control);
 		}
 
 		// this all happens if CONDITION IS true
-		m_context.builder.set_control(true_control);
-		m_context.semantics.trace_push_scope();
+		m_builder.set_control(true_control);
+		m_semantics.trace_push_scope();
 
 		for(u64 i = 2; i < branch_node->children.get_size(); ++i) {
 			translate_node(branch_node->children[i]);
 		}
 
-		if(!m_context.semantics.has_return()) {
+		if(!m_semantics.has_return()) {
 			// if we don't have a return statement in this scope, we have to branch back
-			m_context.builder.create_branch(end_control);
+			m_builder.create_branch(end_control);
 		}
 
-		m_context.semantics.trace_pop_scope();
+		m_semantics.trace_pop_scope();
 
 		// restore the control region
-		m_context.builder.set_control(end_control);
+		m_builder.set_control(end_control);
 	}
 
 	void ir_translator::translate_branch(handle<ast::node> branch_node, handle<ir::node> exit_control) {
-		m_context.semantics.trace_push_scope();
+		m_semantics.trace_push_scope();
 
 		for (const handle<ast::node>& statement : branch_node->children) {
 			translate_node(statement);
 		}
 
-		if (!m_context.semantics.has_return()) {
+		if (!m_semantics.has_return()) {
 			// if we don't have a return statement in this scope, we have to branch back
-			m_context.builder.create_branch(exit_control);
+			m_builder.create_branch(exit_control);
 		}
 
-		m_context.semantics.trace_pop_scope();
+		m_semantics.trace_pop_scope();
 	}
 
 	auto ir_translator::translate_numerical_literal(handle<ast::node> numerical_literal_node) const -> handle<ir::node> {
@@ -219,12 +253,12 @@ namespace sigma {
 	auto ir_translator::translate_character_literal(handle<ast::node> character_literal_node) const -> handle<ir::node> {
 		const std::string& value = m_context.syntax.strings.get(character_literal_node->get<ast::named_type_expression>().key);
 		ASSERT(value.size() == 1, "invalid char literal length");
-		return m_context.builder.create_signed_integer(value[0], 32);
+		return m_builder.create_signed_integer(value[0], 32);
 	}
 
 	auto ir_translator::translate_string_literal(handle<ast::node> string_literal_node) const -> handle<ir::node> {
 		const std::string& value = m_context.syntax.strings.get(string_literal_node->get<ast::named_type_expression>().key);
-		return m_context.builder.create_string(value);
+		return m_builder.create_string(value);
 	}
 
 	auto ir_translator::translate_bool_literal(handle<ast::node> bool_literal_node) const -> handle<ir::node> {
@@ -236,7 +270,7 @@ namespace sigma {
 			value = 1;
 		}
 
-		return m_context.builder.create_unsigned_integer(value, 8);
+		return m_builder.create_unsigned_integer(value, 8);
 	}
 
 	auto ir_translator::translate_binary_math_operator(handle<ast::node> operator_node) -> handle<ir::node> {
@@ -244,9 +278,9 @@ namespace sigma {
 		const handle<ir::node> right = translate_node(operator_node->children[1]);
 
 		switch(operator_node->type) {
-			case ast::node_type::OPERATOR_ADD:      return m_context.builder.create_add(left, right);
-			case ast::node_type::OPERATOR_SUBTRACT: return m_context.builder.create_sub(left, right);
-			case ast::node_type::OPERATOR_MULTIPLY: return m_context.builder.create_mul(left, right);
+			case ast::node_type::OPERATOR_ADD:      return m_builder.create_add(left, right);
+			case ast::node_type::OPERATOR_SUBTRACT: return m_builder.create_sub(left, right);
+			case ast::node_type::OPERATOR_MULTIPLY: return m_builder.create_mul(left, right);
 			//case node_type::OPERATOR_DIVIDE:   
 			//case node_type::OPERATOR_MODULO:
 			default: PANIC("unexpected node type '{}' received", operator_node->type.to_string());
@@ -279,10 +313,10 @@ namespace sigma {
 			}
 
 			switch (operator_node->type) {
-				case ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL: return m_context.builder.create_cmp_ige(left, right, is_signed);
-				case ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL:    return m_context.builder.create_cmp_ile(left, right, is_signed);
-				case ast::node_type::OPERATOR_GREATER_THAN:          return m_context.builder.create_cmp_igt(left, right, is_signed);
-				case ast::node_type::OPERATOR_LESS_THAN:             return m_context.builder.create_cmp_ilt(left, right, is_signed);
+				case ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL: return m_builder.create_cmp_ige(left, right, is_signed);
+				case ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL:    return m_builder.create_cmp_ile(left, right, is_signed);
+				case ast::node_type::OPERATOR_GREATER_THAN:          return m_builder.create_cmp_igt(left, right, is_signed);
+				case ast::node_type::OPERATOR_LESS_THAN:             return m_builder.create_cmp_ilt(left, right, is_signed);
 				default: PANIC("unexpected node type '{}' received", operator_node->type.to_string());
 			}
 		}
@@ -295,8 +329,8 @@ namespace sigma {
 		const handle<ir::node> right = translate_node(operator_node->children[1]);
 
 		switch (operator_node->type) {
-			case ast::node_type::OPERATOR_NOT_EQUAL:             return m_context.builder.create_cmp_ne(left, right);
-			case ast::node_type::OPERATOR_EQUAL:                 return m_context.builder.create_cmp_eq(left, right);
+			case ast::node_type::OPERATOR_NOT_EQUAL:             return m_builder.create_cmp_ne(left, right);
+			case ast::node_type::OPERATOR_EQUAL:                 return m_builder.create_cmp_eq(left, right);
 			default: PANIC("unexpected node type '{}' received", operator_node->type.to_string());
 		}
 
@@ -308,8 +342,8 @@ namespace sigma {
 		const handle<ir::node> right = translate_node(operator_node->children[1]);
 
 		switch(operator_node->type) {
-			case ast::node_type::OPERATOR_CONJUNCTION: return m_context.builder.create_and(left, right);
-			case ast::node_type::OPERATOR_DISJUNCTION: return m_context.builder.create_or(left, right);
+			case ast::node_type::OPERATOR_CONJUNCTION: return m_builder.create_and(left, right);
+			case ast::node_type::OPERATOR_DISJUNCTION: return m_builder.create_or(left, right);
 			default: PANIC("unexpected node type '{}' received", operator_node->type.to_string());
 		}
 
@@ -322,7 +356,7 @@ namespace sigma {
 
 		// negate it
 		// NOTE: booleans are 8 bits
-		return m_context.builder.create_cmp_eq(expression, m_context.builder.create_unsigned_integer(0, 8));
+		return m_builder.create_cmp_eq(expression, m_builder.create_unsigned_integer(0, 8));
 	}
 
 	auto ir_translator::translate_cast(handle<ast::node> cast_node) -> handle<ir::node> {
@@ -337,16 +371,16 @@ namespace sigma {
 
 		if(detail::determine_cast_kind(cast.original_type, cast.target_type)) {
 			// truncate the original value
-			return m_context.builder.create_truncate(value_to_cast, target_type);
+			return m_builder.create_truncate(value_to_cast, target_type);
 		}
 
 		if (cast.original_type.is_signed()) {
 			// sign-extend the original value
-			return m_context.builder.create_sxt(value_to_cast, target_type);
+			return m_builder.create_sxt(value_to_cast, target_type);
 		}
 
 		// zero-extend the original value
-		return m_context.builder.create_zxt(value_to_cast, target_type);
+		return m_builder.create_zxt(value_to_cast, target_type);
 	}
 
 	auto ir_translator::translate_function_call(handle<ast::node> call_node) -> handle<ir::node> {
@@ -359,7 +393,7 @@ namespace sigma {
 			parameters.push_back(translate_node(parameter));
 		}
 
-		const handle<ir::node> call_result = m_context.semantics.create_call(
+		const handle<ir::node> call_result = m_semantics.create_call(
 			callee.signature, callee.namespaces, parameters
 		);
 
@@ -380,7 +414,7 @@ namespace sigma {
 		}
 
 		// create the load operation
-		return m_context.builder.create_load(value_to_load, ir_type, alignment, false);
+		return m_builder.create_load(value_to_load, ir_type, alignment, false);
 	}
 
 	auto ir_translator::translate_array_access(handle<ast::node> access_node) -> handle<ir::node> {
@@ -396,7 +430,7 @@ namespace sigma {
 			base->get_type() == ir::node::type::MEMBER_ACCESS
 		) {
 			const ir::data_type type = detail::data_type_to_ir(base_type);
-			base = m_context.builder.create_load(base, type, alignment, false);
+			base = m_builder.create_load(base, type, alignment, false);
 		}
 		else if (base->get_type() == ir::node::type::PROJECTION) { /* does nothing */ }
 		else {
@@ -406,7 +440,7 @@ namespace sigma {
 		// translate the index
 		const handle<ir::node> index = translate_node(access_node->children[1]);
 
-		return m_context.builder.create_array_access(base, index, alignment);
+		return m_builder.create_array_access(base, index, alignment);
 	}
 
 	auto ir_translator::translate_local_member_access(handle<ast::node> access_node) -> handle<ir::node> {
@@ -421,32 +455,37 @@ namespace sigma {
 		const type& base_type = access_node->children[0]->get<ast::named_type_expression>().type;
 		const u16 offset = base_type.get_member_offset(access.key);
 
-		return m_context.builder.create_member_access(base, offset);
+		return m_builder.create_member_access(base, offset);
 	}
 
 	auto ir_translator::translate_variable_access(handle<ast::node> access_node) const -> handle<ir::node> {
 		const auto& accessed_variable = access_node->get<ast::named_type_expression>();
 
 		// just return the variable value, at this point everything was handled by the type checker
-		return m_context.semantics.get_variable(accessed_variable.key)->value;
+		return m_semantics.get_variable(accessed_variable.key)->value;
 	}
 
 	auto ir_translator::translate_store(handle<ast::node> assignment_node) -> handle<ir::node> {
-		const auto& variable = assignment_node->children[0]->get<ast::named_type_expression>();
-		const u16 alignment = variable.type.get_alignment();
+		const handle<ast::node> storage_node = assignment_node->children[0];
+
+		// array accesses only keep the type of the accessed array, all other destinations are named
+		const type storage_type = storage_node->type == ast::node_type::ARRAY_ACCESS ?
+			storage_node->get<ast::type_expression>().type.dereference(1) :
+			storage_node->get<ast::named_type_expression>().type;
+
+		const u16 alignment = storage_type.get_alignment();
 
 		// get the value we want to store
 		const handle<ir::node> value_to_store = translate_node(assignment_node->children[1]);
 
 		// get the storage location
-		const handle<ast::node> storage_node = assignment_node->children[0];
 		const handle<ir::node> storage = translate_node(storage_node);
 
-		if(variable.type.is_struct()) {
-			copy_struct(storage, value_to_store, variable.type);
+		if(storage_type.is_struct()) {
+			copy_struct(storage, value_to_store, storage_type);
 		}
 		else {
-			m_context.builder.create_store(storage, value_to_store, alignment, false);
+			m_builder.create_store(storage, value_to_store, alignment, false);
 		}
 
 		return nullptr;
@@ -463,20 +502,20 @@ namespace sigma {
 		bool overflow; // ignored
 
 		switch (literal.type.get_kind()) {
-			case type::I8:   return m_context.builder.create_signed_integer(utility::from_string<i8>(value, overflow), 8);
-			case type::I16:  return m_context.builder.create_signed_integer(utility::from_string<i16>(value, overflow), 16);
-			case type::I32:  return m_context.builder.create_signed_integer(utility::from_string<i32>(value, overflow), 32);
-			case type::I64:  return m_context.builder.create_signed_integer(utility::from_string<i64>(value, overflow), 64);
-			case type::U8:   return m_context.builder.create_unsigned_integer(utility::from_string<u8>(value, overflow), 8);
-			case type::U16:  return m_context.builder.create_unsigned_integer(utility::from_string<u16>(value, overflow), 16);
-			case type::U32:  return m_context.builder.create_unsigned_integer(utility::from_string<u32>(value, overflow), 32);
-			case type::U64:  return m_context.builder.create_unsigned_integer(utility::from_string<u64>(value, overflow), 64);
+			case type::I8:   return m_builder.create_signed_integer(utility::from_string<i8>(value, overflow), 8);
+			case type::I16:  return m_builder.create_signed_integer(utility::from_string<i16>(value, overflow), 16);
+			case type::I32:  return m_builder.create_signed_integer(utility::from_string<i32>(value, overflow), 32);
+			case type::I64:  return m_builder.create_signed_integer(utility::from_string<i64>(value, overflow), 64);
+			case type::U8:   return m_builder.create_unsigned_integer(utility::from_string<u8>(value, overflow), 8);
+			case type::U16:  return m_builder.create_unsigned_integer(utility::from_string<u16>(value, overflow), 16);
+			case type::U32:  return m_builder.create_unsigned_integer(utility::from_string<u32>(value, overflow), 32);
+			case type::U64:  return m_builder.create_unsigned_integer(utility::from_string<u64>(value, overflow), 64);
 			// for cases when a numerical literal is implicitly converted to a bool (ie. "if(1)")
 			case type::BOOL: {
-				return m_context.builder.create_unsigned_integer(!utility::is_only_char(value, '0'), 8);
+				return m_builder.create_unsigned_integer(!utility::is_only_char(value, '0'), 8);
 			}
 			// for cases when a numerical literal is implicitly converted to a char (ie. "char c = 12")
-			case type::CHAR: return m_context.builder.create_signed_integer(utility::from_string<i32>(value, overflow), 32);
+			case type::CHAR: return m_builder.create_signed_integer(utility::from_string<i32>(value, overflow), 32);
 			default: NOT_IMPLEMENTED();
 		}
 
@@ -497,21 +536,14 @@ namespace sigma {
 			const ir::data_type ir_type = detail::data_type_to_ir(member);
 
 			// access the source value
-			const handle<ir::node> source_access = m_context.builder.create_member_access(value, member_offset);
-			const handle<ir::node> source_load = m_context.builder.create_load(source_access, ir_type, member_alignment, false);
+			const handle<ir::node> source_access = m_builder.create_member_access(value, member_offset);
+			const handle<ir::node> source_load = m_builder.create_load(source_access, ir_type, member_alignment, false);
 
 			// access the member we want to store to
-			const handle<ir::node> dest_access = m_context.builder.create_member_access(destination, member_offset);
+			const handle<ir::node> dest_access = m_builder.create_member_access(destination, member_offset);
 
-			m_context.builder.create_store(dest_access, source_load, member_alignment, false);
+			m_builder.create_store(dest_access, source_load, member_alignment, false);
 		}
 	}
 
-	auto ir_translator::translate() -> utility::result<void> {
-		for (const handle<ast::node>& top_level : m_context.syntax.ast.get_nodes()) {
-			translate_node(top_level);
-		}
-
-		return SUCCESS;
-	}
 } // namespace sigma
@@ -4,13 +4,32 @@
 
 namespace sigma {
 	struct backend_context;
+	struct scope;
+
+	class semantic_context;
+	class thread_pool;
 
 	class ir_translator {
 	public:
-		static auto translate(backend_context& context) -> utility::result<void>;
+		/**
+		 * \brief Translates the type checked AST of \b context into IR. All functions are declared
+		 * first, their bodies are then translated in parallel.
+		 * \param context Backend context to translate
+		 * \param pool Thread pool used for translating function bodies
+		 */
+		static auto translate(backend_context& context, thread_pool& pool) -> utility::result<void>;
 	private:
-		ir_translator(backend_context& context);
-		auto translate() -> utility::result<void>;
+		// function body, which is translated once all functions have been declared
+		struct function_task {
+			handle<ast::node> function;       // function declaration
+			handle<ir::function> ir_function; // declared IR function
+			handle<scope> scope;              // scope containing the function parameters
+		};
+
+		ir_translator(backend_context& context, semantic_context& semantics, ir::builder& builder);
+
+		void translate_declarations();
+		void translate_function_body(handle<ast::node> function_node);
 
 		auto translate_node(handle<ast::node> ast_node) -> handle<ir::node>;
 
@@ -76,5 +95,9 @@ namespace sigma {
 		void copy_struct(handle<ir::node> destination, handle<ir::node> value, const type& struct_type, u16 base_offset = 0) const;
 	private:
 		backend_context& m_context;
+		semantic_context& m_semantics;
+		ir::builder& m_builder;
+
+		std::vector<function_task> m_functions; // function bodies encountered while declaring functions
 	};
 } // namespace sigma
@@ -28,10 +28,105 @@ m_tokens.next();                   \
 EXPECT_CURRENT_TOKEN((__token))
 
 namespace sigma {
-	parser::parser(frontend_context& context) : m_context(context), m_tokens(context.tokens) {}
+	namespace detail {
+		struct binary_operator {
+			u8 precedence = 0; // 0 for tokens which aren't binary operators
+			ast::node_type::underlying type = ast::node_type::UNKNOWN;
+			bool is_comparison = false;
+		};
+
+		constexpr u64 token_type_count = static_cast<u64>(token_type::END_OF_FILE) + 1;
+
+		consteval auto build_binary_operator_table() -> std::array<binary_operator, token_type_count> {
+			std::array<binary_operator, token_type_count> table = {};
+
+			const auto add = [&](token_type token, u8 precedence, ast::node_type::underlying type, bool is_comparison = false) {
+				table[static_cast<u64>(token)] = { precedence, type, is_comparison };
+			};
+
+			// all binary operators are left associative, higher precedence binds tighter
+			add(token_type::CONJUNCTION,           1, ast::node_type::OPERATOR_CONJUNCTION);
+			add(token_type::DISJUNCTION,           2, ast::node_type::OPERATOR_DISJUNCTION);
+
+			add(token_type::GREATER_THAN_OR_EQUAL, 3, ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL, true);
+			add(token_type::LESS_THAN_OR_EQUAL,    3, ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL,    true);
+			add(token_type::GREATER_THAN,          3, ast::node_type::OPERATOR_GREATER_THAN,          true);
+			add(token_type::NOT_EQUALS,            3, ast::node_type::OPERATOR_NOT_EQUAL,             true);
+			add(token_type::LESS_THAN,             3, ast::node_type::OPERATOR_LESS_THAN,             true);
+			add(token_type::EQUALS,                3, ast::node_type::OPERATOR_EQUAL,                 true);
+
+			add(token_type::PLUS_SIGN,             4, ast::node_type::OPERATOR_ADD);
+			add(token_type::MINUS_SIGN,            4, ast::node_type::OPERATOR_SUBTRACT);
+
+			add(token_type::ASTERISK,              5, ast::node_type::OPERATOR_MULTIPLY);
+			add(token_type::SLASH,                 5, ast::node_type::OPERATOR_DIVIDE);
+			add(token_type::MODULO,                5, ast::node_type::OPERATOR_MODULO);
+
+			return table;
+		}
+
+		constexpr std::array<binary_operator, token_type_count> binary_operator_table = build_binary_operator_table();
+
+		auto get_binary_operator(token tok) -> binary_operator {
+			return binary_operator_table[static_cast<u64>(tok.type)];
+		}
+	} // namespace detail
+
+	parser::parser(frontend_context& context, const token_buffer_iterator& tokens)
+		: m_tokens(tokens), m_node_allocator(context.syntax.ast.get_allocator()), m_allocator(context.allocator),
+		m_strings(context.syntax.strings), m_context(&context) {}
+
+	parser::parser(const frontend_context& context, function_body& body)
+		: m_tokens(context.tokens, body.token_index), m_node_allocator(*body.allocator), m_allocator(*body.allocator),
+		m_strings(body.strings), m_body(&body) {}
 
 	auto parser::parse(frontend_context& context) -> utility::result<void> {
-		return parser(context).parse();
+		std::vector<function_body> bodies;
+		const auto result = parse_declarations(context, bodies);
+
+		for(function_body& body : bodies) {
+			parse_function_body(context, body);
+		}
+
+		// recorded bodies precede any error in the declarations
+		TRY(join_function_bodies(context, bodies));
+		return result;
+	}
+
+	auto parser::parse(frontend_context& context, token_stream& stream) -> utility::result<void> {
+		// streamed tokens can't be revisited, function bodies are therefore parsed immediately
+		return parser(context, token_buffer_iterator(stream)).parse();
+	}
+
+	auto parser::parse_declarations(frontend_context& context, std::vector<function_body>& bodies) -> utility::result<void> {
+		parser declaration_parser(context, token_buffer_iterator(context.tokens));
+		declaration_parser.m_skipped_bodies = &bodies;
+
+		return declaration_parser.parse();
+	}
+
+	void parser::parse_function_body(const frontend_context& context, function_body& body) {
+		const auto result = parser(context, body).parse_skipped_body();
+
+		if(result.has_error()) {
+			body.error = result.get_error();
+		}
+	}
+
+	auto parser::join_function_bodies(frontend_context& context, const std::vector<function_body>& bodies) -> utility::result<void> {
+		for(const function_body& body : bodies) {
+			if(body.error.has_value()) {
+				return body.error.value();
+			}
+
+			// string table keys are derived from the contents of the string, keys referenced by the
+			// body therefore stay valid
+			for(const utility::string_table_key key : body.keys) {
+				context.syntax.strings.insert(body.strings.get(key));
+			}
+		}
+
+		return SUCCESS;
 	}
 
 	auto parser::parse() -> utility::result<void> {
@@ -56,15 +151,28 @@ namespace sigma {
 			}
 			else {
 				// parse globals
+				TRY(parse_skipped_bodies());
 				PANIC("globals aren't implemented yet");
 			}
 
-			m_context.syntax.ast.add_node(result);
+			m_context->syntax.ast.add_node(result);
 		}
 
 		return SUCCESS;
 	}
 
+	auto parser::parse_skipped_body() -> utility::result<void> {
+		TRY(const u64 statements, parse_statement_block());
+		const u64 statement_count = m_scratch.size() - statements;
+		ASSERT(statement_count <= std::numeric_limits<u16>::max(), "too many statements");
+
+		const handle<ast::node> function_node = m_body->function;
+		function_node->children = { m_node_allocator, static_cast<u16>(statement_count) };
+		pop_scratch(function_node->children, statements);
+
+		return SUCCESS;
+	}
+
 	auto parser::parse_namespace_declaration() -> parse_result {
 		// expect 'NAMESPACE IDENTIFIER'
 		EXPECT_CURRENT_TOKEN(token_type::NAMESPACE);
@@ -72,16 +180,16 @@ namespace sigma {
 		// parse the namespace identifier
 		EXPECT_NEXT_TOKEN(token_type::IDENTIFIER);
 		const utility::string_table_key identifier = m_tokens.get_current().symbol_key;
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// parse contained functions, namespaces, and globals
 		m_tokens.next(); // prime the left brace
-		TRY(const auto top, parse_namespace_block());
+		TRY(const u64 top, parse_namespace_block());
 
 		// create the namespace node
-		const handle<ast::node> namespace_node = create_namespace(top.size(), location);
+		const handle<ast::node> namespace_node = create_namespace(m_scratch.size() - top, location);
 		namespace_node->get<ast::named_expression>().key = identifier;
-		utility::copy(namespace_node->children, top);
+		pop_scratch(namespace_node->children, top);
 
 		return namespace_node;
 	}
@@ -89,7 +197,7 @@ namespace sigma {
 	auto parser::parse_namespace_block() -> parse_block_result {
 		// expect '{ NAMESPACE | FUNCTION | GLOBAL }'
 		EXPECT_CURRENT_TOKEN(token_type::LEFT_BRACE);
-		std::vector<handle<ast::node>> block;
+		const u64 block = m_scratch.size();
 
 		m_tokens.next();
 		while(m_tokens.get_current_token() != token_type::RIGHT_BRACE) {
@@ -111,10 +219,11 @@ namespace sigma {
 			}
 			else{
 				// parse globals
+				TRY(parse_skipped_bodies());
 				PANIC("globals aren't implemented yet");
 			}
 
-			block.push_back(parsed);
+			m_scratch.push_back(parsed);
 		}
 
 		EXPECT_CURRENT_TOKEN(token_type::RIGHT_BRACE);
@@ -125,7 +234,7 @@ namespace sigma {
 
 	auto parser::parse_function_declaration() -> parse_result {
 		// expect 'TYPE IDENTIFIER ( TYPE IDENTIFIER, ..., TYPE IDENTIFIER )'
-		const handle<token_location> function_location = get_current_location();
+		const token_location function_location = get_current_location();
 		std::vector<named_data_type> parameters;
 
 		// parse the return type
@@ -165,18 +274,26 @@ namespace sigma {
 
 		// parse the function body
 		m_tokens.next(); // prime the first block token
-		TRY(const std::vector<handle<ast::node>> statements, parse_statement_block());
+		const u64 body_index = m_tokens.get_index();
+		u64 statements = m_scratch.size();
 
-		utility::block_allocator& allocator = m_context.syntax.ast.get_allocator();
+		if(m_skipped_bodies) {
+			// we're only parsing declarations, the body will be parsed later
+			EXPECT_CURRENT_TOKEN(token_type::LEFT_BRACE);
+			skip_block();
+		}
+		else {
+			TRY(statements, parse_statement_block());
+		}
 
 		function_signature signature = {
 			.return_type = return_type,
-			.parameter_types = utility::memory_view<named_data_type>(allocator, parameters.size()),
+			.parameter_types = utility::memory_view<named_data_type>(m_node_allocator, parameters.size()),
 			.identifier_key = identifier
 		};
 
 		// create the function node
-		const handle<ast::node> function_node = create_function(statements.size(), function_location);
+		const handle<ast::node> function_node = create_function(m_scratch.size() - statements, function_location);
 
 		// initialize the function signature
 		auto& function = function_node->get<ast::function>();
@@ -185,7 +302,15 @@ namespace sigma {
 		function.signature = signature;
 
 		utility::copy(function.signature.parameter_types, parameters);
-		utility::copy(function_node->children, statements);
+		pop_scratch(function_node->children, statements);
+
+		if(m_skipped_bodies) {
+			m_skipped_bodies->push_back({
+				.function = function_node,
+				.token_index = body_index,
+				.allocator = &m_context->syntax.ast.create_region()
+			});
+		}
 
 		return function_node;
 	}
@@ -195,12 +320,12 @@ namespace sigma {
 		EXPECT_CURRENT_TOKEN(token_type::LEFT_BRACE);
 		m_tokens.next(); // prime the first statement token
 
-		std::vector<handle<ast::node>> statements;
+		const u64 statements = m_scratch.size();
 
 		// parse individual statements 
 		while(m_tokens.get_current_token() != token_type::RIGHT_BRACE) {
 			TRY(handle<ast::node> statement, parse_statement());
-			statements.push_back(statement);
+			m_scratch.push_back(statement);
 		}
 
 		EXPECT_CURRENT_TOKEN(token_type::RIGHT_BRACE);
@@ -251,7 +376,7 @@ namespace sigma {
 	auto parser::parse_return_statement() -> parse_result {
 		// expect 'RET value'
 		EXPECT_CURRENT_TOKEN(token_type::RET);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 		m_tokens.next();
 
 		// allow return statements without any expressions
@@ -285,21 +410,20 @@ namespace sigma {
 			else if(m_tokens.peek_next_token() == token_type::LEFT_BRACE) {
 				// else
 				m_tokens.next(); // prime the left brace
-				TRY(const std::vector<handle<ast::node>> statements, parse_statement_block());
+				TRY(const u64 statements, parse_statement_block());
 
 				// create the final branch node
-				const handle<ast::node> branch_node = create_branch(statements.size());
-				utility::copy(branch_node->children, statements);
+				const handle<ast::node> branch_node = create_branch(m_scratch.size() - statements);
+				pop_scratch(branch_node->children, statements);
 
 				preceding_branch->children[1] = branch_node; // point to the next branch
 				break;
 			}
 			else {
-				const token_info peek = m_tokens.peek_next();
 				return error::emit(
 					error::code::UNEXPECTED_TOKEN,
-					peek.location,
-					peek.tok.to_string()
+					m_tokens.peek_next_location(),
+					m_tokens.peek_next_token().to_string()
 				);
 			}
 		}
@@ -320,17 +444,17 @@ namespace sigma {
 
 		// parse inner statements 
 		m_tokens.next(); // prime the left brace
-		TRY(const std::vector<handle<ast::node>> statements, parse_statement_block());
+		TRY(const u64 statements, parse_statement_block());
 
 		// create the branch node
-		const handle<ast::node> branch_node = create_conditional_branch(statements.size() + 2);
+		const handle<ast::node> branch_node = create_conditional_branch(m_scratch.size() - statements + 2);
 
 		// copy everything over
 		branch_node->children[0] = condition; // condition
 		branch_node->children[1] = nullptr;   // false condition target
 
 		// inner statements
-		utility::copy(branch_node->children, 2, statements);
+		pop_scratch(branch_node->children, statements, 2);
 
 		return branch_node;
 	}
@@ -380,7 +504,7 @@ namespace sigma {
 	auto parser::parse_local_member_access() -> parse_result {
 		// expect '.IDENTIFIER'
 		EXPECT_CURRENT_TOKEN(token_type::DOT);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		EXPECT_NEXT_TOKEN(token_type::IDENTIFIER);
 		const utility::string_table_key identifier = m_tokens.get_current().symbol_key;
@@ -394,14 +518,14 @@ namespace sigma {
 
 	auto parser::parse_negative_expression() -> parse_result {
 		EXPECT_CURRENT_TOKEN(token_type::MINUS_SIGN);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 		m_tokens.next(); // prime the first expression token
 
 		TRY(const handle<ast::node> expression_node, parse_expression());
 		const handle<ast::node> negation_node = create_numerical_literal(location);
 
 		ast::named_type_expression& literal = negation_node->get<ast::named_type_expression>();
-		literal.key = m_context.syntax.strings.insert("-1");
+		literal.key = insert_string("-1");
 		literal.type = type::create_i32();
 
 		// negate the expression
@@ -412,9 +536,9 @@ namespace sigma {
 		// expect 'IDENTIFIER ( PARAMETER, ... , PARAMETER )'
 		EXPECT_CURRENT_TOKEN(token_type::IDENTIFIER);
 
-		const handle<token_location> call_location = get_current_location();
+		const token_location call_location = get_current_location();
 		const utility::string_table_key identifier_key = m_tokens.get_current().symbol_key;
-		std::vector<handle<ast::node>> parameters;
+		const u64 parameters = m_scratch.size();
 
 		EXPECT_NEXT_TOKEN(token_type::LEFT_PARENTHESIS);
 		m_tokens.next();
@@ -423,7 +547,7 @@ namespace sigma {
 		if(m_tokens.get_current_token() != token_type::RIGHT_PARENTHESIS) {
 			while(true) {
 				TRY(handle<ast::node> expression_node, parse_expression());
-				parameters.push_back(expression_node);
+				m_scratch.push_back(expression_node);
 
 				if(m_tokens.get_current_token() == token_type::RIGHT_PARENTHESIS) {
 					break; // end of parameter list
@@ -437,10 +561,10 @@ namespace sigma {
 		EXPECT_CURRENT_TOKEN(token_type::RIGHT_PARENTHESIS);
 
 		// create the callee
-		const handle<ast::node> call_node = create_function_call(parameters.size(), call_location);
+		const handle<ast::node> call_node = create_function_call(m_scratch.size() - parameters, call_location);
 
 		// copy over function parameters
-		utility::copy(call_node->children, parameters);
+		pop_scratch(call_node->children, parameters);
 
 		// initialize the callee
 		ast::function_call& function = call_node->get<ast::function_call>();
@@ -453,7 +577,7 @@ namespace sigma {
 
 	auto parser::parse_variable_declaration() -> parse_result {
 		// expect 'TYPE IDENTIFIER'
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// parse the variable type
 		TRY(const type type, parse_type());
@@ -500,7 +624,7 @@ namespace sigma {
 	auto parser::parse_variable_access() -> parse_result {
 		// expect 'IDENTIFIER'
 		EXPECT_CURRENT_TOKEN(token_type::IDENTIFIER);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// create the access node
 		const handle<ast::node> variable_node = create_variable_access(location);
@@ -517,7 +641,7 @@ namespace sigma {
 		// parses an array index access
 		// expect '[index]'
 		EXPECT_CURRENT_TOKEN(token_type::LEFT_BRACKET);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		m_tokens.next(); // prime the first expression token
 		TRY(const handle<ast::node> index, parse_expression());
@@ -535,7 +659,7 @@ namespace sigma {
 	auto parser::parse_sizeof() -> parse_result {
 		// expect 'SIZEOF ( type )'
 		EXPECT_CURRENT_TOKEN(token_type::SIZEOF);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		EXPECT_NEXT_TOKEN(token_type::LEFT_PARENTHESIS);
 
@@ -557,7 +681,7 @@ namespace sigma {
 		// expect '= expression'
 		EXPECT_CURRENT_TOKEN(token_type::EQUALS_SIGN);
 
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 		m_tokens.next(); 
 
 		// create the assignment node
@@ -572,7 +696,7 @@ namespace sigma {
 	auto parser::parse_logical_not_expression() -> parse_result {
 		// expect '! IDENTIFIER_STATEMENT'
 		EXPECT_CURRENT_TOKEN(token_type::EXCLAMATION_MARK);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		m_tokens.next(); // prime the expression token
 
@@ -591,118 +715,36 @@ namespace sigma {
 	}
 
 	auto parser::parse_expression() -> parse_result {
-		return parse_logical_conjunction();
-	}
-
-	auto parser::parse_logical_conjunction() -> parse_result {
-		TRY(handle<ast::node> left_node, parse_logical_disjunction());
-
-		while(m_tokens.get_current_token() == token_type::CONJUNCTION) {
-			m_tokens.next(); // prime the term
-			TRY(const handle<ast::node> right_node, parse_logical_disjunction());
-
-			left_node = create_binary_operation(ast::node_type::OPERATOR_CONJUNCTION, left_node, right_node);
-		}
-
-		return left_node;
+		TRY(const handle<ast::node> left_node, parse_primary());
+		return parse_binary_expression(left_node, 1);
 	}
 
-	auto parser::parse_logical_disjunction() -> parse_result {
-		TRY(handle<ast::node> left_node, parse_comparison());
+	auto parser::parse_binary_expression(handle<ast::node> left_node, u8 min_precedence) -> parse_result {
+		// precedence climbing, we only recurse when the precedence of the next operator is higher
+		// than the precedence of the current one, the depth is therefore bounded by the number
+		// of precedence levels, and not by the length of the expression
+		detail::binary_operator operation = detail::get_binary_operator(m_tokens.get_current_token());
 
-		while(m_tokens.get_current_token() == token_type::DISJUNCTION) {
-			m_tokens.next(); // prime the term
-			TRY(const handle<ast::node> right_node, parse_comparison());
+		while(operation.precedence >= min_precedence) {
+			m_tokens.next(); // prime the right operand
+			TRY(handle<ast::node> right_node, parse_primary());
 
-			left_node = create_binary_operation(ast::node_type::OPERATOR_DISJUNCTION, left_node, right_node);
-		}
+			detail::binary_operator next = detail::get_binary_operator(m_tokens.get_current_token());
 
-		return left_node;
-	}
-
-	auto parser::parse_comparison() -> parse_result {
-		TRY(handle<ast::node> left_node, parse_term());
-		token operation = m_tokens.get_current_token();
-
-		while (
-			operation == token_type::GREATER_THAN_OR_EQUAL ||
-			operation == token_type::LESS_THAN_OR_EQUAL ||
-			operation == token_type::GREATER_THAN ||
-			operation == token_type::NOT_EQUALS ||
-			operation == token_type::LESS_THAN ||
-			operation == token_type::EQUALS
-		) {
-			m_tokens.next(); // prime the comparison
-
-			TRY(const handle<ast::node> right_node, parse_term());
-			ast::node_type operator_type = ast::node_type::UNKNOWN;
-
-			switch (operation) {
-				case token_type::GREATER_THAN_OR_EQUAL:  operator_type = ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL; break;
-				case token_type::LESS_THAN_OR_EQUAL:     operator_type = ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL; break;
-				case token_type::GREATER_THAN:           operator_type = ast::node_type::OPERATOR_GREATER_THAN; break;
-				case token_type::NOT_EQUALS:             operator_type = ast::node_type::OPERATOR_NOT_EQUAL; break;
-				case token_type::LESS_THAN:              operator_type = ast::node_type::OPERATOR_LESS_THAN; break;
-				case token_type::EQUALS:                 operator_type = ast::node_type::OPERATOR_EQUAL; break;
-				default: PANIC("unhandled term case for token '{}'", operation.to_string());
+			// operators which bind tighter than the current one take the right operand
+			while(next.precedence > operation.precedence) {
+				TRY(right_node, parse_binary_expression(right_node, operation.precedence + 1));
+				next = detail::get_binary_operator(m_tokens.get_current_token());
 			}
 
-			left_node = create_comparison_operation(operator_type, left_node, right_node);
-			operation = m_tokens.get_current_token();
-		}
-
-		return left_node;
-	}
-
-	auto parser::parse_term() -> parse_result {
-		TRY(handle<ast::node> left_node, parse_factor());
-		token operation = m_tokens.get_current_token();
-
-		while (
-			operation == token_type::PLUS_SIGN ||
-			operation == token_type::MINUS_SIGN
-		) {
-			m_tokens.next(); // prime the term
-
-			TRY(const handle<ast::node> right_node, parse_factor());
-			ast::node_type operator_type = ast::node_type::UNKNOWN;
-
-			switch (operation) {
-				case token_type::PLUS_SIGN:  operator_type = ast::node_type::OPERATOR_ADD; break;
-				case token_type::MINUS_SIGN: operator_type = ast::node_type::OPERATOR_SUBTRACT; break;
-				default: PANIC("unhandled term case for token '{}'", operation.to_string());
+			if(operation.is_comparison) {
+				left_node = create_comparison_operation(operation.type, left_node, right_node);
 			}
-
-			left_node = create_binary_operation(operator_type, left_node, right_node);
-			operation = m_tokens.get_current_token();
-		}
-
-		return left_node;
-	}
-
-	auto parser::parse_factor() -> parse_result {
-		TRY(handle<ast::node> left_node, parse_primary());
-		token operation = m_tokens.get_current_token();
-
-		while (
-			operation == token_type::ASTERISK ||
-			operation == token_type::SLASH ||
-			operation == token_type::MODULO
-		) {
-			m_tokens.next(); // prime the primary
-
-			TRY(const handle<ast::node> right_node, parse_primary());
-			ast::node_type operator_type = ast::node_type::UNKNOWN;
-
-			switch (operation) {
-				case token_type::ASTERISK: operator_type = ast::node_type::OPERATOR_MULTIPLY; break;
-				case token_type::SLASH:    operator_type = ast::node_type::OPERATOR_DIVIDE; break;
-				case token_type::MODULO:   operator_type = ast::node_type::OPERATOR_MODULO; break;
-				default: PANIC("unhandled factor case for token '{}'", operation.to_string());
+			else {
+				left_node = create_binary_operation(operation.type, left_node, right_node);
 			}
 
-			left_node = create_binary_operation(operator_type, left_node, right_node);
-			operation = m_tokens.get_current_token();
+			operation = next;
 		}
 
 		return left_node;
@@ -748,7 +790,7 @@ namespace sigma {
 	auto parser::parse_explicit_cast() -> parse_result {
 		// expect 'CAST < TYPE >'
 		EXPECT_CURRENT_TOKEN(token_type::CAST);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		EXPECT_NEXT_TOKEN(token_type::LESS_THAN);
 
@@ -808,7 +850,7 @@ namespace sigma {
 	auto parser::parse_numerical_literal() -> parse_result {
 		// expect 'NUMERICAL_LITERAL'
 		const token literal_token = m_tokens.get_current_token();
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		if(!literal_token.is_numerical_literal()) {
 			return error::emit(
@@ -847,7 +889,7 @@ namespace sigma {
 	auto parser::parse_character_literal() -> parse_result {
 		// expect 'CHARACTER_LITERAL'
 		EXPECT_CURRENT_TOKEN(token_type::CHARACTER_LITERAL);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// create the string node
 		const handle<ast::node> char_node = create_character_literal(location);
@@ -864,7 +906,7 @@ namespace sigma {
 	auto parser::parse_string_literal() -> parse_result {
 		// expect 'STRING_LITERAL'
 		EXPECT_CURRENT_TOKEN(token_type::STRING_LITERAL);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// create the string node
 		const handle<ast::node> string_node = create_string_literal(location);
@@ -880,7 +922,7 @@ namespace sigma {
 
 	auto parser::parse_bool_literal() -> parse_result {
 		// expect 'BOOL_LITERAL_TRUE | BOOL_LITERAL_FALSE'
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		ASSERT(
 			m_tokens.get_current_token() == token_type::BOOL_LITERAL_FALSE ||
@@ -901,7 +943,7 @@ namespace sigma {
 
 	auto parser::parse_null_literal() -> parse_result {
 		// expect 'NULL_LITERAL'
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 		EXPECT_CURRENT_TOKEN(token_type::NULL_LITERAL);
 
 		// create the null literal node
@@ -923,10 +965,65 @@ namespace sigma {
 		return token == token_type::IDENTIFIER || token.is_type();
 	}
 
-	auto parser::get_current_location() const -> handle<token_location> {
+	auto parser::get_current_location() const -> token_location {
 		return m_tokens.get_current_token_location();
 	}
 
+	auto parser::insert_string(const std::string& value) -> utility::string_table_key {
+		const utility::string_table_key key = m_strings.insert(value);
+
+		// strings synthesized while parsing a skipped body are merged into the context later
+		if(m_body) {
+			m_body->keys.push_back(key);
+		}
+
+		return key;
+	}
+
+	auto parser::parse_skipped_bodies() const -> utility::result<void> {
+		if(m_skipped_bodies == nullptr) {
+			return SUCCESS;
+		}
+
+		// errors in bodies we've skipped precede the current token, report them before we bail
+		for(function_body& body : *m_skipped_bodies) {
+			parse_function_body(*m_context, body);
+
+			if(body.error.has_value()) {
+				return body.error.value();
+			}
+		}
+
+		return SUCCESS;
+	}
+
+	void parser::pop_scratch(utility::memory_view<handle<ast::node>, u16>& children, u64 first, u16 offset) {
+		// move the nodes on top of the scratch stack into the child list
+		for(u64 i = first; i < m_scratch.size(); ++i) {
+			children[static_cast<u16>(offset + i - first)] = m_scratch[i];
+		}
+
+		m_scratch.resize(first);
+	}
+
+	void parser::skip_block() {
+		// expect '{ ... }', skips past the matching brace, unbalanced blocks are skipped until the
+		// end of the file, the error is reported once the block itself is parsed
+		u64 depth = 0;
+
+		while(m_tokens.get_current_token() != token_type::END_OF_FILE) {
+			const token current = m_tokens.get_current_token();
+			m_tokens.next();
+
+			if(current == token_type::LEFT_BRACE) {
+				depth++;
+			}
+			else if(current == token_type::RIGHT_BRACE && --depth == 0) {
+				return;
+			}
+		}
+	}
+
 	auto parser::parse_namespaces() -> utility::result<namespace_list> {
 		// parses a set of contiguous namespace directives
 		// expect 'NAMESPACE :: ... NAMESPACE ::'
@@ -944,7 +1041,7 @@ namespace sigma {
 			m_tokens.next(); // prime the next token
 		}
 
-		utility::memory_view<utility::string_table_key> list(m_context.allocator, namespaces.size());
+		utility::memory_view<utility::string_table_key> list(m_allocator, namespaces.size());
 		utility::copy(list, namespaces);
 
 		return { list };
@@ -989,7 +1086,7 @@ namespace sigma {
 	auto parser::parse_alignof() -> parse_result {
 		// expect 'ALIGNOF ( type )'
 		EXPECT_CURRENT_TOKEN(token_type::ALIGNOF);
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		EXPECT_NEXT_TOKEN(token_type::LEFT_PARENTHESIS);
 
@@ -1056,51 +1153,51 @@ namespace sigma {
 		return res;
 	}
 
-	auto parser::create_local_member_access(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_local_member_access(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::LOCAL_MEMBER_ACCESS, 1, location);
 	}
 
-	auto parser::create_numerical_literal(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_numerical_literal(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::NUMERICAL_LITERAL, 0, location);
 	}
 
-	auto parser::create_character_literal(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_character_literal(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::CHARACTER_LITERAL, 0, location);
 	}
 
-	auto parser::create_variable_access(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_variable_access(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::VARIABLE_ACCESS, 0, location);
 	}
 
-	auto parser::create_string_literal(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_string_literal(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::STRING_LITERAL, 0, location);
 	}
 
-	auto parser::create_bool_literal(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_bool_literal(token_location location) const -> handle<ast::node> {
 		return create_node<ast::bool_literal>(ast::node_type::BOOL_LITERAL, 0, location);
 	}
 
-	auto parser::create_null_literal(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_null_literal(token_location location) const -> handle<ast::node> {
 		return create_node<utility::empty_property>(ast::node_type::NULL_LITERAL, 0, location);
 	}
 
-	auto parser::create_assignment(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_assignment(token_location location) const -> handle<ast::node> {
 		return create_node<utility::empty_property>(ast::node_type::STORE, 2, location);
 	}
 
-	auto parser::create_sizeof(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_sizeof(token_location location) const -> handle<ast::node> {
 		return create_node<ast::type_expression>(ast::node_type::SIZEOF, 0, location);
 	}
 
-	auto parser::create_alignof(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_alignof(token_location location) const -> handle<ast::node> {
 		return create_node<ast::type_expression>(ast::node_type::ALIGNOF, 0, location);
 	}
 
-	auto parser::create_cast(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_cast(token_location location) const -> handle<ast::node> {
 		return create_node<ast::cast>(ast::node_type::CAST, 1, location);
 	}
 
-	auto parser::create_logical_not(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_logical_not(token_location location) const -> handle<ast::node> {
 		return create_node(ast::node_type::OPERATOR_LOGICAL_NOT, 1, location);
 	}
 
@@ -1112,40 +1209,40 @@ namespace sigma {
 		return node;
   }
 
-	auto parser::create_variable_declaration(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_variable_declaration(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::VARIABLE_DECLARATION, child_count, location);
 	}
 
-	auto parser::create_function_call(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_function_call(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node<ast::function_call>(ast::node_type::FUNCTION_CALL, child_count, location);
 	}
 
-	auto parser::create_array_access(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_array_access(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node<ast::type_expression>(ast::node_type::ARRAY_ACCESS, child_count, location);
 	}
 
-	auto parser::create_namespace(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_namespace(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_expression>(ast::node_type::NAMESPACE_DECLARATION, child_count, location);
 	}
 
-	auto parser::create_function(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_function(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node<ast::function>(ast::node_type::FUNCTION_DECLARATION, child_count, location);
 	}
 
-	auto parser::create_return(u64 child_count, handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_return(u64 child_count, token_location location) const -> handle<ast::node> {
 		return create_node(ast::node_type::RETURN, child_count, location);
 	}
 
 	auto parser::create_branch(u64 child_count) const -> handle<ast::node> {
-		return create_node(ast::node_type::BRANCH, child_count, nullptr);
+		return create_node(ast::node_type::BRANCH, child_count, {});
 	}
 
-	auto parser::create_struct_declaration(handle<token_location> location) const -> handle<ast::node> {
+	auto parser::create_struct_declaration(token_location location) const -> handle<ast::node> {
 		return create_node<ast::named_type_expression>(ast::node_type::STRUCT_DECLARATION, 0, location);
 	}
 
 	auto parser::create_conditional_branch(u64 child_count) const -> handle<ast::node> {
-		return create_node(ast::node_type::CONDITIONAL_BRANCH, child_count, nullptr);
+		return create_node(ast::node_type::CONDITIONAL_BRANCH, child_count, {});
 	}
 
 	auto parser::create_binary_operation(ast::node_type type, handle<ast::node> left, handle<ast::node> right) const -> handle<ast::node> {
@@ -1167,7 +1264,7 @@ namespace sigma {
 			return parse_function_call(namespaces);
 		}
 
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 		const handle<ast::node> load_node = create_node<ast::type_expression>(ast::node_type::LOAD, 1, location);
 
 		// parse a variable value
@@ -1198,7 +1295,7 @@ namespace sigma {
 
 	auto parser::parse_struct_declaration() -> parse_result {
 		// expect 'STRUCT IDENTIFIER { TYPE IDENTIFIER ... TYPE IDENTIFIER }
-		const handle<token_location> location = get_current_location();
+		const token_location location = get_current_location();
 
 		// parse the struct header
 		EXPECT_CURRENT_TOKEN(token_type::STRUCT);
@@ -1229,7 +1326,7 @@ namespace sigma {
 		const handle<ast::node> struct_node = create_struct_declaration(location);
 
 		ASSERT(members.size() < std::numeric_limits<u8>::max(), "too many members");
-		utility::memory_view<type, u8> member_slice(m_context.allocator, static_cast<u8>(members.size()));
+		utility::memory_view<type, u8> member_slice(m_allocator, static_cast<u8>(members.size()));
 		utility::copy(member_slice, members);
 
 		auto& expression = struct_node->get<ast::named_type_expression>();
@@ -19,15 +19,71 @@ namespace sigma {
 
 	struct frontend_context;
 
+	/**
+	 * \brief Function body skipped by parser::parse_declarations. Bodies don't depend on each
+	 * other, and can therefore be parsed in any order, or in parallel.
+	 */
+	struct function_body {
+		handle<ast::node> function;                   // function declaration which receives the statements
+		u64 token_index = 0;                          // index of the opening brace
+		handle<utility::block_allocator> allocator;   // AST region the body is allocated from
+
+		utility::string_table strings;                // strings synthesized while parsing the body
+		std::vector<utility::string_table_key> keys;  // keys of synthesized strings
+		std::optional<utility::error> error;
+	};
+
 	class parser {
 	public:
+		/**
+		 * \brief Parses the entire token buffer of \b context on the current thread.
+		 * \param context Frontend context which receives the AST
+		 */
 		[[nodiscard]] static auto parse(frontend_context& context) -> utility::result<void>;
+
+		/**
+		 * \brief Parses all declarations in \b context, function bodies are skipped by brace
+		 * matching and have to be parsed using parse_function_body. Bodies are recorded in source
+		 * order, even if an error is encountered, in which case they precede the error.
+		 * \param context Frontend context which receives the AST
+		 * \param bodies Receives the skipped function bodies
+		 */
+		[[nodiscard]] static auto parse_declarations(frontend_context& context, std::vector<function_body>& bodies) -> utility::result<void>;
+
+		/**
+		 * \brief Parses a function body skipped by parse_declarations, errors are stored in the body.
+		 * Different bodies of the same context can be parsed in parallel.
+		 * \param context Frontend context the body belongs to
+		 * \param body Body to parse
+		 */
+		static void parse_function_body(const frontend_context& context, function_body& body);
+
+		/**
+		 * \brief Merges parsed function bodies into \b context, has to be invoked after all bodies
+		 * have been parsed.
+		 * \param context Frontend context the bodies belong to
+		 * \param bodies Parsed function bodies
+		 * \return First error encountered in the bodies, in source order.
+		 */
+		[[nodiscard]] static auto join_function_bodies(frontend_context& context, const std::vector<function_body>& bodies) -> utility::result<void>;
+
+		/**
+		 * \brief Parses tokens pulled from \b stream, which is filled by a tokenizer running on
+		 * another thread. Tokens aren't stored in \b context.
+		 * \param context Frontend context which receives the AST
+		 * \param stream Stream to parse
+		 */
+		[[nodiscard]] static auto parse(frontend_context& context, token_stream& stream) -> utility::result<void>;
 	private:
 		using parse_result = utility::result<handle<ast::node>>;
-		using parse_block_result = utility::result<std::vector<handle<ast::node>>>;
+		// index of the first node of the parsed block in the scratch stack
+		using parse_block_result = utility::result<u64>;
+
+		parser(frontend_context& context, const token_buffer_iterator& tokens);
+		parser(const frontend_context& context, function_body& body);
 
-		parser(frontend_context& context);
 		[[nodiscard]] auto parse() -> utility::result<void>;
+		[[nodiscard]] auto parse_skipped_body() -> utility::result<void>;
 
 		// declaration
 		auto parse_namespace_declaration() -> parse_result;
@@ -48,16 +104,12 @@ namespace sigma {
 		auto parse_null_literal() -> parse_result;
 
 		// expressions
+		auto parse_binary_expression(handle<ast::node> left_node, u8 min_precedence) -> parse_result;
 		auto parse_identifier_expression() -> parse_result;
-		auto parse_logical_conjunction() -> parse_result;
-		auto parse_logical_disjunction() -> parse_result;
 		auto parse_negative_expression() -> parse_result;
 		auto parse_logical_not_expression() -> parse_result;
 		auto parse_expression() -> parse_result;
-		auto parse_comparison() -> parse_result;
 		auto parse_primary() -> parse_result;
-		auto parse_factor() -> parse_result;
-		auto parse_term() -> parse_result;
 
 		// statements
 		auto parse_identifier_statement() -> parse_result;
@@ -90,33 +142,44 @@ namespace sigma {
 
 		// utility
 		auto is_current_token_type() const -> bool;
-		auto get_current_location() const -> handle<token_location>;
+		auto get_current_location() const -> token_location;
+		auto insert_string(const std::string& value) -> utility::string_table_key;
+		auto parse_skipped_bodies() const -> utility::result<void>;
+		void skip_block();
+
+		/**
+		 * \brief Moves the nodes on top of the scratch stack into a child list.
+		 * \param children Child list to move the nodes into
+		 * \param first Index of the first node to move, everything above it is moved as well
+		 * \param offset Index of the first child to write to
+		 */
+		void pop_scratch(utility::memory_view<handle<ast::node>, u16>& children, u64 first, u16 offset = 0);
 
 		template<typename extra_type = utility::empty_property>
-		auto create_node(ast::node_type type, u64 child_count, handle<token_location> location) const -> handle<ast::node> {
-			return m_context.syntax.ast.create_node<extra_type>(type, child_count, location);
+		auto create_node(ast::node_type type, u64 child_count, token_location location) const -> handle<ast::node> {
+			return ast::tree::create_node<extra_type>(m_node_allocator, type, child_count, location);
 		}
 
-		auto create_variable_declaration(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-		auto create_function_call(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-		auto create_array_access(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-		auto create_namespace(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-		auto create_function(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-		auto create_return(u64 child_count, handle<token_location> location) const -> handle<ast::node>;
-
-		auto create_local_member_access(handle<token_location> location) const -> handle<ast::node>;
-		auto create_numerical_literal(handle<token_location> location) const -> handle<ast::node>;
-		auto create_character_literal(handle<token_location> location) const -> handle<ast::node>;
-		auto create_struct_declaration(handle<token_location> location) const->handle<ast::node>;
-		auto create_variable_access(handle<token_location> location) const->handle<ast::node>;
-		auto create_string_literal(handle<token_location> location) const -> handle<ast::node>;
-		auto create_bool_literal(handle<token_location> location) const -> handle<ast::node>;
-		auto create_null_literal(handle<token_location> location) const -> handle<ast::node>;
-		auto create_assignment(handle<token_location> location) const -> handle<ast::node>;
-		auto create_logical_not(handle<token_location> location) const->handle<ast::node>;
-		auto create_alignof(handle<token_location> location) const->handle<ast::node>;
-		auto create_sizeof(handle<token_location> location) const -> handle<ast::node>;
-		auto create_cast(handle<token_location> location) const -> handle<ast::node>;
+		auto create_variable_declaration(u64 child_count, token_location location) const -> handle<ast::node>;
+		auto create_function_call(u64 child_count, token_location location) const -> handle<ast::node>;
+		auto create_array_access(u64 child_count, token_location location) const -> handle<ast::node>;
+		auto create_namespace(u64 child_count, token_location location) const -> handle<ast::node>;
+		auto create_function(u64 child_count, token_location location) const -> handle<ast::node>;
+		auto create_return(u64 child_count, token_location location) const -> handle<ast::node>;
+
+		auto create_local_member_access(token_location location) const -> handle<ast::node>;
+		auto create_numerical_literal(token_location location) const -> handle<ast::node>;
+		auto create_character_literal(token_location location) const -> handle<ast::node>;
+		auto create_struct_declaration(token_location location) const->handle<ast::node>;
+		auto create_variable_access(token_location location) const->handle<ast::node>;
+		auto create_string_literal(token_location location) const -> handle<ast::node>;
+		auto create_bool_literal(token_location location) const -> handle<ast::node>;
+		auto create_null_literal(token_location location) const -> handle<ast::node>;
+		auto create_assignment(token_location location) const -> handle<ast::node>;
+		auto create_logical_not(token_location location) const->handle<ast::node>;
+		auto create_alignof(token_location location) const->handle<ast::node>;
+		auto create_sizeof(token_location location) const -> handle<ast::node>;
+		auto create_cast(token_location location) const -> handle<ast::node>;
 
 		auto create_comparison_operation(ast::node_type type, handle<ast::node> left, handle<ast::node> right) const -> handle<ast::node>;
 		auto create_binary_operation(ast::node_type type, handle<ast::node> left, handle<ast::node> right) const->handle<ast::node>;
@@ -125,7 +188,22 @@ namespace sigma {
 		auto create_branch(u64 child_count) const->handle<ast::node>;
 
 	private:
-		frontend_context& m_context;
 		token_buffer_iterator m_tokens;
+
+		utility::block_allocator& m_node_allocator; // AST nodes
+		utility::block_allocator& m_allocator;      // other data referenced by the AST
+		utility::string_table& m_strings;           // synthesized strings
+
+		// nodes of child lists which are still being parsed, nested lists are stacked on top of
+		// each other, which lets us allocate every list once we know its final size
+		std::vector<handle<ast::node>> m_scratch;
+
+		// declaration parsing, nullptr while parsing a skipped function body
+		handle<frontend_context> m_context;
+		// receives skipped function bodies, nullptr if bodies are parsed immediately
+		std::vector<function_body>* m_skipped_bodies = nullptr;
+
+		// skipped function body we're currently parsing
+		function_body* m_body = nullptr;
 	};
 } // namespace sigma
@@ -4,6 +4,11 @@
 #include <utility/diagnostics.h>
 #include <utility/shell.h>
 
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <sstream>
+
 using namespace utility::types;
 
 #define COMPILER_STDOUT "compiler_STDOUT.txt"
@@ -15,14 +20,21 @@ using namespace utility::types;
 #define APP_STDOUT "app_STDOUT.txt"
 #define APP_STDERR "app_STDERR.txt"
 
+#define ASSEMBLY_FILE "test.asm"
+#define CACHE_DIRECTORY "test_cache"
+
+// on windows we emit an object file and link it using clang, on linux the compiler links the
+// executable by itself
 #ifdef SYSTEM_WINDOWS
 #define OBJECT_FILE "test.obj"
 #define EXECUTABLE_FILE "test.exe"
+#define EMIT_FILE OBJECT_FILE
 #define SYSTEM_STR "windows"
 #define EXECUTABLE_OPT ""
 #else
 #define OBJECT_FILE "test.o"
 #define EXECUTABLE_FILE "test"
+#define EMIT_FILE EXECUTABLE_FILE
 #define SYSTEM_STR "linux"
 #define EXECUTABLE_OPT "./"
 #endif
@@ -63,13 +75,107 @@ auto get_pretty_path(const filepath& path) -> filepath {
 	return path.get_parent_path().get_filename() / path.get_filename_no_ext();
 }
 
-auto compile_file(const filepath& path, const filepath& compiler_path) -> bool {
-	const std::string compilation_command = std::format("{} compile {} -e {} --system {} > {} 2> {}", compiler_path, path, OBJECT_FILE, SYSTEM_STR, COMPILER_STDOUT, COMPILER_STDERR);
-	const std::string link_command = std::format("clang {} -o {} ", OBJECT_FILE, EXECUTABLE_FILE);
+// tests are configured by a block of directives at the beginning of the test file:
+//   // sources: <paths>    comma separated list of additional source files, relative to the test
+//   // check: <text>       the emitted assembly has to contain <text>, checks are matched in order
+//   // check-not: <text>   <text> mustn't appear between the surrounding checks
+//   // exit: <code>        expected exit code of the program (0 by default)
+//   // arguments: <flags>  additional flags passed to every invocation of the compiler
+//   // diagnostic: <text>  the output of the compiler has to contain <text>, diagnostics are
+//                         matched in order
+//   // diagnostic-not: <text>  <text> mustn't appear between the surrounding diagnostics
+//   // fails               compilation has to fail, nothing is run
+//   // jit                 additionally run the test through the jit ('compiler run')
+//   // cache               additionally compile the test with a cold, warm and damaged syntax cache
+// source files without an expected output aren't tests by themselves, they're only compiled as
+// a part of other tests
+struct assembly_check {
+	std::string text;
+	bool is_negative;
+};
+
+struct test_options {
+	std::vector<filepath> sources;
+	std::vector<assembly_check> checks;
+	std::vector<assembly_check> diagnostics;
+	std::string arguments;
+	i32 exit_code = 0;
+	bool jit = false;
+	bool cache = false;
+	bool fails = false;
+};
+
+auto trim(std::string_view value) -> std::string_view {
+	const u64 begin = value.find_first_not_of(" \t\r");
+
+	if(begin == std::string_view::npos) {
+		return {};
+	}
+
+	return value.substr(begin, value.find_last_not_of(" \t\r") - begin + 1);
+}
+
+auto parse_test_options(const filepath& path) -> test_options {
+	std::istringstream stream(read_or_throw(path));
+	test_options options { .sources = { path } };
+	std::string line;
+
+	while(std::getline(stream, line) && line.starts_with("//")) {
+		const std::string_view directive = trim(std::string_view(line).substr(2));
+		const u64 separator = directive.find(':');
+		const std::string_view name = trim(directive.substr(0, separator));
+		const std::string_view value = separator == std::string_view::npos ? std::string_view() : trim(directive.substr(separator + 1));
+
+		if(name == "sources") {
+			for(u64 start = 0; start < value.size();) {
+				const u64 end = std::min(value.find(',', start), value.size());
+				options.sources.push_back(path.get_parent_path() / std::string(trim(value.substr(start, end - start))));
+				start = end + 1;
+			}
+		}
+		else if(name == "check" || name == "check-not") {
+			options.checks.push_back({ std::string(value), name == "check-not" });
+		}
+		else if(name == "diagnostic" || name == "diagnostic-not") {
+			options.diagnostics.push_back({ std::string(value), name == "diagnostic-not" });
+		}
+		else if(name == "fails") {
+			options.fails = true;
+		}
+		else if(name == "arguments") {
+			options.arguments += std::format(" {}", value);
+		}
+		else if(name == "exit") {
+			options.exit_code = std::stoi(std::string(value));
+		}
+		else if(name == "jit") {
+			options.jit = true;
+		}
+		else if(name == "cache") {
+			options.cache = true;
+		}
+	}
+
+	return options;
+}
+
+auto get_source_list(const test_options& options) -> std::string {
+	std::string list;
+
+	for(const filepath& source : options.sources) {
+		list += (list.empty() ? "" : ",") + source.to_string();
+	}
+
+	return list;
+}
+
+// stage describes the variant of the test which is being run, and is appended to error messages
+auto compile_file(const filepath& path, const test_options& options, const filepath& compiler_path, const std::string& arguments = "", const std::string& stage = "") -> bool {
+	const std::string compilation_command = std::format("{} compile {} -e {} --system {}{}{} > {} 2> {}", compiler_path, get_source_list(options), EMIT_FILE, SYSTEM_STR, options.arguments, arguments, COMPILER_STDOUT, COMPILER_STDERR);
 
 	// compile the source file
 	if(utility::shell::execute(compilation_command) != 0) {
-		utility::console::printerr("{:<40} ERROR (compile)\n", get_pretty_path(path).to_string());
+		utility::console::printerr("{:<40} ERROR (compile{})\n", get_pretty_path(path).to_string(), stage);
 
 		const std::string stdout_str = read_or_throw(COMPILER_STDOUT);
 		const std::string stderr_str = read_or_throw(COMPILER_STDERR);
@@ -79,9 +185,12 @@ auto compile_file(const filepath& path, const filepath& compiler_path) -> bool {
 		return true;
 	}
 
+#ifdef SYSTEM_WINDOWS
 	// link the generated object file
+	const std::string link_command = std::format("clang {} -o {} ", OBJECT_FILE, EXECUTABLE_FILE);
+
 	if(utility::shell::execute(link_command) != 0) {
-		utility::console::printerr("{:<40} ERROR (link)\n", get_pretty_path(path).to_string());
+		utility::console::printerr("{:<40} ERROR (link{})\n", get_pretty_path(path).to_string(), stage);
 
 		const std::string stdout_str = read_or_throw(CLANG_STDOUT);
 		const std::string stderr_str = read_or_throw(CLANG_STDERR);
@@ -90,24 +199,162 @@ auto compile_file(const filepath& path, const filepath& compiler_path) -> bool {
 
 		return true;
 	}
+#endif
 
 	return false;
 }
 
-auto run_executable(const filepath& path) -> i32 {
-	const std::string command = std::format("{}{} > {} 2> {}", EXECUTABLE_OPT, path, APP_STDOUT, APP_STDERR);
-	return utility::shell::execute(command);
+// returns the first check which doesn't hold for the given assembly, negative checks are verified
+// once the position of the next positive check is known
+auto find_failed_check(const std::string& assembly, const std::vector<assembly_check>& checks) -> std::optional<assembly_check> {
+	std::vector<assembly_check> negative_checks;
+	u64 position = 0;
+
+	for(const assembly_check& check : checks) {
+		if(check.is_negative) {
+			negative_checks.push_back(check);
+			continue;
+		}
+
+		const u64 match = assembly.find(check.text, position);
+
+		if(match == std::string::npos) {
+			return check;
+		}
+
+		const std::string_view range = std::string_view(assembly).substr(position, match - position);
+
+		for(const assembly_check& negative_check : negative_checks) {
+			if(range.find(negative_check.text) != std::string_view::npos) {
+				return negative_check;
+			}
+		}
+
+		negative_checks.clear();
+		position = match + check.text.size();
+	}
+
+	for(const assembly_check& negative_check : negative_checks) {
+		if(assembly.find(negative_check.text, position) != std::string::npos) {
+			return negative_check;
+		}
+	}
+
+	return std::nullopt;
 }
 
-bool run_test(const filepath& path, const filepath& compiler_path) {
-	const filepath pretty_path = path.get_parent_path().get_filename() / path.get_filename_no_ext();
+auto check_assembly(const filepath& path, const test_options& options, const filepath& compiler_path) -> bool {
+	const std::string compilation_command = std::format("{} compile {} -e {} --system {}{} > {} 2> {}", compiler_path, get_source_list(options), ASSEMBLY_FILE, SYSTEM_STR, options.arguments, COMPILER_STDOUT, COMPILER_STDERR);
+
+	if(utility::shell::execute(compilation_command) != 0) {
+		utility::console::printerr("{:<40} ERROR (compile assembly)\n", get_pretty_path(path).to_string());
+
+		const std::string stdout_str = read_or_throw(COMPILER_STDOUT);
+		const std::string stderr_str = read_or_throw(COMPILER_STDERR);
+
+		print_error_block({ "STDOUT", "STDERR" }, { stdout_str , stderr_str });
 
-	if(compile_file(path, compiler_path)) {
 		return true;
 	}
 
-	if(i32 run_result = run_executable(EXECUTABLE_FILE)) {
-		utility::console::printerr("{:<40} ERROR (run - {})\n", path.to_string(), run_result);
+	const std::string assembly_str = read_or_throw(ASSEMBLY_FILE);
+	const std::optional<assembly_check> failed_check = find_failed_check(assembly_str, options.checks);
+
+	if(failed_check.has_value()) {
+		utility::console::printerr("{:<40} ERROR (check)\n", get_pretty_path(path).to_string());
+
+		const std::string check_str = std::format("{}: {}\n", failed_check->is_negative ? "check-not" : "check", failed_check->text);
+		print_error_block({ "CHECK", "ASSEMBLY" }, { check_str, assembly_str });
+
+		return true;
+	}
+
+	return false;
+}
+
+auto check_diagnostics(const filepath& path, const test_options& options) -> bool {
+	const std::string output_str = read_or_throw(COMPILER_STDOUT) + read_or_throw(COMPILER_STDERR);
+	const std::optional<assembly_check> failed_check = find_failed_check(output_str, options.diagnostics);
+
+	if(failed_check.has_value()) {
+		utility::console::printerr("{:<40} ERROR (diagnostic)\n", get_pretty_path(path).to_string());
+
+		const std::string check_str = std::format("{}: {}\n", failed_check->is_negative ? "diagnostic-not" : "diagnostic", failed_check->text);
+		print_error_block({ "CHECK", "COMPILER_OUTPUT" }, { check_str, output_str });
+
+		return true;
+	}
+
+	return false;
+}
+
+// compiles a test which is expected to be rejected by the compiler
+auto check_failure(const filepath& path, const test_options& options, const filepath& compiler_path) -> bool {
+	const std::string compilation_command = std::format("{} compile {} -e {} --system {}{} > {} 2> {}", compiler_path, get_source_list(options), EMIT_FILE, SYSTEM_STR, options.arguments, COMPILER_STDOUT, COMPILER_STDERR);
+
+	if(utility::shell::execute(compilation_command) == 0) {
+		utility::console::printerr("{:<40} ERROR (compile - expected a failure)\n", get_pretty_path(path).to_string());
+
+		const std::string stdout_str = read_or_throw(COMPILER_STDOUT);
+		const std::string stderr_str = read_or_throw(COMPILER_STDERR);
+
+		print_error_block({ "STDOUT", "STDERR" }, { stdout_str , stderr_str });
+
+		return true;
+	}
+
+	return check_diagnostics(path, options);
+}
+
+auto run_jit(const filepath& path, const test_options& options, const filepath& compiler_path) -> bool {
+	const std::string command = std::format("{} run {}{} > {} 2> {}", compiler_path, get_source_list(options), options.arguments, APP_STDOUT, APP_STDERR);
+
+	if(const i32 run_result = utility::shell::execute(command); run_result != options.exit_code) {
+		utility::console::printerr("{:<40} ERROR (jit run - {})\n", get_pretty_path(path).to_string(), run_result);
+
+		const std::string app_stdout_str = read_or_throw(APP_STDOUT);
+		const std::string app_stderr_str = read_or_throw(APP_STDERR);
+
+		print_error_block(
+			{ "STDOUT", "STDERR" },
+			{ utility::escape_string(app_stdout_str), utility::escape_string(app_stderr_str) }
+		);
+
+		return true;
+	}
+
+	const std::string app_stdout_str = read_or_throw(APP_STDOUT);
+	const std::string expected_str = read_or_throw(get_expected_path(path));
+
+	if(app_stdout_str != expected_str) {
+		utility::console::printerr("{:<40} ERROR (unexpected jit result)\n", get_pretty_path(path).to_string());
+
+		const std::string app_stderr_str = read_or_throw(APP_STDERR);
+
+		print_error_block(
+			{ "STDOUT", "REFERENCE", "STDERR" },
+			{
+				utility::escape_string(app_stdout_str),
+				utility::escape_string(expected_str),
+				utility::escape_string(app_stderr_str)
+			}
+		);
+
+		return true;
+	}
+
+	return false;
+}
+
+auto run_executable(const filepath& path) -> i32 {
+	const std::string command = std::format("{}{} > {} 2> {}", EXECUTABLE_OPT, path, APP_STDOUT, APP_STDERR);
+	return utility::shell::execute(command);
+}
+
+// runs the compiled executable and compares its exit code and output with the expected ones
+auto verify_executable(const filepath& path, const test_options& options, const std::string& stage = "") -> bool {
+	if(const i32 run_result = run_executable(EXECUTABLE_FILE); run_result != options.exit_code) {
+		utility::console::printerr("{:<40} ERROR (run - {}{})\n", path.to_string(), run_result, stage);
 
 		const std::string app_stdout_str = read_or_throw(APP_STDOUT);
 		const std::string app_stderr_str = read_or_throw(APP_STDERR);
@@ -127,12 +374,12 @@ bool run_test(const filepath& path, const filepath& compiler_path) {
 		return true;
 	}
 
-	// executable returned 0
+	// executable returned the expected exit code
 	const std::string app_stdout_str = read_or_throw(APP_STDOUT);
 	const std::string expected_str = read_or_throw(get_expected_path(path));
 
 	if(app_stdout_str != expected_str) {
-		utility::console::printerr("{:<40} ERROR (unexpected result)\n", pretty_path.to_string());
+		utility::console::printerr("{:<40} ERROR (unexpected result{})\n", get_pretty_path(path).to_string(), stage);
 
 		const std::string app_stderr_str = read_or_throw(APP_STDERR);
 		const std::string compiler_stdout_str = read_or_throw(COMPILER_STDOUT);
@@ -151,6 +398,103 @@ bool run_test(const filepath& path, const filepath& compiler_path) {
 		return true;
 	}
 
+	return false;
+}
+
+// sizes and write times of all entries in the cache directory, loaded entries are never rewritten
+auto get_cache_entries() -> std::map<std::string, std::pair<u64, std::filesystem::file_time_type>> {
+	std::map<std::string, std::pair<u64, std::filesystem::file_time_type>> entries;
+
+	if(std::filesystem::exists(CACHE_DIRECTORY)) {
+		for(const auto& entry : std::filesystem::directory_iterator(CACHE_DIRECTORY)) {
+			entries[entry.path().string()] = { entry.file_size(), entry.last_write_time() };
+		}
+	}
+
+	return entries;
+}
+
+// the first build populates the cache, the second one loads every file from it and the last one
+// has to parse every file again, since all entries are damaged by then
+auto check_cache(const filepath& path, const test_options& options, const filepath& compiler_path) -> bool {
+	const std::string arguments = std::format(" --cache {}", CACHE_DIRECTORY);
+	std::filesystem::remove_all(CACHE_DIRECTORY);
+
+	std::map<std::string, std::pair<u64, std::filesystem::file_time_type>> cold_entries;
+
+	for(const std::string stage : { "cold", "warm", "damaged" }) {
+		if(stage == "damaged") {
+			for(const auto& [entry_path, entry] : cold_entries) {
+				std::filesystem::resize_file(entry_path, entry.first / 2);
+			}
+		}
+
+		if(
+			compile_file(path, options, compiler_path, arguments, std::format(", {} cache", stage)) ||
+			verify_executable(path, options, std::format(", {} cache", stage))
+		) {
+			return true;
+		}
+
+		const auto entries = get_cache_entries();
+		std::string error;
+
+		if(stage == "cold") {
+			cold_entries = entries;
+			error = entries.size() == options.sources.size() ? "" : "an entry wasn't written";
+		}
+		else if(stage == "warm") {
+			error = entries == cold_entries ? "" : "an entry wasn't loaded";
+		}
+		else {
+			const bool replaced = std::ranges::equal(entries, cold_entries, [](const auto& a, const auto& b) {
+				return a.first == b.first && a.second.first == b.second.first;
+			});
+
+			error = replaced ? "" : "a damaged entry wasn't replaced";
+		}
+
+		if(!error.empty()) {
+			utility::console::printerr("{:<40} ERROR (cache - {})\n", get_pretty_path(path).to_string(), error);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool run_test(const filepath& path, const filepath& compiler_path) {
+	const filepath pretty_path = path.get_parent_path().get_filename() / path.get_filename_no_ext();
+	const test_options options = parse_test_options(path);
+
+	if(options.fails) {
+		if(check_failure(path, options, compiler_path)) {
+			return true;
+		}
+
+		utility::console::print("{:<40} OK\n", pretty_path.to_string());
+		return false;
+	}
+
+	if(compile_file(path, options, compiler_path) || check_diagnostics(path, options) || verify_executable(path, options)) {
+		return true;
+	}
+
+	// verify that the expected transformations were applied to the generated code
+	if(!options.checks.empty() && check_assembly(path, options, compiler_path)) {
+		return true;
+	}
+
+	// the jit has to produce the same results as the executable
+	if(options.jit && run_jit(path, options, compiler_path)) {
+		return true;
+	}
+
+	// cached syntax has to produce the same results as a fresh parse
+	if(options.cache && check_cache(path, options, compiler_path)) {
+		return true;
+	}
+
 	utility::console::print("{:<40} OK\n", pretty_path.to_string());
 	return false;
 }
@@ -172,6 +516,7 @@ i32 run_all_tests(const parametric::parameters& params) {
 		utility::fs::create(APP_STDERR);
 		utility::fs::create(OBJECT_FILE);
 		utility::fs::create(EXECUTABLE_FILE);
+		utility::fs::create(ASSEMBLY_FILE);
 	}
 	catch (const std::exception& exception) {
 		utility::console::printerr("error: {}\n", exception.what());
@@ -194,8 +539,8 @@ i32 run_all_tests(const parametric::parameters& params) {
 					return;
 				}
 
-				if (path.get_extension() == ".s") {
-					// only compile .s files
+				if (path.get_extension() == ".s" && get_expected_path(path).exists()) {
+					// only compile .s files which have an expected output
 					encountered_error |= run_test(path, compiler_path);
 				}
 			});
@@ -216,6 +561,8 @@ i32 run_all_tests(const parametric::parameters& params) {
 		utility::fs::remove(APP_STDERR);
 		utility::fs::remove(OBJECT_FILE);
 		utility::fs::remove(EXECUTABLE_FILE);
+		utility::fs::remove(ASSEMBLY_FILE);
+		std::filesystem::remove_all(CACHE_DIRECTORY);
 	}
 	catch (const std::exception& exception) {
 		utility::console::printerr("error: {}\n", exception.what());
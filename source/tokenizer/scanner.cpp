@@ -0,0 +1,242 @@
+#include "scanner.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCANNER_SIMD
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SCANNER_AVX2
+#else
+// allows us to use AVX2 intrinsics without compiling the entire project with AVX2 enabled
+#define SCANNER_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace sigma {
+	namespace detail {
+		// character classes, every class provides a scalar, SSE2 and AVX2 implementation; vector
+		// variants set every byte which belongs to the class to 0xFF
+		struct whitespace_class {
+			static auto scalar(char c) -> bool {
+				return c == ' ' || (c >= '\t' && c <= '\r');
+			}
+
+#ifdef SCANNER_SIMD
+			static auto sse(__m128i v) -> __m128i {
+				// '\t', '\n', '\v', '\f' and '\r' form a continuous range
+				const __m128i control = _mm_and_si128(
+					_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)),
+					_mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))
+				);
+
+				return _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+			}
+
+			SCANNER_AVX2 static auto avx(__m256i v) -> __m256i {
+				const __m256i control = _mm256_and_si256(
+					_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)
+				);
+
+				return _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+			}
+#endif
+		};
+
+		struct digit_class {
+			static auto scalar(char c) -> bool {
+				return c >= '0' && c <= '9';
+			}
+
+#ifdef SCANNER_SIMD
+			static auto sse(__m128i v) -> __m128i {
+				return _mm_and_si128(
+					_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+					_mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1))
+				);
+			}
+
+			SCANNER_AVX2 static auto avx(__m256i v) -> __m256i {
+				return _mm256_and_si256(
+					_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v)
+				);
+			}
+#endif
+		};
+
+		struct identifier_class {
+			static auto scalar(char c) -> bool {
+				const char lower = static_cast<char>(c | 0x20);
+				return (lower >= 'a' && lower <= 'z') || digit_class::scalar(c) || c == '_';
+			}
+
+#ifdef SCANNER_SIMD
+			static auto sse(__m128i v) -> __m128i {
+				// setting the 6th bit maps upper case letters onto lower case ones, characters
+				// outside of the ASCII range stay negative and never match
+				const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+				const __m128i alpha = _mm_and_si128(
+					_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+					_mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1))
+				);
+
+				const __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+				return _mm_or_si128(_mm_or_si128(alpha, digit_class::sse(v)), underscore);
+			}
+
+			SCANNER_AVX2 static auto avx(__m256i v) -> __m256i {
+				const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+				const __m256i alpha = _mm256_and_si256(
+					_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower)
+				);
+
+				const __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+				return _mm256_or_si256(_mm256_or_si256(alpha, digit_class::avx(v)), underscore);
+			}
+#endif
+		};
+
+		template<char... characters>
+		struct character_set_class {
+			static auto scalar(char c) -> bool {
+				return ((c == characters) || ...);
+			}
+
+#ifdef SCANNER_SIMD
+			static auto sse(__m128i v) -> __m128i {
+				__m128i result = _mm_setzero_si128();
+				((result = _mm_or_si128(result, _mm_cmpeq_epi8(v, _mm_set1_epi8(characters)))), ...);
+				return result;
+			}
+
+			SCANNER_AVX2 static auto avx(__m256i v) -> __m256i {
+				__m256i result = _mm256_setzero_si256();
+				((result = _mm256_or_si256(result, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(characters)))), ...);
+				return result;
+			}
+#endif
+		};
+
+		using newline_class = character_set_class<'\n'>;
+		using line_end_class = character_set_class<'\n', '\r'>;
+		using string_end_class = character_set_class<'"', '\\'>;
+		using literal_or_comment_class = character_set_class<'"', '\'', '/'>;
+
+		// returns the first character for which the classification equals 'stop_on_match'
+		template<typename classifier, bool stop_on_match>
+		auto scan_scalar(const char* begin, const char* end) -> const char* {
+			while(begin != end && classifier::scalar(*begin) != stop_on_match) {
+				++begin;
+			}
+
+			return begin;
+		}
+
+#ifdef SCANNER_SIMD
+		template<typename classifier, bool stop_on_match>
+		auto scan_sse(const char* begin, const char* end) -> const char* {
+			for(; end - begin >= 16; begin += 16) {
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+				u32 mask = static_cast<u32>(_mm_movemask_epi8(classifier::sse(block)));
+
+				if constexpr(!stop_on_match) {
+					mask = ~mask & 0xFFFF;
+				}
+
+				if(mask) {
+					return begin + std::countr_zero(mask);
+				}
+			}
+
+			return scan_scalar<classifier, stop_on_match>(begin, end);
+		}
+
+		template<typename classifier, bool stop_on_match>
+		SCANNER_AVX2 auto scan_avx(const char* begin, const char* end) -> const char* {
+			for(; end - begin >= 32; begin += 32) {
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+				u32 mask = static_cast<u32>(_mm256_movemask_epi8(classifier::avx(block)));
+
+				if constexpr(!stop_on_match) {
+					mask = ~mask;
+				}
+
+				if(mask) {
+					return begin + std::countr_zero(mask);
+				}
+			}
+
+			return scan_sse<classifier, stop_on_match>(begin, end);
+		}
+
+		auto supports_avx2() -> bool {
+#ifdef _MSC_VER
+			i32 info[4];
+
+			// the CPU has to support AVX2 and the OS has to preserve the YMM registers
+			__cpuid(info, 0);
+
+			if(info[0] < 7) {
+				return false;
+			}
+
+			__cpuid(info, 1);
+			const bool os_support = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+
+			__cpuidex(info, 7, 0);
+			return os_support && (info[1] & (1 << 5));
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+#endif
+
+		template<typename classifier, bool stop_on_match>
+		auto scan(const char* begin, const char* end) -> const char* {
+#ifdef SCANNER_SIMD
+			static const bool avx2 = supports_avx2();
+
+			if(avx2) {
+				return scan_avx<classifier, stop_on_match>(begin, end);
+			}
+
+			return scan_sse<classifier, stop_on_match>(begin, end);
+#else
+			return scan_scalar<classifier, stop_on_match>(begin, end);
+#endif
+		}
+	} // namespace detail
+
+	auto scanner::skip_whitespace(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::whitespace_class, false>(begin, end);
+	}
+
+	auto scanner::skip_identifier(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::identifier_class, false>(begin, end);
+	}
+
+	auto scanner::skip_digits(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::digit_class, false>(begin, end);
+	}
+
+	auto scanner::find_newline(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::newline_class, true>(begin, end);
+	}
+
+	auto scanner::find_line_end(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::line_end_class, true>(begin, end);
+	}
+
+	auto scanner::find_string_end(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::string_end_class, true>(begin, end);
+	}
+
+	auto scanner::find_literal_or_comment(const char* begin, const char* end) -> const char* {
+		return detail::scan<detail::literal_or_comment_class, true>(begin, end);
+	}
+} // namespace sigma
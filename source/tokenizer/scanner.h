@@ -0,0 +1,58 @@
+#pragma once
+#include <utility/types.h>
+
+namespace sigma {
+	using namespace utility::types;
+
+	/**
+	 * \brief Vectorized character classification used by the tokenizer. Every function classifies
+	 * 16 (SSE2) or 32 (AVX2, if supported by the host CPU) characters at once and falls back to
+	 * scalar code for the tail of the range. Classification follows the "C" locale, characters
+	 * outside of the ASCII range never belong to any class.
+	 */
+	struct scanner {
+		/**
+		 * \brief Skips whitespace characters (' ', '\\t', '\\n', '\\v', '\\f', '\\r').
+		 * \return Pointer to the first non-whitespace character, \b end if there is none.
+		 */
+		static auto skip_whitespace(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Skips identifier characters (alphanumeric characters and underscores).
+		 * \return Pointer to the first non-identifier character, \b end if there is none.
+		 */
+		static auto skip_identifier(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Skips decimal digits.
+		 * \return Pointer to the first non-digit character, \b end if there is none.
+		 */
+		static auto skip_digits(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Looks for the next '\\n' character.
+		 * \return Pointer to the first '\\n' character, \b end if there is none.
+		 */
+		static auto find_newline(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Looks for the end of the current line ('\\n' or '\\r').
+		 * \return Pointer to the first line break, \b end if there is none.
+		 */
+		static auto find_line_end(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Looks for the next character which needs special handling in a string literal
+		 * ('"' or '\\').
+		 * \return Pointer to the first such character, \b end if there is none.
+		 */
+		static auto find_string_end(const char* begin, const char* end) -> const char*;
+
+		/**
+		 * \brief Looks for the next character which may start a literal or a comment ('"', '\'' or
+		 * '/').
+		 * \return Pointer to the first such character, \b end if there is none.
+		 */
+		static auto find_literal_or_comment(const char* begin, const char* end) -> const char*;
+	};
+} // namespace sigma
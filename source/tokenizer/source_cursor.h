@@ -0,0 +1,46 @@
+#pragma once
+#include <utility/types.h>
+
+namespace sigma {
+	using namespace utility::types;
+
+	/**
+	 * \brief Non-owning cursor over a source text. Unlike utility::string_accessor it doesn't
+	 * require the text to be stored in a std::string, which lets us walk memory-mapped files
+	 * directly. Reads past the end of the text yield '\\0'.
+	 */
+	class source_cursor {
+	public:
+		source_cursor(std::string_view text) : m_text(text) {}
+
+		[[nodiscard]] auto get() const -> char {
+			return m_position < m_text.size() ? m_text[m_position] : '\0';
+		}
+
+		auto get_advance() -> char {
+			const char c = get();
+			m_position++;
+			return c;
+		}
+
+		/**
+		 * \brief Checks whether the cursor has moved past the end of the text. The tokenizer reads
+		 * one character ahead, the last character therefore still has to be processed once the
+		 * position reaches the size of the text.
+		 */
+		[[nodiscard]] auto end() const -> bool {
+			return m_position > m_text.size();
+		}
+
+		[[nodiscard]] auto get_position() const -> u64 {
+			return m_position;
+		}
+
+		void set_position(u64 position) {
+			m_position = position;
+		}
+	private:
+		std::string_view m_text;
+		u64 m_position = 0;
+	};
+} // namespace sigma
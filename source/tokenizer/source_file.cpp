@@ -0,0 +1,182 @@
+#include "source_file.h"
+#include "tokenizer/token.h"
+#include <compiler/compiler/diagnostics.h>
+
+#include "tokenizer/scanner.h"
+
+#ifdef SYSTEM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace sigma {
+	source_file::~source_file() {
+		release();
+	}
+
+	source_file::source_file(source_file&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	source_file& source_file::operator=(source_file&& other) noexcept {
+		if(this != &other) {
+			release();
+
+			m_data = other.m_data;
+			m_size = other.m_size;
+			m_path = other.m_path;
+			m_line_starts = std::move(other.m_line_starts);
+			m_has_line_starts = other.m_has_line_starts.load();
+
+			other.m_data = nullptr;
+			other.m_size = 0;
+			other.m_has_line_starts = false;
+		}
+
+		return *this;
+	}
+
+	auto source_file::load(handle<const filepath> path) -> utility::result<void> {
+		const std::string path_str = path->to_string();
+
+		release();
+		m_path = path;
+
+#ifdef SYSTEM_WINDOWS
+		const HANDLE file = CreateFileA(
+			path_str.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+		);
+
+		if(file == INVALID_HANDLE_VALUE) {
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		LARGE_INTEGER size;
+
+		if(!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		m_size = static_cast<u64>(size.QuadPart);
+
+		if(m_size > 0) {
+			// the view keeps the mapping alive, we don't need either handle afterwards
+			const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if(mapping) {
+				m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+#else
+		const i32 file = open(path_str.c_str(), O_RDONLY);
+
+		if(file == -1) {
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		struct stat info;
+
+		if(fstat(file, &info) == -1) {
+			close(file);
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		m_size = static_cast<u64>(info.st_size);
+
+		if(m_size > 0) {
+			void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+			if(mapping != MAP_FAILED) {
+				// the file is only ever read front to back
+				madvise(mapping, m_size, MADV_SEQUENTIAL);
+				m_data = static_cast<const char*>(mapping);
+			}
+		}
+
+		close(file);
+#endif
+
+		if(m_size > 0 && m_data == nullptr) {
+			m_size = 0;
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		// offsets are stored as 32-bit integers
+		if(m_size > std::numeric_limits<u32>::max()) {
+			release();
+			return error::emit(error::code::CANNOT_READ_FILE, path_str);
+		}
+
+		return SUCCESS;
+	}
+
+	auto source_file::get_text() const -> std::string_view {
+		return { m_data, m_size };
+	}
+
+	auto source_file::get_path() const -> handle<const filepath> {
+		return m_path;
+	}
+
+	auto source_file::get_line_index(u32 offset) const -> u32 {
+		build_line_table();
+
+		// the first line always starts at 0, so there's always at least one preceding line start
+		const auto it = std::ranges::upper_bound(m_line_starts, offset);
+		return static_cast<u32>(it - m_line_starts.begin() - 1);
+	}
+
+	auto source_file::get_char_index(u32 offset) const -> u32 {
+		return offset - m_line_starts[get_line_index(offset)];
+	}
+
+	void source_file::build_line_table() const {
+		if(m_has_line_starts.load(std::memory_order_acquire)) {
+			return;
+		}
+
+		const std::lock_guard lock(m_line_mutex);
+
+		// another thread might have built the table while we were waiting
+		if(m_has_line_starts.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		const char* begin = m_data;
+		const char* end = m_data + m_size;
+
+		m_line_starts.push_back(0);
+
+		for(const char* line = scanner::find_newline(begin, end); line != end; line = scanner::find_newline(line + 1, end)) {
+			m_line_starts.push_back(static_cast<u32>(line + 1 - begin));
+		}
+
+		m_has_line_starts.store(true, std::memory_order_release);
+	}
+
+	void source_file::release() {
+		if(m_data) {
+#ifdef SYSTEM_WINDOWS
+			UnmapViewOfFile(m_data);
+#else
+			munmap(const_cast<char*>(m_data), m_size);
+#endif
+		}
+
+		m_data = nullptr;
+		m_size = 0;
+		m_line_starts.clear();
+		m_has_line_starts = false;
+	}
+} // namespace sigma
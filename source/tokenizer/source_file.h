@@ -0,0 +1,68 @@
+#pragma once
+#include <utility/filesystem/filepath.h>
+#include <utility/handle.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace sigma {
+	using namespace utility::types;
+
+	/**
+	 * \brief Read-only, memory-mapped contents of a single source file. Tokens and locations refer
+	 * to the text by offset, the file therefore has to outlive every token and AST node created
+	 * from it. Line and column numbers aren't tracked during tokenization, they're recomputed from
+	 * a table of line starts, which is only built once a location is actually requested.
+	 */
+	class source_file {
+	public:
+		source_file() = default;
+		~source_file();
+
+		source_file(const source_file&) = delete;
+		source_file& operator=(const source_file&) = delete;
+
+		source_file(source_file&& other) noexcept;
+		source_file& operator=(source_file&& other) noexcept;
+
+		/**
+		 * \brief Maps the file located at \b path into memory, any previously loaded file is
+		 * released.
+		 * \param path Path of the file to load
+		 * \return Error if the file couldn't be read.
+		 */
+		auto load(handle<const filepath> path) -> utility::result<void>;
+
+		[[nodiscard]] auto get_text() const -> std::string_view;
+		[[nodiscard]] auto get_path() const -> handle<const filepath>;
+
+		/**
+		 * \brief Computes the zero-based line index of the character at \b offset.
+		 * \param offset Offset into the source text
+		 * \return Line index of \b offset.
+		 */
+		[[nodiscard]] auto get_line_index(u32 offset) const -> u32;
+
+		/**
+		 * \brief Computes the zero-based index of the character at \b offset within its line.
+		 * \param offset Offset into the source text
+		 * \return Character index of \b offset.
+		 */
+		[[nodiscard]] auto get_char_index(u32 offset) const -> u32;
+	private:
+		void build_line_table() const;
+		void release();
+	private:
+		// view of the mapping, empty files aren't mapped at all
+		const char* m_data = nullptr;
+		u64 m_size = 0;
+
+		handle<const filepath> m_path;
+
+		// offsets of the first character of every line, built on demand, locations of a single file
+		// can be queried from multiple threads (ie. when function bodies are type checked in parallel)
+		mutable std::vector<u32> m_line_starts;
+		mutable std::atomic<bool> m_has_line_starts = false;
+		mutable std::mutex m_line_mutex;
+	};
+} // namespace sigma
@@ -1,6 +1,8 @@
 #include "token.h"
 #include <utility/macros.h>
 
+#include "tokenizer/source_file.h"
+
 namespace sigma {
 	token::token(token_type type) : type(type) {}
 
@@ -130,4 +132,16 @@ namespace sigma {
 		return type;
 	}
 
+	auto token_location::get_path() const -> handle<const filepath> {
+		return file->get_path();
+	}
+
+	auto token_location::get_line_index() const -> u32 {
+		return file->get_line_index(offset);
+	}
+
+	auto token_location::get_char_index() const -> u32 {
+		return file->get_char_index(offset);
+	}
+
 } // sigma::lex
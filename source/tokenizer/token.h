@@ -101,15 +101,29 @@ namespace sigma {
 		token_type type;
 	};
 
+	class source_file;
+
+	/**
+	 * \brief Position of a token in its source file. Only the offset is stored, line and character
+	 * indices are resolved by the file when needed.
+	 */
 	struct token_location {
-		handle<filepath> file;
-		u32 line_index = 0;
-		u32 char_index = 0;
+		auto get_path() const -> handle<const filepath>;
+		auto get_line_index() const -> u32;
+		auto get_char_index() const -> u32;
+
+		handle<source_file> file;
+		u32 offset = 0;
 	};
 
+	/**
+	 * \brief Packed token record, the text of the token is located at [offset, offset + length)
+	 * in the source file of the respective token buffer.
+	 */
 	struct token_info {
 		token tok;
-		handle<token_location> location;
+		u32 offset = 0;
+		u32 length = 0;
 		utility::string_table_key symbol_key;
 	};
 }
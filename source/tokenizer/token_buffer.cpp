@@ -6,6 +6,29 @@ namespace sigma {
 		return m_token_infos.get_size() - 1;
 	}
 
+	void token_buffer::append(const token_buffer& other) {
+		ASSERT(!empty() && last().tok == token_type::END_OF_FILE, "unterminated token buffer");
+		ASSERT(!other.empty(), "cannot append an empty token buffer");
+
+		m_token_infos[m_token_infos.get_size() - 1] = other.first();
+
+		for(u64 i = 1; i < other.get_size(); ++i) {
+			m_token_infos.push_back(other[i]);
+		}
+	}
+
+	void token_buffer::set_source_file(handle<source_file> file) {
+		m_file = file;
+	}
+
+	auto token_buffer::get_source_file() const -> handle<source_file> {
+		return m_file;
+	}
+
+	auto token_buffer::get_location(u64 index) const -> token_location {
+		return { m_file, m_token_infos[index].offset };
+	}
+
 	auto token_buffer::get_size() const -> u64 {
 		return m_token_infos.get_size();
 	}
@@ -42,16 +65,38 @@ namespace sigma {
 		return m_token_infos[index];
 	}
 
-	token_buffer_iterator::token_buffer_iterator(const token_buffer& tokens)
-		: m_tokens(tokens), m_current_info(tokens.first()) {}
+	token_buffer_iterator::token_buffer_iterator(const token_buffer& tokens, u64 index)
+		: m_tokens(&tokens), m_current_info(tokens[index]), m_peek_index(index), m_index(index) {}
+
+	token_buffer_iterator::token_buffer_iterator(token_stream& stream)
+		: m_stream(&stream), m_current_info(stream.get(0)) {}
 
 	void token_buffer_iterator::next() {
 		m_index++;
 		m_peek_index++;
 
-		ASSERT(m_index < m_tokens.get_size(), "out of bounds token access");
+		if(m_stream) {
+			// keep the previous token around
+			m_stream->release(m_index - 1);
+		}
+		else {
+			ASSERT(m_index < m_tokens->get_size(), "out of bounds token access");
+		}
 
-		m_current_info = m_tokens[m_index];
+		m_current_info = get_token_info(m_index);
+	}
+
+	void token_buffer_iterator::set_index(u64 index) {
+		ASSERT(m_stream == nullptr, "cannot move within a token stream");
+		ASSERT(index < m_tokens->get_size(), "out of bounds token access");
+
+		m_index = index;
+		m_peek_index = index;
+		m_current_info = (*m_tokens)[index];
+	}
+
+	auto token_buffer_iterator::get_index() const -> u64 {
+		return m_index;
 	}
 
 	void token_buffer_iterator::prev() {
@@ -60,19 +105,23 @@ namespace sigma {
 	}
 
 	auto token_buffer_iterator::peek() -> token_info {
-		return m_tokens[++m_peek_index];
+		return get_token_info(++m_peek_index);
 	}
 
 	auto token_buffer_iterator::peek_token() -> token {
-		return m_tokens[++m_peek_index].tok;
+		return get_token_info(++m_peek_index).tok;
 	}
 
 	auto token_buffer_iterator::peek_next() const -> token_info {
-		return m_tokens[m_index + 1];
+		return get_token_info(m_index + 1);
 	}
 
 	auto token_buffer_iterator::peek_next_token() const -> token {
-		return m_tokens[m_index + 1].tok;
+		return get_token_info(m_index + 1).tok;
+	}
+
+	auto token_buffer_iterator::peek_next_location() const -> token_location {
+		return { get_source_file(), get_token_info(m_index + 1).offset };
 	}
 
 	void token_buffer_iterator::synchronize_indices() {
@@ -87,23 +136,23 @@ namespace sigma {
 		return m_current_info.tok;
 	}
 
-	auto token_buffer_iterator::get_current_token_location() const -> handle<token_location> {
-		return m_current_info.location;
+	auto token_buffer_iterator::get_current_token_location() const -> token_location {
+		return { get_source_file(), m_current_info.offset };
 	}
 
-	auto token_buffer_iterator::get_current_token_line_index() const -> u32 {
-		return m_current_info.location->line_index;
+	auto token_buffer_iterator::get_current_peek_token() const -> token {
+		return get_token_info(m_peek_index).tok;
 	}
 
-	auto token_buffer_iterator::get_current_token_char_index() const -> u32 {
-		return m_current_info.location->char_index;
+	auto token_buffer_iterator::get_current_peek() const -> token_info {
+		return get_token_info(m_peek_index);
 	}
 
-	auto token_buffer_iterator::get_current_peek_token() const -> token {
-		return m_tokens[m_peek_index].tok;
+	auto token_buffer_iterator::get_token_info(u64 index) const -> token_info {
+		return m_stream ? m_stream->get(index) : (*m_tokens)[index];
 	}
 
-	auto token_buffer_iterator::get_current_peek() const -> token_info {
-		return m_tokens[m_peek_index];
+	auto token_buffer_iterator::get_source_file() const -> handle<source_file> {
+		return m_stream ? m_stream->get_source_file() : m_tokens->get_source_file();
 	}
 } // namespace sigma::lex
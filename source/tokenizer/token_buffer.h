@@ -3,12 +3,30 @@
 #include <utility/string/string_table.h>
 
 #include "tokenizer/token.h"
+#include "tokenizer/token_stream.h"
 
 namespace sigma {
 	class token_buffer {
 	public:
 		auto add_token(token_info info) -> u64;
 
+		/**
+		 * \brief Appends the tokens of \b other, which replace the END_OF_FILE token terminating
+		 * this buffer. Used for joining chunks of a file which were tokenized separately.
+		 * \param other Tokens to append, have to belong to the same source file
+		 */
+		void append(const token_buffer& other);
+
+		void set_source_file(handle<source_file> file);
+		[[nodiscard]] auto get_source_file() const -> handle<source_file>;
+
+		/**
+		 * \brief Materializes the location of the token at \b index.
+		 * \param index Index of the token
+		 * \return Location of the token.
+		 */
+		[[nodiscard]] auto get_location(u64 index) const -> token_location;
+
 		[[nodiscard]] auto get_size() const -> u64;
 
 		[[nodiscard]] auto get_token(u64 index) const->token;
@@ -25,14 +43,28 @@ namespace sigma {
 		[[nodiscard]] auto empty() const -> bool;
 	private:
 		utility::memory_buffer<token_info> m_token_infos;
+		handle<source_file> m_file; // file the tokens point into
 	};
 
+	/**
+	 * \brief Iterates over tokens stored in a token_buffer, or over tokens pulled from a
+	 * token_stream. Streamed tokens are released once the iterator moves past them, only the
+	 * previous token is retained.
+	 */
 	class token_buffer_iterator {
 	public:
-		token_buffer_iterator(const token_buffer& tokens);
+		token_buffer_iterator(const token_buffer& tokens, u64 index = 0);
+		token_buffer_iterator(token_stream& stream);
 
 		void next();
 
+		/**
+		 * \brief Moves the iterator to the token at \b index, only supported for buffered tokens.
+		 * \param index Index of the token to move to
+		 */
+		void set_index(u64 index);
+		auto get_index() const -> u64;
+
 		void prev();
 
 		auto peek() -> token_info;
@@ -40,19 +72,23 @@ namespace sigma {
 
 		auto peek_next() const->token_info;
 		auto peek_next_token() const -> token;
+		auto peek_next_location() const -> token_location;
 
 		void synchronize_indices();
 
 		auto get_current() const-> token_info;
 		auto get_current_token() const -> token;
-		auto get_current_token_location() const -> handle<token_location>;
-		auto get_current_token_line_index() const -> u32;
-		auto get_current_token_char_index() const -> u32;
+		auto get_current_token_location() const -> token_location;
 
 		auto get_current_peek_token() const -> token;
 		auto get_current_peek() const -> token_info;
 	private:
-		const token_buffer& m_tokens;
+		auto get_token_info(u64 index) const -> token_info;
+		auto get_source_file() const -> handle<source_file>;
+	private:
+		// exactly one of these is set
+		const token_buffer* m_tokens = nullptr;
+		token_stream* m_stream = nullptr;
 
 		token_info m_current_info;
 
@@ -0,0 +1,142 @@
+#include "token_stream.h"
+#include <utility/macros.h>
+
+#include "tokenizer/source_file.h"
+
+namespace sigma {
+	token_stream::token_stream(
+		handle<source_file> file,
+		utility::string_table& strings,
+		std::vector<utility::string_table_key>& symbols,
+		u64 capacity
+	) : m_file(file), m_slots(capacity), m_batch_size(std::max(capacity / 8, u64(1))), m_strings(strings), m_symbols(symbols) {
+		ASSERT(capacity > 1, "invalid token stream capacity");
+	}
+
+	void token_stream::push(const token_info& info, const std::string* value) {
+		if(m_pushed - m_tail_cache == m_slots.size()) {
+			// the stream is full, make sure the consumer can see everything we've pushed so far and
+			// wait for it to free up some slots
+			publish_head();
+			m_tail_cache = m_tail.load(std::memory_order_acquire);
+
+			while(m_pushed - m_tail_cache == m_slots.size()) {
+				m_tail.wait(m_tail_cache, std::memory_order_acquire);
+				m_tail_cache = m_tail.load(std::memory_order_acquire);
+			}
+		}
+
+		slot& target = m_slots[m_pushed % m_slots.size()];
+		target.info = info;
+		target.has_value = value != nullptr;
+
+		// slots are reused, assigning the value therefore doesn't allocate most of the time
+		if(value) {
+			target.value = *value;
+		}
+
+		++m_pushed;
+
+		// tokens are published in batches, so that we don't have to synchronize with the consumer
+		// after every single token
+		if(m_pushed - m_published == m_batch_size || info.tok == token_type::END_OF_FILE) {
+			publish_head();
+		}
+	}
+
+	void token_stream::abort() {
+		const u32 size = static_cast<u32>(m_file->get_text().size());
+
+		push({
+			.tok    = { token_type::END_OF_FILE },
+			.offset = size
+		});
+	}
+
+	auto token_stream::get(u64 index) -> token_info {
+		if(index >= m_end) {
+			return m_end_token;
+		}
+
+		ASSERT(index >= m_released, "token has already been released");
+		ASSERT(index < m_released + m_slots.size(), "token stream lookahead exceeded");
+
+		if(index >= m_head_cache) {
+			m_head_cache = m_head.load(std::memory_order_acquire);
+
+			if(index >= m_head_cache) {
+				// wait for the producer to catch up, the producer may be waiting for us as well
+				publish_tail();
+
+				while(index >= m_head_cache) {
+					m_head.wait(m_head_cache, std::memory_order_acquire);
+					m_head_cache = m_head.load(std::memory_order_acquire);
+				}
+			}
+		}
+
+		const token_info& info = m_slots[index % m_slots.size()].info;
+
+		if(info.tok == token_type::END_OF_FILE) {
+			m_end = index;
+			m_end_token = info;
+		}
+
+		return info;
+	}
+
+	void token_stream::release(u64 index) {
+		index = std::min(index, m_head_cache);
+
+		if(index <= m_released) {
+			return;
+		}
+
+		for(; m_released < index; ++m_released) {
+			import_value(m_slots[m_released % m_slots.size()]);
+		}
+
+		if(m_released - m_tail.load(std::memory_order_relaxed) >= m_batch_size) {
+			publish_tail();
+		}
+	}
+
+	void token_stream::drain() {
+		u64 index = m_released;
+
+		while(get(index).tok != token_type::END_OF_FILE) {
+			release(++index);
+		}
+
+		release(index + 1);
+		publish_tail();
+	}
+
+	auto token_stream::get_source_file() const -> handle<source_file> {
+		return m_file;
+	}
+
+	void token_stream::publish_head() {
+		m_published = m_pushed;
+		m_head.store(m_pushed, std::memory_order_release);
+		m_head.notify_one();
+	}
+
+	void token_stream::publish_tail() {
+		m_tail.store(m_released, std::memory_order_release);
+		m_tail.notify_one();
+	}
+
+	void token_stream::import_value(const slot& slot) const {
+		if(!slot.has_value || m_strings.contains(slot.info.symbol_key)) {
+			return;
+		}
+
+		// string table keys are derived from the contents of the string, the key produced by the
+		// tokenizer is therefore valid in our table as well
+		[[maybe_unused]] const utility::string_table_key key = m_strings.insert(slot.value);
+		ASSERT(key == slot.info.symbol_key, "string table key mismatch");
+
+		m_symbols.push_back(key);
+	}
+} // namespace sigma
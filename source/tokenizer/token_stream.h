@@ -0,0 +1,106 @@
+#pragma once
+#include <utility/string/string_table.h>
+
+#include "tokenizer/token.h"
+#include <atomic>
+
+namespace sigma {
+	/**
+	 * \brief Bounded single-producer, single-consumer queue of tokens, which lets us parse a file
+	 * while it's still being tokenized. The tokenizer pushes tokens from its own thread, the parser
+	 * pulls them through a token_buffer_iterator. Only a fixed window of tokens is kept in memory,
+	 * regardless of the size of the file.
+	 *
+	 * Tokens are interned by the tokenizer into a private string table, their values are therefore
+	 * passed along with them and imported into the string table of the consumer once the consumer
+	 * releases them. Every stream is terminated by an END_OF_FILE token.
+	 */
+	class token_stream {
+	public:
+		/**
+		 * \param file File which is being tokenized
+		 * \param strings String table of the consumer, receives values of all streamed tokens
+		 * \param symbols Receives keys of all values which weren't present in \b strings before
+		 * \param capacity Maximum number of tokens held by the stream, limits the lookahead
+		 */
+		token_stream(
+			handle<source_file> file,
+			utility::string_table& strings,
+			std::vector<utility::string_table_key>& symbols,
+			u64 capacity = 4096
+		);
+
+		token_stream(const token_stream&) = delete;
+		token_stream& operator=(const token_stream&) = delete;
+
+		// producer
+
+		/**
+		 * \brief Appends a token to the stream, blocks while the stream is full.
+		 * \param info Token to append
+		 * \param value Value of the token, nullptr for tokens without a value
+		 */
+		void push(const token_info& info, const std::string* value = nullptr);
+
+		/**
+		 * \brief Terminates the stream early, used when the producer runs into an error.
+		 */
+		void abort();
+
+		// consumer
+
+		/**
+		 * \brief Retrieves the token at \b index, blocks until it's available. Indices past the
+		 * END_OF_FILE token yield the END_OF_FILE token.
+		 * \param index Absolute index of the token, has to be located in the current window
+		 * \return Token at \b index.
+		 */
+		auto get(u64 index) -> token_info;
+
+		/**
+		 * \brief Releases all tokens preceding \b index, which lets the producer reuse their slots.
+		 * \param index Absolute index of the first token which is still needed
+		 */
+		void release(u64 index);
+
+		/**
+		 * \brief Consumes and releases all remaining tokens, blocks until the producer finishes.
+		 */
+		void drain();
+
+		[[nodiscard]] auto get_source_file() const -> handle<source_file>;
+	private:
+		struct slot {
+			token_info info;
+			bool has_value = false;
+			std::string value;
+		};
+
+		void publish_head();
+		void publish_tail();
+		void import_value(const slot& slot) const;
+	private:
+		handle<source_file> m_file;
+		std::vector<slot> m_slots;
+		u64 m_batch_size;
+
+		// number of tokens published by the producer
+		alignas(64) std::atomic<u64> m_head = 0;
+		// number of tokens released by the consumer
+		alignas(64) std::atomic<u64> m_tail = 0;
+
+		// producer state
+		alignas(64) u64 m_pushed = 0;
+		u64 m_published = 0;
+		u64 m_tail_cache = 0;
+
+		// consumer state
+		alignas(64) u64 m_released = 0;
+		u64 m_head_cache = 0;
+		utility::string_table& m_strings;
+		std::vector<utility::string_table_key>& m_symbols;
+
+		u64 m_end = std::numeric_limits<u64>::max(); // index of the END_OF_FILE token, once seen
+		token_info m_end_token;
+	};
+} // namespace sigma
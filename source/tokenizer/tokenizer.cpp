@@ -2,24 +2,247 @@
 #include <compiler/compiler/compilation_context.h>
 #include <compiler/compiler/diagnostics.h>
 
+#include "tokenizer/scanner.h"
+
 namespace sigma {
-	tokenizer::tokenizer(const std::string& source, handle<filepath> source_path, frontend_context& context) : m_source(source), m_context(context) {
-		m_token_start_location.file = source_path;
-		m_current_location.file = source_path;
+	namespace detail {
+		struct keyword {
+			std::string_view text;
+			token_type type;
+		};
+
+		constexpr keyword keywords[] = {
+			// flow control
+			{ "ret",       token_type::RET                },
+			{ "if",        token_type::IF                 },
+			{ "else",      token_type::ELSE               },
+
+			// other keywords
+			{ "namespace", token_type::NAMESPACE          },
+			{ "cast",      token_type::CAST               },
+			{ "sizeof",    token_type::SIZEOF             },
+			{ "alignof",   token_type::ALIGNOF            },
+
+			// native type keywords
+			{ "i8",        token_type::I8                 },
+			{ "i16",       token_type::I16                },
+			{ "i32",       token_type::I32                },
+			{ "i64",       token_type::I64                },
+			{ "u8",        token_type::U8                 },
+			{ "u16",       token_type::U16                },
+			{ "u32",       token_type::U32                },
+			{ "u64",       token_type::U64                },
+			{ "bool",      token_type::BOOL               },
+			{ "void",      token_type::VOID               },
+			{ "char",      token_type::CHAR               },
+			{ "struct",    token_type::STRUCT             },
+
+			{ "true",      token_type::BOOL_LITERAL_TRUE  },
+			{ "false",     token_type::BOOL_LITERAL_FALSE },
+			{ "null",      token_type::NULL_LITERAL       },
+		};
+
+		// keywords are placed into a perfect hash table, which is generated at compile time
+		constexpr u64 keyword_table_bits = 6;
+		constexpr u64 keyword_table_size = 1ull << keyword_table_bits;
+
+		consteval auto get_max_keyword_length() -> u64 {
+			u64 length = 0;
+
+			for(const keyword& k : keywords) {
+				length = std::max(length, k.text.size());
+			}
+
+			return length;
+		}
+
+		constexpr u64 max_keyword_length = get_max_keyword_length();
+
+		constexpr auto hash_keyword(std::string_view text, u32 seed) -> u64 {
+			// FNV-1a, keywords are short enough for this to be cheap
+			u32 hash = 2166136261u ^ seed;
+
+			for(const char c : text) {
+				hash = (hash ^ static_cast<u8>(c)) * 16777619u;
+			}
+
+			return (hash * 2654435769u) >> (32 - keyword_table_bits);
+		}
+
+		consteval auto find_keyword_seed() -> u32 {
+			for(u32 seed = 0;; ++seed) {
+				bool used[keyword_table_size] = {};
+				bool collision = false;
+
+				for(const keyword& k : keywords) {
+					const u64 slot = hash_keyword(k.text, seed);
+
+					if(used[slot]) {
+						collision = true;
+						break;
+					}
+
+					used[slot] = true;
+				}
+
+				if(!collision) {
+					return seed;
+				}
+			}
+		}
+
+		constexpr u32 keyword_seed = find_keyword_seed();
+
+		consteval auto build_keyword_table() -> std::array<keyword, keyword_table_size> {
+			// empty slots contain an empty string, which never matches an identifier
+			std::array<keyword, keyword_table_size> table = {};
+			table.fill({ "", token_type::UNKNOWN });
+
+			for(const keyword& k : keywords) {
+				table[hash_keyword(k.text, keyword_seed)] = k;
+			}
+
+			return table;
+		}
+
+		constexpr std::array<keyword, keyword_table_size> keyword_table = build_keyword_table();
+	} // namespace detail
+
+	tokenizer::tokenizer(handle<source_file> file, u32 begin, u32 end, utility::string_table& strings)
+		: m_file(file), m_source(file->get_text().substr(0, end)), m_text_begin(file->get_text().data()),
+		m_text_end(file->get_text().data() + end), m_strings(strings) {
+		ASSERT(begin <= end && end <= file->get_text().size(), "invalid tokenizer range");
+		m_source.set_position(begin);
 	}
 
-	auto tokenizer::tokenize(const std::string& source, handle<filepath> source_path, frontend_context& context) -> utility::result<void> {
-		return tokenizer(source, source_path, context).tokenize();
+	tokenizer::tokenizer(handle<source_file> file, u32 begin, u32 end, token_buffer& tokens, utility::string_table& strings)
+		: tokenizer(file, begin, end, strings) {
+		m_tokens = &tokens;
+		m_tokens->set_source_file(file);
+	}
+
+	tokenizer::tokenizer(handle<source_file> file, token_stream& stream, utility::string_table& strings)
+		: tokenizer(file, 0, static_cast<u32>(file->get_text().size()), strings) {
+		m_stream = &stream;
+	}
+
+	auto tokenizer::tokenize(handle<source_file> file, frontend_context& context) -> utility::result<void> {
+		const u32 size = static_cast<u32>(file->get_text().size());
+		return tokenize(file, 0, size, context.tokens, context.syntax.strings);
+	}
+
+	auto tokenizer::tokenize(
+		handle<source_file> file, u32 begin, u32 end, token_buffer& tokens, utility::string_table& strings
+	) -> utility::result<void> {
+		return tokenizer(file, begin, end, tokens, strings).tokenize();
+	}
+
+	auto tokenizer::tokenize(handle<source_file> file, token_stream& stream, utility::string_table& strings) -> utility::result<void> {
+		const auto result = tokenizer(file, stream, strings).tokenize();
+
+		// the consumer is waiting for the end of the stream
+		if(result.has_error()) {
+			stream.abort();
+		}
+
+		return result;
+	}
+
+	auto tokenizer::split(const source_file& file, u64 chunk_size) -> std::vector<u32> {
+		const std::string_view text = file.get_text();
+		std::vector<u32> boundaries = { 0 };
+
+		if(chunk_size == 0 || text.size() <= chunk_size) {
+			boundaries.push_back(static_cast<u32>(text.size()));
+			return boundaries;
+		}
+
+		// walk the file while keeping track of literals and comments, we only look at characters
+		// which can change the lexical state and at line breaks near the preferred boundaries
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+		const char* position = begin;
+		const char* target = begin + chunk_size;
+
+		while(position != end && target < end) {
+			const char* next = scanner::find_literal_or_comment(position, end);
+
+			// if a line break precedes the next literal or comment, we can split right after it
+			if(next > target) {
+				const char* line = scanner::find_newline(std::max(position, target), next);
+
+				if(line != next) {
+					position = line + 1;
+
+					if(position == end) {
+						break;
+					}
+
+					boundaries.push_back(static_cast<u32>(position - begin));
+					target = position + std::min<u64>(chunk_size, static_cast<u64>(end - position));
+					continue;
+				}
+			}
+
+			if(next == end) {
+				break;
+			}
+
+			position = next + 1;
+
+			if(*next == '"') {
+				// skip the string literal, including escape sequences
+				while(true) {
+					position = scanner::find_string_end(position, end);
+
+					if(position == end || *position == '"') {
+						break;
+					}
+
+					position = std::min(position + 2, end);
+				}
+
+				position = std::min(position + 1, end);
+			}
+			else if(*next == '\'') {
+				// character literals contain a single, possibly escaped, character
+				if(position != end && *position == '\\') {
+					position = std::min(position + 1, end);
+				}
+
+				position = std::min(position + 1, end);
+
+				if(position != end && *position == '\'') {
+					++position;
+				}
+			}
+			else if(position != end && *position == '/') {
+				// inline comment, skip to the end of the line, the line break itself is still a
+				// valid boundary, note that get_special_token() starts looking for the line end
+				// one character after the comment, which we have to mirror
+				position = scanner::find_line_end(std::min(position + 2, end), end);
+			}
+		}
+
+		boundaries.push_back(static_cast<u32>(text.size()));
+		return boundaries;
 	}
 
 	auto tokenizer::tokenize() -> utility::result<void> {
 		auto current = token_type::UNKNOWN;
 
 		while (current != token_type::END_OF_FILE) {
+			m_has_value = false;
 			TRY(const token_info info, get_next_token());
 
 			current = info.tok.type;
-			m_context.tokens.add_token(info);
+
+			if(m_stream) {
+				m_stream->push(info, m_has_value ? &m_current_section : nullptr);
+			}
+			else {
+				m_tokens->add_token(info);
+			}
 		}
 
 		return SUCCESS;
@@ -29,15 +252,11 @@ namespace sigma {
 		// consume preceding spaces
 		consume_spaces();
 
-		m_token_start_location.line_index = m_current_location.line_index;
-		m_token_start_location.char_index = m_current_location.char_index - 1;
+		m_token_start = get_last_offset();
 
 		// check for EOF so we don't have to do it in the individual brace checks
 		if(m_source.end()) {
-			return token_info{
-				.tok = { token_type::END_OF_FILE },
-				.location = get_current_location_ptr()
-			};
+			return create_token(token_type::END_OF_FILE);
 		}
 
 		// at this point we have a non-space character
@@ -71,6 +290,17 @@ namespace sigma {
 	}
 
 	void tokenizer::consume_spaces() {
+		if(isspace(m_last_character) && !m_source.end()) {
+			// skip the entire run of whitespace at once
+			const char* next = scanner::skip_whitespace(get_cursor(), m_text_end);
+
+			if(next != m_text_end) {
+				skip_to(next);
+				get_next_char();
+				return;
+			}
+		}
+
 		while (isspace(m_last_character) && !m_source.end()) {
 			get_next_char();
 		}
@@ -116,22 +346,99 @@ namespace sigma {
 			c != '"';
 	}
 
-	auto tokenizer::get_next_char() -> char {
-		m_last_character = m_source.get_advance();
+	auto tokenizer::get_keyword_token(std::string_view text) -> token_type {
+		if(text.size() > detail::max_keyword_length) {
+			return token_type::UNKNOWN;
+		}
+
+		const detail::keyword& candidate = detail::keyword_table[detail::hash_keyword(text, detail::keyword_seed)];
+		return candidate.text == text ? candidate.type : token_type::UNKNOWN;
+	}
 
-		if(m_last_character == '\n') {
-			m_current_location.line_index++;
-			m_current_location.char_index = 0;
+	auto tokenizer::get_special_token_type(std::string_view text) -> token_type {
+		if(text.size() == 1) {
+			switch(text[0]) {
+				case '(':  return token_type::LEFT_PARENTHESIS;
+				case ')':  return token_type::RIGHT_PARENTHESIS;
+				case '{':  return token_type::LEFT_BRACE;
+				case '}':  return token_type::RIGHT_BRACE;
+				case '[':  return token_type::LEFT_BRACKET;
+				case ']':  return token_type::RIGHT_BRACKET;
+				case ',':  return token_type::COMMA;
+				case ';':  return token_type::SEMICOLON;
+				case '\'': return token_type::SINGLE_QUOTE;
+				case '"':  return token_type::DOUBLE_QUOTE;
+				case '%':  return token_type::MODULO;
+				case '/':  return token_type::SLASH;
+				case '*':  return token_type::ASTERISK;
+				case '+':  return token_type::PLUS_SIGN;
+				case '-':  return token_type::MINUS_SIGN;
+				case '=':  return token_type::EQUALS_SIGN;
+				case ':':  return token_type::COLON;
+				case '<':  return token_type::LESS_THAN;
+				case '>':  return token_type::GREATER_THAN;
+				case '!':  return token_type::EXCLAMATION_MARK;
+				case '.':  return token_type::DOT;
+				default:   return token_type::UNKNOWN;
+			}
 		}
-		else {
-			m_current_location.char_index++;
+
+		if(text.size() == 2) {
+			// every two character token is identified by its first character, only the second one
+			// has to be verified
+			switch(text[0]) {
+				case '&': return text[1] == '&' ? token_type::CONJUNCTION           : token_type::UNKNOWN;
+				case '|': return text[1] == '|' ? token_type::DISJUNCTION           : token_type::UNKNOWN;
+				case '/': return text[1] == '/' ? token_type::INLINE_COMMENT        : token_type::UNKNOWN;
+				case '<': return text[1] == '=' ? token_type::LESS_THAN_OR_EQUAL    : token_type::UNKNOWN;
+				case '>': return text[1] == '=' ? token_type::GREATER_THAN_OR_EQUAL : token_type::UNKNOWN;
+				case '=': return text[1] == '=' ? token_type::EQUALS                : token_type::UNKNOWN;
+				case '!': return text[1] == '=' ? token_type::NOT_EQUALS            : token_type::UNKNOWN;
+				default:  return token_type::UNKNOWN;
+			}
 		}
 
+		return token_type::UNKNOWN;
+	}
+
+	auto tokenizer::get_next_char() -> char {
+		m_last_character = m_source.get_advance();
 		return m_last_character;
 	}
 
-	auto tokenizer::get_current_location_ptr() -> handle<token_location> {
-		return m_context.allocator.emplace<token_location>(m_token_start_location);
+	auto tokenizer::intern_value() -> utility::string_table_key {
+		m_has_value = true;
+		return m_strings.insert(m_current_section);
+	}
+
+	auto tokenizer::get_current_location() const -> token_location {
+		return { m_file, m_token_start };
+	}
+
+	auto tokenizer::create_token(token_type type, utility::string_table_key symbol_key) const -> token_info {
+		return token_info{
+			.tok        = { type },
+			.offset     = m_token_start,
+			.length     = get_last_offset() - m_token_start,
+			.symbol_key = symbol_key
+		};
+	}
+
+	void tokenizer::skip_to(const char* position) {
+		ASSERT(get_cursor() <= position && position <= m_text_end, "invalid skip position");
+		m_source.set_position(static_cast<u64>(position - m_text_begin));
+	}
+
+	auto tokenizer::get_last_offset() const -> u32 {
+		// the primed character precedes the source, the cursor may also move past its end
+		const u64 position = m_source.get_position();
+		const u64 size = static_cast<u64>(m_text_end - m_text_begin);
+
+		return static_cast<u32>(std::min(position > 0 ? position - 1 : 0, size));
+	}
+
+	auto tokenizer::get_cursor() const -> const char* {
+		return m_text_begin + m_source.get_position();
 	}
 
 	auto tokenizer::get_alphabetical_token() -> utility::result<token_info> {
@@ -139,6 +446,16 @@ namespace sigma {
 		m_current_section = m_last_character;
 		u8 underscore_chain_count = 0;
 
+		// find the end of the identifier in bulk, identifiers with too many underscores in a row
+		// are left to the loop below, which reports the error
+		const char* identifier_end = scanner::skip_identifier(get_cursor(), m_text_end);
+		const std::string_view identifier(get_cursor() - 1, identifier_end);
+
+		if(identifier.find("___") == std::string_view::npos) {
+			m_current_section = identifier;
+			skip_to(identifier_end);
+		}
+
 		// consume a sequence of alphanumeric characters
 		while(true) {
 			get_next_char();
@@ -150,7 +467,7 @@ namespace sigma {
 			else if (m_last_character == '_') {
 				// allow two underscores right after each other at most
 				if(underscore_chain_count >= 2) {
-					return error::emit(error::code::TOO_MANY_UNDERSCORES, get_current_location_ptr());
+					return error::emit(error::code::TOO_MANY_UNDERSCORES, get_current_location());
 				}
 
 				m_current_section += m_last_character;
@@ -162,21 +479,15 @@ namespace sigma {
 		}
 
 		// check if the value we've extracted is a keyword
-		const auto it = m_keyword_tokens.find(m_current_section);
-		if (it != m_keyword_tokens.end()) {
+		const token_type keyword = get_keyword_token(m_current_section);
+
+		if(keyword != token_type::UNKNOWN) {
 			// the string is a keyword
-			return token_info{
-				.tok      = { it->second },
-				.location = get_current_location_ptr()
-			};
+			return create_token(keyword);
 		}
 
 		// the string isn't a keyword, treat it as an identifier
-		return token_info{
-			.tok        = { token_type::IDENTIFIER },
-			.location   = get_current_location_ptr(),
-			.symbol_key = m_context.syntax.strings.insert(m_current_section)
-		};
+		return create_token(token_type::IDENTIFIER, intern_value());
 	}
 
 	auto tokenizer::get_numerical_token() -> utility::result<token_info> {
@@ -205,9 +516,21 @@ namespace sigma {
 
 		// fallback to regular number formats 
 		while(!std::isspace(m_last_character) && !m_source.end()) {
+			if(std::isdigit(m_last_character)) {
+				// consume the entire run of digits at once
+				const char* digits_end = scanner::skip_digits(get_cursor(), m_text_end);
+
+				if(digits_end != m_text_end) {
+					m_current_section.append(get_cursor() - 1, digits_end);
+					skip_to(digits_end);
+					get_next_char();
+					continue;
+				}
+			}
+
 			if(m_last_character == '.') {
 				if(dot_met) {
-					const handle location = get_current_location_ptr();
+					const token_location location = get_current_location();
 					return error::emit(error::code::NUMERICAL_LITERAL_MORE_THAN_ONE_DOT, location);
 				}
 
@@ -215,29 +538,21 @@ namespace sigma {
 			}
 			else if(m_last_character == 'u') {
 				if(dot_met) {
-					const handle location = get_current_location_ptr();
+					const token_location location = get_current_location();
 					return error::emit(error::code::NUMERICAL_LITERAL_UNSIGNED_WITH_DOT, location);
 				}
 
 				get_next_char();
-				return token_info{
-					.tok        = { token_type::UNSIGNED_LITERAL },
-					.location   = get_current_location_ptr(),
-					.symbol_key = m_context.syntax.strings.insert(m_current_section)
-				};
+				return create_token(token_type::UNSIGNED_LITERAL, intern_value());
 			}
 			else if (m_last_character == 'f') {
 				if(!dot_met) {
-					const handle location = get_current_location_ptr();
+					const token_location location = get_current_location();
 					return error::emit(error::code::NUMERICAL_LITERAL_FP_WITHOUT_DOT, location);
 				}
 
 				get_next_char();
-				return token_info{
-					.tok        = { token_type::F32_LITERAL },
-					.location   = get_current_location_ptr(),
-					.symbol_key = m_context.syntax.strings.insert(m_current_section)
-				};
+				return create_token(token_type::F32_LITERAL, intern_value());
 			}
 			else if(!std::isdigit(m_last_character)) {
 				break;
@@ -249,19 +564,11 @@ namespace sigma {
 
 		// 0.0 format
 		if (dot_met) {
-			return token_info{
-				.tok        = { token_type::F64_LITERAL },
-				.location   = get_current_location_ptr(),
-				.symbol_key = m_context.syntax.strings.insert(m_current_section)
-			};
+			return create_token(token_type::F64_LITERAL, intern_value());
 		}
 
 		// 0 format
-		return token_info{
-			.tok        = { token_type::SIGNED_LITERAL },
-			.location   = get_current_location_ptr(),
-			.symbol_key = m_context.syntax.strings.insert(m_current_section)
-		};
+		return create_token(token_type::SIGNED_LITERAL, intern_value());
 	}
 
 	auto tokenizer::get_string_literal_token() -> utility::result<token_info> {
@@ -269,22 +576,31 @@ namespace sigma {
 		get_next_char(); // read the character after the opening double quote
 
 		while (m_last_character != '"' && !m_source.end()) {
+			if(m_last_character != '\\') {
+				// copy plain characters in bulk, escape sequences and the terminator are handled
+				// one by one
+				const char* plain_end = scanner::find_string_end(get_cursor(), m_text_end);
+
+				if(plain_end != m_text_end) {
+					m_current_section.append(get_cursor() - 1, plain_end);
+					skip_to(plain_end);
+					get_next_char();
+					continue;
+				}
+			}
+
 			m_current_section += get_escaped_character();
 			get_next_char();
 		}
 
 		if(m_last_character != '"') {
-			const handle location = get_current_location_ptr();
+			const token_location location = get_current_location();
 			return error::emit(error::code::INVALID_STRING_TERMINATOR, location);
 		}
 
 		get_next_char();
 
-		return token_info{
-			.tok        = { token_type::STRING_LITERAL },
-			.location   = get_current_location_ptr(),
-			.symbol_key = m_context.syntax.strings.insert(m_current_section)
-		};
+		return create_token(token_type::STRING_LITERAL, intern_value());
 	}
 
 	auto tokenizer::get_char_literal_token() -> utility::result<token_info> {
@@ -293,24 +609,19 @@ namespace sigma {
 		get_next_char(); // read the closing quote
 
 		if(m_last_character != '\'') {
-			const handle location = get_current_location_ptr();
+			const token_location location = get_current_location();
 			return error::emit(error::code::INVALID_CHAR_TERMINATOR, location);
 		}
 
 		get_next_char();
 
-		return token_info{
-			.tok = { token_type::CHARACTER_LITERAL },
-			.location = get_current_location_ptr(),
-			.symbol_key = m_context.syntax.strings.insert(m_current_section)
-		};
+		return create_token(token_type::CHARACTER_LITERAL, intern_value());
 	}
 
 	auto tokenizer::get_special_token() -> utility::result<token_info> {
 		m_current_section = "";
 
 		auto resolved_token = token_type::UNKNOWN;
-		u64 token_length = 0;
 		u64 last_valid_pos = 0;
 
 		// find the longest token that is less < some arbitrary max token len
@@ -318,42 +629,43 @@ namespace sigma {
 			m_current_section += m_last_character;
 			m_last_character = m_source.get_advance();
 
-			const auto it = m_special_tokens.find(m_current_section);
+			const token_type type = get_special_token_type(m_current_section);
 
-			if(it != m_special_tokens.end()) {
-				resolved_token = it->second;
-				token_length = m_current_section.size();
+			if(type != token_type::UNKNOWN) {
+				resolved_token = type;
 				last_valid_pos = m_source.get_position();
 			}
 		}
 
 		if(resolved_token == token_type::UNKNOWN) {
-			const handle location = get_current_location_ptr();
+			const token_location location = get_current_location();
 			const std::string section = utility::escape_string(m_current_section);
 
 			return error::emit(error::code::UNKNOWN_SPECIAL_TOKEN, location, section);
 		}
 
-		// correct the position
-		// we don't have to correct the line position, since tokens can't be multiline
-		m_current_location.char_index += static_cast<u32>(token_length - 1);
-
 		// go to the last valid token
 		m_source.set_position(last_valid_pos - 1);
 		get_next_char();
 
 		if(resolved_token == token_type::INLINE_COMMENT) {
-			// ignore all remaining data on the current line
-			do {
+			// ignore all remaining data on the current line, a comment at the very end of the
+			// file leaves the cursor past the text
+			const char* line_end = m_source.end() ? m_text_end : scanner::find_line_end(get_cursor(), m_text_end);
+
+			if(line_end != m_text_end) {
+				skip_to(line_end);
 				get_next_char();
-			} while (!m_source.end() && m_last_character != '\n' && m_last_character != '\r');
+			}
+			else {
+				do {
+					get_next_char();
+				} while (!m_source.end() && m_last_character != '\n' && m_last_character != '\r');
+			}
 
 			return get_next_token(); // return the following token
 		}
 
-		return token_info{
-			.tok = { resolved_token },
-			.location = get_current_location_ptr()
-		};
+		return create_token(resolved_token);
 	}
 } // namespace sigma::lex
@@ -1,17 +1,67 @@
 #pragma once
-#include <utility/string/string_accessor.h>
-
 #include "tokenizer/token_buffer.h"
+#include "tokenizer/token_stream.h"
+#include "tokenizer/source_cursor.h"
+#include "tokenizer/source_file.h"
 
 namespace sigma {
 	struct frontend_context;
 
 	class tokenizer {
 	public:
-		tokenizer(const std::string& source, handle<filepath> source_path, frontend_context& context);
-		[[nodiscard]] static auto tokenize(const std::string& source, handle<filepath> source_path, frontend_context& context) -> utility::result<void>;
+		tokenizer(handle<source_file> file, u32 begin, u32 end, token_buffer& tokens, utility::string_table& strings);
+		tokenizer(handle<source_file> file, token_stream& stream, utility::string_table& strings);
+
+		/**
+		 * \brief Tokenizes the entire \b file into \b context.
+		 * \param file File to tokenize
+		 * \param context Frontend context which receives the tokens and their values
+		 * \return Error, if the file contains an invalid token.
+		 */
+		[[nodiscard]] static auto tokenize(handle<source_file> file, frontend_context& context) -> utility::result<void>;
+
+		/**
+		 * \brief Tokenizes the range [\b begin, \b end) of \b file. The range has to be delimited by
+		 * boundaries returned by split(), tokens still refer to the file by absolute offsets.
+		 * \param file File to tokenize
+		 * \param begin Offset of the first character to tokenize
+		 * \param end Offset of the end of the range
+		 * \param tokens Token buffer which receives the tokens, terminated by an END_OF_FILE token
+		 * \param strings String table which receives the values of the tokens
+		 * \return Error, if the range contains an invalid token.
+		 */
+		[[nodiscard]] static auto tokenize(
+			handle<source_file> file, u32 begin, u32 end, token_buffer& tokens, utility::string_table& strings
+		) -> utility::result<void>;
+
+		/**
+		 * \brief Tokenizes the entire \b file into \b stream, meant to be run on a separate thread
+		 * while the stream is being consumed. The stream is always terminated, even if an error
+		 * occurs.
+		 * \param file File to tokenize
+		 * \param stream Stream which receives the tokens
+		 * \param strings String table used for interning token values, has to be private to the
+		 * tokenizer, values are passed to the consumer through the stream
+		 * \return Error, if the file contains an invalid token.
+		 */
+		[[nodiscard]] static auto tokenize(
+			handle<source_file> file, token_stream& stream, utility::string_table& strings
+		) -> utility::result<void>;
+
+		/**
+		 * \brief Splits \b file into ranges of roughly \b chunk_size characters, which can be tokenized
+		 * independently of each other. Ranges start at the beginning of a line, which isn't located
+		 * in a string literal, a character literal or a comment.
+		 * \param file File to split
+		 * \param chunk_size Preferred size of a single range
+		 * \return Boundaries of the individual ranges, including 0 and the size of the file.
+		 */
+		[[nodiscard]] static auto split(const source_file& file, u64 chunk_size) -> std::vector<u32>;
+
 		[[nodiscard]] auto tokenize() -> utility::result<void>;
 	private:
+		tokenizer(handle<source_file> file, u32 begin, u32 end, utility::string_table& strings);
+
 		[[nodiscard]] auto get_next_token() -> utility::result<token_info>;
 		[[nodiscard]] auto get_alphabetical_token() -> utility::result<token_info>;
 		[[nodiscard]] auto get_numerical_token() -> utility::result<token_info>;
@@ -23,80 +73,67 @@ namespace sigma {
 		auto get_escaped_character() -> char;
 		static auto is_special(char c) -> bool;
 
+		/**
+		 * \brief Looks up the keyword represented by \b text.
+		 * \param text Text to look up
+		 * \return Type of the keyword, token_type::UNKNOWN if \b text isn't a keyword.
+		 */
+		static auto get_keyword_token(std::string_view text) -> token_type;
+
+		/**
+		 * \brief Looks up the special token (operators, punctuators) represented by \b text.
+		 * \param text Text to look up, special tokens are at most 2 characters long
+		 * \return Type of the special token, token_type::UNKNOWN if \b text isn't a special token.
+		 */
+		static auto get_special_token_type(std::string_view text) -> token_type;
+
 		auto get_next_char() -> char;
-		auto get_current_location_ptr() -> handle<token_location>;
+
+		/**
+		 * \brief Interns the current section as the value of the current token.
+		 * \return Key of the interned value.
+		 */
+		auto intern_value() -> utility::string_table_key;
+		auto get_current_location() const -> token_location;
+
+		/**
+		 * \brief Creates a token record spanning from the start of the current token to the cursor.
+		 * \param type Type of the token
+		 * \param symbol_key Key of the value associated with the token, if any
+		 * \return Token record of the current token.
+		 */
+		auto create_token(token_type type, utility::string_table_key symbol_key = {}) const -> token_info;
+
+		/**
+		 * \brief Skips all characters up to \b position in bulk, the character at \b position will be
+		 * the next one returned by get_next_char().
+		 * \param position Position to skip to, has to be located after the cursor
+		 */
+		void skip_to(const char* position);
+		auto get_cursor() const -> const char*;
+
+		/**
+		 * \brief Retrieves the offset of the last character returned by get_next_char().
+		 */
+		auto get_last_offset() const -> u32;
 	private:
-		token_location m_current_location = { 0, 0 };
-		token_location m_token_start_location; // start location of the current token
+		handle<source_file> m_file;
+		u32 m_token_start = 0; // offset of the first character of the current token
 
 		std::string m_current_section;
 		char m_last_character = ' '; // prime with a space character
 
-		utility::string_accessor m_source;
-		frontend_context& m_context;
-
-		// keywords
-		const std::unordered_map<std::string, token_type> m_keyword_tokens = {
-			// flow control
-			{ "ret",       token_type::RET                },
-			{ "if",        token_type::IF                 },
-			{ "else",      token_type::ELSE               },
-
-			// other keywords
-			{ "namespace", token_type::NAMESPACE          },
-			{ "cast",      token_type::CAST               },
-			{ "sizeof",    token_type::SIZEOF             },
-			{ "alignof",   token_type::ALIGNOF            },
-
-			// native type keywords
-			{ "i8",        token_type::I8                 },
-			{ "i16",       token_type::I16                },
-			{ "i32",       token_type::I32                },
-			{ "i64",       token_type::I64                },
-			{ "u8",        token_type::U8                 },
-			{ "u16",       token_type::U16                },
-			{ "u32",       token_type::U32                },
-			{ "u64",       token_type::U64                },
-			{ "bool",      token_type::BOOL               },
-			{ "void",      token_type::VOID               },
-			{ "char",      token_type::CHAR               },
-			{ "struct",    token_type::STRUCT             },
-
-			{ "true",      token_type::BOOL_LITERAL_TRUE  },
-			{ "false",     token_type::BOOL_LITERAL_FALSE },
-			{ "null",      token_type::NULL_LITERAL       },
-		};
-
-		const std::unordered_map<std::string, token_type> m_special_tokens = {
-			{ "(" ,  token_type::LEFT_PARENTHESIS      },
-			{ ")" ,  token_type::RIGHT_PARENTHESIS     },
-			{ "{" ,  token_type::LEFT_BRACE            },
-			{ "}" ,  token_type::RIGHT_BRACE           },
-			{ "[" ,  token_type::LEFT_BRACKET          },
-			{ "]" ,  token_type::RIGHT_BRACKET         },
-			{ "," ,  token_type::COMMA                 },
-			{ ";" ,  token_type::SEMICOLON             },
-			{ "'" ,  token_type::SINGLE_QUOTE          },
-			{ "\"" , token_type::DOUBLE_QUOTE          },
-			{ "%" ,  token_type::MODULO                },
-			{ "/" ,  token_type::SLASH                 },
-			{ "*" ,  token_type::ASTERISK              },
-			{ "+" ,  token_type::PLUS_SIGN             },
-			{ "-" ,  token_type::MINUS_SIGN            },
-			{ "=" ,  token_type::EQUALS_SIGN           },
-			{ ":" ,  token_type::COLON                 },
-			{ "<" ,  token_type::LESS_THAN             },
-			{ ">" ,  token_type::GREATER_THAN          },
-			{ "!" ,  token_type::EXCLAMATION_MARK      },
-			{ "." ,  token_type::DOT                   },
-
-			{ "&&",  token_type::CONJUNCTION           },
-			{ "||",  token_type::DISJUNCTION           },
-			{ "//",  token_type::INLINE_COMMENT        },
-			{ "<=",  token_type::LESS_THAN_OR_EQUAL    },
-			{ ">=",  token_type::GREATER_THAN_OR_EQUAL },
-			{ "==",  token_type::EQUALS                },
-			{ "!=",  token_type::NOT_EQUALS            },
-		};
+		source_cursor m_source;
+
+		// raw view of the source, used for scanning larger blocks of characters at once
+		const char* m_text_begin;
+		const char* m_text_end;
+
+		// tokens are either written into a buffer, or into a stream
+		token_buffer* m_tokens = nullptr;
+		token_stream* m_stream = nullptr;
+
+		utility::string_table& m_strings;
+		bool m_has_value = false; // set if the current token has a value
 	};
 } // namespace sigma
@@ -1,69 +1,171 @@
 #include "type_checker.h"
 #include <compiler/compiler/compilation_context.h>
 #include <compiler/compiler/diagnostics.h>
+#include <compiler/compiler/thread_pool.h>
+#include <utility/diagnostics.h>
 
 namespace sigma {
-	auto type_checker::type_check(backend_context& context) -> utility::result<void> {
-		return type_checker(context).type_check();
+	namespace detail {
+		void print_warnings(const std::vector<std::string>& warnings) {
+			for(const std::string& warning : warnings) {
+				utility::console::print("{}\n", warning);
+			}
+		}
+	} // namespace detail
+
+	auto type_checker::type_check(backend_context& context, thread_pool& pool) -> utility::result<void> {
+		// collect all declarations, function bodies are skipped
+		type_checker declarations(context, context.semantics, context.syntax.ast.get_allocator());
+		const auto result = declarations.type_check_declarations();
+
+		// type check function bodies, declarations aren't modified anymore, every body only touches
+		// its own scopes and nodes
+		std::vector<function_task>& functions = declarations.m_functions;
+
+		pool.parallel_for(functions.size(), [&](u64 index) {
+			function_task& task = functions[index];
+
+			semantic_context semantics(context.semantics, task.scope, *task.allocator, context.builder);
+			type_checker checker(context, semantics, *task.allocator);
+			const auto body_result = checker.type_check_function_body(task.function);
+
+			if(body_result.has_error()) {
+				task.error = body_result.get_error();
+			}
+
+			task.warnings = std::move(checker.m_warnings);
+		});
+
+		// report diagnostics in declaration order, so that they don't depend on the order in which
+		// the bodies were type checked, bodies always precede the declaration error (if any)
+		detail::print_warnings(declarations.m_warnings);
+
+		for(const function_task& task : functions) {
+			detail::print_warnings(task.warnings);
+
+			if(task.error.has_value()) {
+				return task.error.value();
+			}
+		}
+
+		return result;
 	}
 
-	type_checker::type_checker(backend_context& context) : m_context(context) {}
+	type_checker::type_checker(backend_context& context, semantic_context& semantics, utility::block_allocator& allocator)
+		: m_context(context), m_semantics(semantics), m_allocator(allocator) {}
 
-	auto type_checker::type_check() -> utility::result<void> {
+	auto type_checker::type_check_declarations() -> utility::result<void> {
 		for(const ast_node& top_level : m_context.syntax.ast.get_nodes()) {
-			// type check all nodes
+			// type check all nodes, function declarations register their bodies in m_functions
 			TRY(type_check_node(top_level, nullptr));
 		}
 
 		return SUCCESS;
 	}
 
+	auto type_checker::type_check_function_body(ast_node function_node) -> utility::result<void> {
+		m_current_function = function_node->get<ast::function>().signature;
+
+		// type check inner statements
+		for(u16 i = 0; i < function_node->children.get_size(); ++i) {
+			TRY(type_check_node(function_node->children[i], function_node));
+		}
+
+		return m_semantics.verify_control_flow(function_node);
+	}
+
 	auto type_checker::type_check_node(ast_node target, ast_node parent, type expected) -> type_check_result {
-		switch(target->type) {
-			// declarations
-			case ast::node_type::NAMESPACE_DECLARATION:          return type_check_namespace_declaration(target);
-			case ast::node_type::FUNCTION_DECLARATION:           return type_check_function_declaration(target);
-			case ast::node_type::VARIABLE_DECLARATION:           return type_check_variable_declaration(target);
-			case ast::node_type::STRUCT_DECLARATION:             return type_check_struct_declaration(target);
+		m_frames.push_back({ target, parent, expected, 0, m_results.size() });
 
-			// literals
-			case ast::node_type::NUMERICAL_LITERAL:              return type_check_numerical_literal(target, expected);
-			case ast::node_type::CHARACTER_LITERAL:              return type_check_character_literal(target, parent, expected);
-			case ast::node_type::STRING_LITERAL:                 return type_check_string_literal(target, parent, expected);
-			case ast::node_type::BOOL_LITERAL:                   return type_check_bool_literal(target, parent, expected);
+		while(true) {
+			frame& current = m_frames.back();
+			TRY(const step next, type_check_step(current));
+
+			if(next.child) {
+				// type check the requested child first, its type is passed along via the result stack
+				current.stage++;
+				m_frames.push_back({ next.child, next.parent, next.value, 0, m_results.size() });
+				continue;
+			}
+
+			// the node is finished, the types of its children aren't needed anymore
+			m_results.resize(current.results_begin);
+			m_frames.pop_back();
+
+			if(m_frames.empty()) {
+				return next.value;
+			}
+
+			m_results.push_back(next.value);
+		}
+	}
+
+	auto type_checker::type_check_step(frame& current) -> step_result {
+		switch(current.target->type) {
+			// declarations
+			case ast::node_type::NAMESPACE_DECLARATION:          return type_check_namespace_declaration(current);
 
 			// expressions
 			case ast::node_type::OPERATOR_ADD:
 			case ast::node_type::OPERATOR_SUBTRACT:
 			case ast::node_type::OPERATOR_MULTIPLY:
 			case ast::node_type::OPERATOR_DIVIDE:
-			case ast::node_type::OPERATOR_MODULO:                return type_check_binary_math_operator(target, expected);
+			case ast::node_type::OPERATOR_MODULO:                return type_check_binary_math_operator(current);
 			case ast::node_type::OPERATOR_GREATER_THAN_OR_EQUAL:
 			case ast::node_type::OPERATOR_LESS_THAN_OR_EQUAL:
 			case ast::node_type::OPERATOR_GREATER_THAN:
 			case ast::node_type::OPERATOR_NOT_EQUAL:
 			case ast::node_type::OPERATOR_LESS_THAN:
-			case ast::node_type::OPERATOR_EQUAL:                 return type_check_binary_comparison_operator(target, parent, expected);
+			case ast::node_type::OPERATOR_EQUAL:                 return type_check_binary_comparison_operator(current);
 			case ast::node_type::OPERATOR_CONJUNCTION:           
-			case ast::node_type::OPERATOR_DISJUNCTION:           return type_check_predicate_operator(target, parent, expected);
-			case ast::node_type::OPERATOR_LOGICAL_NOT:           return type_check_not_operator(target, parent, expected);
+			case ast::node_type::OPERATOR_DISJUNCTION:           return type_check_predicate_operator(current);
+			case ast::node_type::OPERATOR_LOGICAL_NOT:           return type_check_not_operator(current);
 
 			// statements
-			case ast::node_type::RETURN:                         return type_check_return(target);
-			case ast::node_type::CONDITIONAL_BRANCH:             return type_check_conditional_branch(target);
-			case ast::node_type::BRANCH:                         return type_check_branch(target);
+			case ast::node_type::RETURN:                         return type_check_return(current);
+			case ast::node_type::CONDITIONAL_BRANCH:             return type_check_conditional_branch(current);
+			case ast::node_type::BRANCH:                         return type_check_branch(current);
 
 			// loads / stores
-			case ast::node_type::VARIABLE_ACCESS:                return type_check_variable_access(target, parent, expected);
-			case ast::node_type::ARRAY_ACCESS:                   return type_check_array_access(target, parent, expected);
-			case ast::node_type::LOCAL_MEMBER_ACCESS:            return type_check_local_member_access(target, parent, expected);
-			case ast::node_type::LOAD:                           return type_check_load(target, expected);
-			case ast::node_type::STORE:                          return type_check_store(target);
+			case ast::node_type::ARRAY_ACCESS:                   return type_check_array_access(current);
+			case ast::node_type::LOCAL_MEMBER_ACCESS:            return type_check_local_member_access(current);
+			case ast::node_type::LOAD:                           return type_check_load(current);
+			case ast::node_type::STORE:                          return type_check_store(current);
 
 			// other
-			case ast::node_type::FUNCTION_CALL:                  return type_check_function_call(target, parent, expected);
+			case ast::node_type::FUNCTION_CALL:                  return type_check_function_call(current);
 			// since implicit casts are not type checked we can interpret these casts a being explicit
-			case ast::node_type::CAST:                           return type_check_explicit_cast(target, parent, expected);
+			case ast::node_type::CAST:                           return type_check_explicit_cast(current);
+
+			default: {
+				// nodes without children are type checked in a single step
+				TRY(const type result, type_check_leaf(current));
+				return finish(result);
+			}
+		}
+	}
+
+	auto type_checker::type_check_leaf(const frame& current) -> type_check_result {
+		const ast_node target = current.target;
+		const ast_node parent = current.parent;
+		const type expected = current.expected;
+
+		switch(target->type) {
+			// declarations
+			case ast::node_type::FUNCTION_DECLARATION:           return type_check_function_declaration(target);
+			case ast::node_type::VARIABLE_DECLARATION:           return type_check_variable_declaration(target);
+			case ast::node_type::STRUCT_DECLARATION:             return type_check_struct_declaration(target);
+
+			// literals
+			case ast::node_type::NUMERICAL_LITERAL:              return type_check_numerical_literal(target, expected);
+			case ast::node_type::CHARACTER_LITERAL:              return type_check_character_literal(target, parent, expected);
+			case ast::node_type::STRING_LITERAL:                 return type_check_string_literal(target, parent, expected);
+			case ast::node_type::BOOL_LITERAL:                   return type_check_bool_literal(target, parent, expected);
+
+			// loads / stores
+			case ast::node_type::VARIABLE_ACCESS:                return type_check_variable_access(target, parent, expected);
+
+			// other
 			case ast::node_type::ALIGNOF:                        return type_check_alignof(target, parent, expected);
 			case ast::node_type::SIZEOF:                         return type_check_sizeof(target, parent, expected);
 
@@ -74,56 +176,77 @@ namespace sigma {
 		return type::create_unknown(); // unreachable
 	}
 
-	auto type_checker::type_check_namespace_declaration(ast_node declaration) -> type_check_result {
-		const ast::named_expression& namespace_scope = declaration->get<ast::named_expression>();
-		m_context.semantics.push_namespace(namespace_scope.key);
+	auto type_checker::visit(ast_node child, ast_node parent, type expected) -> step {
+		return { .child = child, .parent = parent, .value = expected };
+	}
+
+	auto type_checker::finish(type result) -> step {
+		return { .value = result };
+	}
+
+	auto type_checker::get_result(const frame& current, u64 index) const -> type {
+		ASSERT(current.results_begin + index < m_results.size(), "child hasn't been type checked yet");
+		return m_results[current.results_begin + index];
+	}
+
+	auto type_checker::type_check_namespace_declaration(frame& declaration) -> step_result {
+		const ast_node node = declaration.target;
+
+		if(declaration.stage == 0) {
+			const ast::named_expression& namespace_scope = node->get<ast::named_expression>();
+			m_semantics.push_namespace(namespace_scope.key);
+		}
 
 		// traverse inner statements (globals, functions, namespaces)
-		for(const ast_node statement : declaration->children) {
-			TRY(type_check_node(statement, declaration));
+		if(declaration.stage < node->children.get_size()) {
+			return visit(node->children[declaration.stage], node);
 		}
 
-		m_context.semantics.pop_scope();
-		return type::create_unknown(); // not used
+		m_semantics.pop_scope();
+		return finish(type::create_unknown()); // not used
 	}
 
 	auto type_checker::type_check_function_declaration(ast_node declaration) -> type_check_result {
 		ast::function& function = declaration->get<ast::function>();
 
+		// parameter types are a part of the key the function is registered under, resolve them
+		// before the function is registered, so that the key doesn't change afterwards
+		for(named_data_type& parameter : function.signature.parameter_types) {
+			TRY(m_semantics.resolve_type(parameter.type, declaration->location));
+		}
+
 		// check if the function hasn't been declared before
-		if(m_context.semantics.contains_function(function.signature)) {
+		if(m_semantics.contains_function(function.signature)) {
 			const std::string& identifier = m_context.syntax.strings.get(function.signature.identifier_key);
 			return error::emit(error::code::FUNCTION_ALREADY_DECLARED, declaration->location, identifier);
 		}
 
 		// register the function
-		m_context.semantics.pre_declare_local_function(function.signature);
-		m_context.semantics.push_scope(scope::control_type::UNCONDITIONAL);
-		m_current_function = function.signature;
+		m_semantics.pre_declare_local_function(function.signature);
+		m_semantics.push_scope(scope::control_type::UNCONDITIONAL);
 
 		// push temporaries for function parameters
-		for(named_data_type& parameter : function.signature.parameter_types) {
-			TRY(m_context.semantics.resolve_type(parameter.type, declaration->location));
-
-			auto& variable = m_context.semantics.pre_declare_variable(parameter.identifier_key, parameter.type);
+		for(const named_data_type& parameter : function.signature.parameter_types) {
+			auto& variable = m_semantics.pre_declare_variable(parameter.identifier_key, parameter.type);
 			variable.flags |= variable::FUNCTION_PARAMETER | variable::LOCAL;
 		}
 
-		// type check inner statements
-		for(const ast_node& statement : declaration->children) {
-			TRY(type_check_node(statement, declaration));
-		}
+		// the body is type checked once all declarations are known
+		m_functions.push_back({
+			.function = declaration,
+			.scope = m_semantics.get_active_scope(),
+			.allocator = &m_context.syntax.ast.create_region()
+		});
 
-		TRY(m_context.semantics.verify_control_flow(declaration));
-		m_context.semantics.pop_scope();
+		m_semantics.pop_scope();
 
 		// this value won't be used
 		return type::create_unknown();
 	}
 
-	auto type_checker::type_check_variable_declaration(ast_node declaration) const -> type_check_result {
+	auto type_checker::type_check_variable_declaration(ast_node declaration) -> type_check_result {
 		ast::named_type_expression& variable = declaration->get<ast::named_type_expression>();
-		TRY(m_context.semantics.resolve_type(variable.type, declaration->location));
+		TRY(m_semantics.resolve_type(variable.type, declaration->location));
 
 		// we cannot declare purely 'void' variables
 		if(variable.type.is_pure_void()) {
@@ -132,149 +255,200 @@ namespace sigma {
 		}
 
 		// check, whether the variable has already been declared in the current context
-		if(m_context.semantics.contains_variable(variable.key)) {
+		if(m_semantics.contains_variable(variable.key)) {
 			const std::string& identifier_str = m_context.syntax.strings.get(variable.key);
 			return error::emit(error::code::VARIABLE_ALREADY_DECLARED, declaration->location, identifier_str);
 		}
 
 		// register the variable
-		auto& var = m_context.semantics.pre_declare_variable(variable.key, variable.type);
+		auto& var = m_semantics.pre_declare_variable(variable.key, variable.type);
 		var.flags |= variable::LOCAL; // mark it as a local variable
 
 		return variable.type;
 	}
 
-	auto type_checker::type_check_function_call(ast_node call, ast_node parent, type expected) -> type_check_result {
-		std::vector<type> parameters(call->children.get_size());
-		ast::function_call& function_call = call->get<ast::function_call>();
+	auto type_checker::type_check_function_call(frame& call) -> step_result {
+		const ast_node node = call.target;
+		const u16 parameter_count = node->children.get_size();
 
 		// type check all parameters and store their inherent type
-		for(u64 i = 0; i < parameters.size(); ++i) {
-			TRY(parameters[i], type_check_node(call->children[i], call));
+		if(call.stage < parameter_count) {
+			return visit(node->children[call.stage], node);
+		}
+
+		std::vector<type> parameters(parameter_count);
+		ast::function_call& function_call = node->get<ast::function_call>();
+
+		for(u16 i = 0; i < parameter_count; ++i) {
+			parameters[i] = get_result(call, i);
 			ASSERT(!parameters[i].is_unknown(), "unknown parameter type detected");
 		}
 
 		// at this point the function signature is empty, we gotta find a valid one
-		TRY(function_call.signature, m_context.semantics.find_callee_signature(call, parameters));
+		TRY(function_call.signature, m_semantics.find_callee_signature(node, parameters));
 
 		// we've found a valid function, upcast all provided parameters to the expected types
 		// upcast regular parameters
 		u64 i = 0;
 		for(; i < function_call.signature.parameter_types.get_size(); ++i) {
-			const ast_node target = call->children[i];
+			const ast_node target = node->children[i];
 			const type type = function_call.signature.parameter_types[i].type;
 
-			TRY(implicit_type_cast(parameters[i], type, call, target));
+			TRY(implicit_type_cast(parameters[i], type, node, target));
 		}
 
 		// upcast var parameters
-		for(; i < call->children.get_size(); ++i) {
-			const ast_node target = call->children[i];
+		for(; i < node->children.get_size(); ++i) {
+			const ast_node target = node->children[i];
 
-			TRY(implicit_type_cast(parameters[i], type::create_promote(), call, target));
+			TRY(implicit_type_cast(parameters[i], type::create_promote(), node, target));
 		}
 
-		ASSERT(i == call->children.get_size(), "invalid parameter count");
+		ASSERT(i == node->children.get_size(), "invalid parameter count");
 
 		// pass the return type along
-		return implicit_type_cast(function_call.signature.return_type, expected, parent, call);
+		TRY(const type return_type, implicit_type_cast(function_call.signature.return_type, call.expected, call.parent, node));
+		return finish(return_type);
 	}
 
-	auto type_checker::type_check_return(ast_node statement) -> type_check_result {
-		if (statement->children.get_size() == 0) {
+	auto type_checker::type_check_return(frame& statement) -> step_result {
+		const ast_node node = statement.target;
+
+		if(statement.stage == 1) {
+			// the returned value has been type checked
+			m_semantics.declare_return();
+			return finish(type::create_unknown());
+		}
+
+		if (node->children.get_size() == 0) {
 			// return an empty
 			// verify that the parent function expects an empty return type
 			if(!m_current_function.return_type.is_pure_void()) {
-				return error::emit(error::code::UNEXPECTED_EMPTY_VOID_RET, statement->location);
+				return error::emit(error::code::UNEXPECTED_EMPTY_VOID_RET, node->location);
 			}
+
+			// this value won't be used
+			return finish(type::create_unknown());
 		}
-		else {
-			// verify that the parent function expects a return type
-			if(m_current_function.return_type.is_pure_void()) {
-				return error::emit(error::code::UNEXPECTED_NON_EMPTY_VOID_RET, statement->location);
-			}
 
-			// return a value
-			TRY(type_check_node(statement->children[0], statement, m_current_function.return_type));
-			m_context.semantics.declare_return();
+		// verify that the parent function expects a return type
+		if(m_current_function.return_type.is_pure_void()) {
+			return error::emit(error::code::UNEXPECTED_NON_EMPTY_VOID_RET, node->location);
 		}
 
-		// this value won't be used
-		return type::create_unknown();
+		// return a value
+		return visit(node->children[0], node, m_current_function.return_type);
 	}
 
-	auto type_checker::type_check_conditional_branch(ast_node branch) -> type_check_result {
+	auto type_checker::type_check_conditional_branch(frame& branch) -> step_result {
+		const ast_node node = branch.target;
+
 		// type check the condition
-		TRY(type_check_node(branch->children[0], branch, type::create_bool()));
+		if(branch.stage == 0) {
+			return visit(node->children[0], node, type::create_bool());
+		}
+
+		if(branch.stage == 1) {
+			// if children[1] exists, we have a child branch node
+			if(node->children[1]) {
+				// type check another conditional branch
+				ASSERT(node->children[1]->is_branch(), "cannot branch to a non-branch node");
+				return visit(node->children[1], nullptr);
+			}
 
-		// if children[1] exists, we have a child branch node
-		if (branch->children[1]) {
-			// type check another conditional branch
-			ASSERT(branch->children[1]->is_branch(), "cannot branch to a non-branch node");
-			TRY(type_check_node(branch->children[1], nullptr));
+			// no child branch, continue with inner statements
+			branch.stage++;
 		}
 
-		m_context.semantics.push_scope(scope::control_type::CONDITIONAL);
+		if(branch.stage == 2) {
+			m_semantics.push_scope(scope::control_type::CONDITIONAL);
+		}
 
 		// type check inner statements
-		for (u16 i = 2; i < branch->children.get_size(); ++i) {
-			TRY(type_check_node(branch->children[i], branch));
+		if(branch.stage < node->children.get_size()) {
+			return visit(node->children[branch.stage], node);
 		}
 
-		m_context.semantics.pop_scope();
+		m_semantics.pop_scope();
 
 		// this value won't be used
-		return type::create_unknown();
+		return finish(type::create_unknown());
 	}
 
-	auto type_checker::type_check_branch(ast_node branch) -> type_check_result {
-		m_context.semantics.push_scope(scope::control_type::UNCONDITIONAL);
+	auto type_checker::type_check_branch(frame& branch) -> step_result {
+		const ast_node node = branch.target;
+
+		if(branch.stage == 0) {
+			m_semantics.push_scope(scope::control_type::UNCONDITIONAL);
+		}
 
 		// just type check all inner statements
-		for (const ast_node& statement : branch->children) {
-			TRY(type_check_node(statement, branch));
+		if(branch.stage < node->children.get_size()) {
+			return visit(node->children[branch.stage], node);
 		}
 
-		m_context.semantics.pop_scope();
+		m_semantics.pop_scope();
 
 		// this value won't be used
-		return type::create_unknown();
+		return finish(type::create_unknown());
 	}
 
-	auto type_checker::type_check_binary_math_operator(ast_node binop, type expected) -> type_check_result {
+	auto type_checker::type_check_binary_math_operator(frame& binop) -> step_result {
+		const ast_node node = binop.target;
+
 		// type check both operands
-		TRY(const type left, type_check_node(binop->children[0], binop, expected)); // left
-		TRY(const type right, type_check_node(binop->children[1], binop, expected)); // right
+		switch(binop.stage) {
+			case 0: return visit(node->children[0], node, binop.expected); // left
+			case 1: return visit(node->children[1], node, binop.expected); // right
+			default: break;
+		}
+
+		const type left = get_result(binop, 0);
+		const type right = get_result(binop, 1);
 
 		// upcast both types
 		const type larger_type = detail::get_larger_type(left, right);
 
-		TRY(implicit_type_cast(left, larger_type, binop, binop->children[0]));
-		TRY(implicit_type_cast(right, larger_type, binop, binop->children[1]));
+		TRY(implicit_type_cast(left, larger_type, node, node->children[0]));
+		TRY(implicit_type_cast(right, larger_type, node, node->children[1]));
 
-		return larger_type;
+		return finish(larger_type);
 	}
 
-	auto type_checker::type_check_predicate_operator(ast_node binop, ast_node parent, type expected) -> type_check_result {
+	auto type_checker::type_check_predicate_operator(frame& binop) -> step_result {
+		const ast_node node = binop.target;
+
 		// type check both operands
-		TRY(type_check_node(binop->children[0], binop, type::create_bool())); // left
-		TRY(type_check_node(binop->children[1], binop, type::create_bool())); // right
+		switch(binop.stage) {
+			case 0: return visit(node->children[0], node, type::create_bool()); // left
+			case 1: return visit(node->children[1], node, type::create_bool()); // right
+			default: break;
+		}
 
-		return implicit_type_cast(type::create_bool(), expected, parent, binop);
+		TRY(const type result, implicit_type_cast(type::create_bool(), binop.expected, binop.parent, node));
+		return finish(result);
 	}
 
-	auto type_checker::type_check_binary_comparison_operator(ast_node binop, ast_node parent, type expected) -> type_check_result {
+	auto type_checker::type_check_binary_comparison_operator(frame& binop) -> step_result {
+		const ast_node node = binop.target;
+
 		// type check both operands
-		TRY(const type left, type_check_node(binop->children[0], binop)); // left
-		TRY(const type right, type_check_node(binop->children[1], binop)); // right
+		switch(binop.stage) {
+			case 0: return visit(node->children[0], node); // left
+			case 1: return visit(node->children[1], node); // right
+			default: break;
+		}
+
+		const type left = get_result(binop, 0);
+		const type right = get_result(binop, 1);
 
 		// upcast both types
 		const type larger_type = detail::get_larger_type(left, right);
 
-		TRY(implicit_type_cast(left, larger_type, binop, binop->children[0]));
-		TRY(implicit_type_cast(right, larger_type, binop, binop->children[1]));
+		TRY(implicit_type_cast(left, larger_type, node, node->children[0]));
+		TRY(implicit_type_cast(right, larger_type, node, node->children[1]));
 
-		ast::comparison_expression& expression = binop->get<ast::comparison_expression>();
+		ast::comparison_expression& expression = node->get<ast::comparison_expression>();
 
 		// determine the type of our comparison op
 		if(larger_type.is_pointer()) {
@@ -290,49 +464,68 @@ namespace sigma {
 			expression.type = ast::comparison_expression::type::INTEGRAL_UNSIGNED;
 		}
 
-		return implicit_type_cast(type::create_bool(), expected, parent, binop);
+		TRY(const type result, implicit_type_cast(type::create_bool(), binop.expected, binop.parent, node));
+		return finish(result);
 	}
 
-	auto type_checker::type_check_array_access(ast_node access, ast_node parent, type expected) -> type_check_result {
-		TRY(const type base_type, type_check_node(access->children[0], access));
-		TRY(type_check_node(access->children[1], access, type::create_u64()));
+	auto type_checker::type_check_array_access(frame& access) -> step_result {
+		const ast_node node = access.target;
+
+		switch(access.stage) {
+			case 0: return visit(node->children[0], node);
+			case 1: return visit(node->children[1], node, type::create_u64());
+			default: break;
+		}
 
-		access->get<ast::type_expression>().type = base_type;
+		const type base_type = get_result(access, 0);
+
+		node->get<ast::type_expression>().type = base_type;
 		const type accessed_type = base_type.dereference(1);
 
-		return implicit_type_cast(accessed_type, expected, parent, access);
+		TRY(const type result, implicit_type_cast(accessed_type, access.expected, access.parent, node));
+		return finish(result);
 	}
 
-	auto type_checker::type_check_local_member_access(ast_node access, ast_node parent, type expected) -> type_check_result {
-		auto& expression = access->get<ast::named_type_expression>();
+	auto type_checker::type_check_local_member_access(frame& access) -> step_result {
+		const ast_node node = access.target;
+		auto& expression = node->get<ast::named_type_expression>();
 
 		// type check the storage location
-		TRY(const type base_type, type_check_node(access->children[0], access));
+		if(access.stage == 0) {
+			return visit(node->children[0], node);
+		}
+
+		const type base_type = get_result(access, 0);
 
 		for(const type& member : base_type.get_struct_members()) {
 			// find a matching member
 			if(member.get_member_identifier() == expression.key) {
-				TRY(expression.type, implicit_type_cast(member, expected, parent, access));
-				return expression.type;
+				TRY(expression.type, implicit_type_cast(member, access.expected, access.parent, node));
+				return finish(expression.type);
 			}
 		}
 
 		// no member was found
 		const std::string& identifier = m_context.syntax.strings.get(expression.key);
-		return error::emit(error::code::UNKNOWN_STRUCT_MEMBER, access->location, identifier);
+		return error::emit(error::code::UNKNOWN_STRUCT_MEMBER, node->location, identifier);
 	}
 
-	auto type_checker::type_check_load(ast_node load, type expected) -> type_check_result {
+	auto type_checker::type_check_load(frame& load) -> step_result {
+		const ast_node node = load.target;
+
 		// type check the loaded node
-		TRY(const type load_type, type_check_node(load->children[0], load, expected));
+		if(load.stage == 0) {
+			return visit(node->children[0], node, load.expected);
+		}
 
 		// assign the loaded type
-		load->get<ast::type_expression>().type = load_type;
+		const type load_type = get_result(load, 0);
+		node->get<ast::type_expression>().type = load_type;
 
-		return load_type;
+		return finish(load_type);
 	}
 
-	auto type_checker::type_check_numerical_literal(ast_node literal, type expected) const -> type_check_result {
+	auto type_checker::type_check_numerical_literal(ast_node literal, type expected) -> type_check_result {
 		// upcast to the expected type, without throwing warnings/errors
 		auto& expression = literal->get<ast::named_type_expression>();
 		expression.type = inherent_type_cast(expression.type, expected);
@@ -344,50 +537,50 @@ namespace sigma {
 		switch (expression.type.get_kind()) {
 			case type::I8: {
 				const auto value = utility::from_string<i8>(value_str, overflow);
-				if (overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i8"); }
+				if (overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i8")); }
 				break;
 			}
 			case type::I16: {
 				const auto value = utility::from_string<i16>(value_str, overflow);
-				if (overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i16"); }
+				if (overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i16")); }
 				break;
 			}
 			case type::I32: {
 				const auto value = utility::from_string<i32>(value_str, overflow);
-				if(overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i32"); }
+				if(overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i32")); }
 				break;
 			}
 			case type::I64: {
 				const auto value = utility::from_string<i64>(value_str, overflow);
-				if (overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i64"); }
+				if (overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "i64")); }
 				break;
 			}
 			case type::U8: {
 				const auto value = utility::from_string<u8>(value_str, overflow);
-				if (overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u8"); }
+				if (overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u8")); }
 				break;
 			}
 			case type::U16: {
 				const auto value = utility::from_string<u16>(value_str, overflow);
-				if (overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u16"); }
+				if (overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u16")); }
 				break;
 			}
 			case type::U32: {
 				const auto value = utility::from_string<u32>(value_str, overflow);
-				if(overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u32"); }
+				if(overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u32")); }
 				break;
 			}
 			case type::U64: {
 				const auto value = utility::from_string<u64>(value_str, overflow);
-				if(overflow) { warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u64"); }
+				if(overflow) { m_warnings.push_back(warning::emit(warning::code::LITERAL_OVERFLOW, literal->location, value_str, value, "u64")); }
 				break;
 			}
 			case type::BOOL: {
-				warning::emit(warning::code::NUMERICAL_BOOL, literal->location);
+				m_warnings.push_back(warning::emit(warning::code::NUMERICAL_BOOL, literal->location));
 				break;
 			}
 			case type::CHAR: {
-				warning::emit(warning::code::NUMERICAL_CHAR, literal->location);
+				m_warnings.push_back(warning::emit(warning::code::NUMERICAL_CHAR, literal->location));
 				break;
 			}
 			default: NOT_IMPLEMENTED();
@@ -396,13 +589,13 @@ namespace sigma {
 		return expression.type;
 	}
 
-	auto type_checker::type_check_character_literal(ast_node literal, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_character_literal(ast_node literal, ast_node parent, type expected) -> type_check_result {
 		auto& expression = literal->get<ast::named_type_expression>();
 		TRY(expression.type, implicit_type_cast(expression.type, expected, parent, literal));
 		return expression.type;
 	}
 
-	auto type_checker::type_check_string_literal(ast_node literal, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_string_literal(ast_node literal, ast_node parent, type expected) -> type_check_result {
 		auto& expression = literal->get<ast::named_type_expression>();
 		TRY(expression.type, implicit_type_cast(expression.type, expected, parent, literal));
 		return expression.type;
@@ -412,7 +605,7 @@ namespace sigma {
 		auto& expression = declaration->get<ast::named_type_expression>();
 
 		// verify that no two members of the struct have the same identifier
-		auto& members = expression.type.get_struct_members();
+		const auto& members = expression.type.get_struct_members();
 
 		for (u64 i = 0; i < members.get_size(); ++i) {
 			for (u64 j = i + 1; j < members.get_size(); ++j) {
@@ -423,16 +616,21 @@ namespace sigma {
 			}
 		}
 
-		// resolve inner types
-		for(type& member : members) {
-			TRY(m_context.semantics.resolve_type(member, declaration->location));
+		// resolve inner types, types are immutable, the struct therefore has to be recreated
+		utility::memory_view<type, u8> resolved_members(m_allocator, members.get_size());
+		utility::copy(resolved_members, members);
+
+		for(type& member : resolved_members) {
+			TRY(m_semantics.resolve_type(member, declaration->location));
 		}
 
-		TRY(m_context.semantics.declare_struct(declaration));
+		expression.type = type::create_struct(resolved_members, expression.type.get_member_identifier());
+
+		TRY(m_semantics.declare_struct(declaration));
 		return type::create_unknown(); // not used
 	}
 
-	auto type_checker::type_check_bool_literal(ast_node literal, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_bool_literal(ast_node literal, ast_node parent, type expected) -> type_check_result {
 		// no need to check this, just cast it
 		return implicit_type_cast(type::create_bool(), expected, parent, literal);
 	}
@@ -445,7 +643,7 @@ namespace sigma {
 		return target_type;
 	}
 
-	auto type_checker::implicit_type_cast(type original_type, type target_type, ast_node parent, ast_node target) const -> type_check_result {
+	auto type_checker::implicit_type_cast(type original_type, type target_type, ast_node parent, ast_node target) -> type_check_result {
 		if(target_type.is_unknown()) {
 			return original_type;
 		}
@@ -499,12 +697,12 @@ namespace sigma {
 
 		// no cast needed, probably a sign diff
 		if(original_byte_width == target_byte_width) {
-			warning::emit(
+			m_warnings.push_back(warning::emit(
 				warning::code::IMPLICIT_CAST,
 				target->location, 
 				original_type.to_string(),
 				target_type.to_string()
-			);
+			));
 
 			return target_type;
 		}
@@ -515,7 +713,7 @@ namespace sigma {
 		const bool truncate = original_byte_width > target_byte_width;
 
 		// create the cast node
-		const ast_node cast_node = m_context.syntax.ast.create_node<ast::cast>(ast::node_type::CAST, 1, nullptr);
+		const ast_node cast_node = ast::tree::create_node<ast::cast>(m_allocator, ast::node_type::CAST, 1, target->location);
 
 		// assign cast info
 		ast::cast& cast = cast_node->get<ast::cast>();
@@ -534,21 +732,21 @@ namespace sigma {
 		parent->children[index_in_parent] = cast_node;
 		cast_node->children[0] = target;
 
-		warning::emit(
+		m_warnings.push_back(warning::emit(
 			truncate ? warning::code::IMPLICIT_TRUNCATION_CAST : warning::code::IMPLICIT_EXTENSION_CAST,
 			target->location,
 			original_type.to_string(),
 			target_type.to_string()
-		);
+		));
 
 		return target_type;
 	}
 
-	auto type_checker::type_check_variable_access(ast_node access, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_variable_access(ast_node access, ast_node parent, type expected) -> type_check_result {
 		auto& expression = access->get<ast::named_type_expression>();
 
 		// locate the variable
-		TRY(const auto variable, m_context.semantics.find_variable(expression.key));
+		TRY(const auto variable, m_semantics.find_variable(expression.key));
 
 		// check if the variable exists
 		if(variable == nullptr) {
@@ -561,24 +759,32 @@ namespace sigma {
 		return expression.type; // return the type checked value
 	}
 
-	auto type_checker::type_check_store(ast_node store) -> type_check_result {
-		// type check the destination
-		const ast_node destination = store->children[0];
-		TRY(const type destination_type, type_check_node(destination, store));
+	auto type_checker::type_check_store(frame& store) -> step_result {
+		const ast_node node = store.target;
 
-		// type check the assigned value against the destination type
-		TRY(type_check_node(store->children[1], store, destination_type));
+		switch(store.stage) {
+			// type check the destination
+			case 0: return visit(node->children[0], node);
+			// type check the assigned value against the destination type
+			case 1: return visit(node->children[1], node, get_result(store, 0));
+			default: break;
+		}
 
 		// this value won't be used
-		return type::create_unknown();
+		return finish(type::create_unknown());
 	}
 
-	auto type_checker::type_check_explicit_cast(ast_node cast, ast_node parent, type expected) -> type_check_result {
-		ast::cast& value = cast->get<ast::cast>();
+	auto type_checker::type_check_explicit_cast(frame& cast) -> step_result {
+		const ast_node node = cast.target;
+		ast::cast& value = node->get<ast::cast>();
 
 		// type check the value we're casting
-		TRY(value.original_type, type_check_node(cast->children[0], cast));
-		TRY(m_context.semantics.resolve_type(value.target_type, cast->location));
+		if(cast.stage == 0) {
+			return visit(node->children[0], node);
+		}
+
+		value.original_type = get_result(cast, 0);
+		TRY(m_semantics.resolve_type(value.target_type, node->location));
 
 		const type original = value.original_type;
 		const type target = value.target_type;
@@ -589,33 +795,39 @@ namespace sigma {
 				// invalid cast
 			return error::emit(
 				error::code::INVALID_CAST,
-				cast->location,
+				node->location,
 				original.to_string(),
 				target.to_string()
 			);
 		}
 
 		// upcast the result, if necessary, just a sanity check
-		return implicit_type_cast(value.target_type, expected, parent, cast);
+		TRY(const type result, implicit_type_cast(value.target_type, cast.expected, cast.parent, node));
+		return finish(result);
 	}
 
-	auto type_checker::type_check_alignof(ast_node alignof_node, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_alignof(ast_node alignof_node, ast_node parent, type expected) -> type_check_result {
 		// upcast to the expected type, without throwing warnings/errors
-		TRY(m_context.semantics.resolve_type(alignof_node->get<ast::type_expression>().type, alignof_node->location));
+		TRY(m_semantics.resolve_type(alignof_node->get<ast::type_expression>().type, alignof_node->location));
 		return implicit_type_cast(type::create_u64(), expected, parent, alignof_node);
 	}
 
-	auto type_checker::type_check_sizeof(ast_node sizeof_node, ast_node parent, type expected) const -> type_check_result {
+	auto type_checker::type_check_sizeof(ast_node sizeof_node, ast_node parent, type expected) -> type_check_result {
 		// upcast to the expected type, without throwing warnings/errors
-		TRY(m_context.semantics.resolve_type(sizeof_node->get<ast::type_expression>().type, sizeof_node->location));
+		TRY(m_semantics.resolve_type(sizeof_node->get<ast::type_expression>().type, sizeof_node->location));
 		return implicit_type_cast(type::create_u64(), expected, parent, sizeof_node);
 	}
 
-	auto type_checker::type_check_not_operator(ast_node op, ast_node parent, type expected) -> type_check_result {
+	auto type_checker::type_check_not_operator(frame& op) -> step_result {
+		const ast_node node = op.target;
+
 		// type check the negated expression
-		TRY(const type expression_type, type_check_node(op->children[0], op, type::create_bool()));
+		if(op.stage == 0) {
+			return visit(node->children[0], node, type::create_bool());
+		}
 
 		// upcast, just in case, more of a sanity check
-		return implicit_type_cast(expression_type, expected, parent, op);
+		TRY(const type result, implicit_type_cast(get_result(op, 0), op.expected, op.parent, node));
+		return finish(result);
 	}
 } // namespace sigma
@@ -7,14 +7,24 @@
 //            node of every node in function parameters so that we can insert it before the node
 //            which is being extended/truncated.
 //
-// -    It might be a good idea to rework this with DP, so that we don't strain the stack so much,
-//      this could also improve performance and the overall syntax.
+// -    The traversal doesn't recurse, nodes which are being type checked are kept on an explicit
+//      stack of frames. Nodes with children are type checked in steps, every step either requests
+//      a child node to be type checked or finishes the node. Types of finished children are kept
+//      on a separate stack, until their parent finishes as well.
+// -    Declarations (namespaces, structs, function signatures) are collected first, function
+//      bodies only depend on these declarations and are type checked in parallel afterwards.
+//      Every body gets its own scope stack and allocator, diagnostics are reported in
+//      declaration order.
 
 #pragma once
 #include <abstract_syntax_tree/tree.h>
 
 namespace sigma {
 	struct backend_context;
+	struct scope;
+
+	class semantic_context;
+	class thread_pool;
 
 	/**
 	 * \brief A simple type checker implementation, traverses the provided AST and
@@ -22,51 +32,101 @@ namespace sigma {
 	 */
 	class type_checker {
 	public:
-		static auto type_check(backend_context& context) -> utility::result<void>;
+		/**
+		 * \brief Type checks the merged AST of \b context.
+		 * \param context Backend context to type check
+		 * \param pool Thread pool used for type checking function bodies
+		 * \return First error in declaration order, if any.
+		 */
+		static auto type_check(backend_context& context, thread_pool& pool) -> utility::result<void>;
 	private:
 		using type_check_result = utility::result<type>;
 		using ast_node = handle<ast::node>;
 
-		type_checker(backend_context& context);
-		auto type_check() -> utility::result<void>;
+		// function body, which is type checked once all declarations have been collected
+		struct function_task {
+			ast_node function;                          // function declaration
+			handle<scope> scope;                        // scope containing the function parameters
+			handle<utility::block_allocator> allocator; // AST region used for scopes and implicit casts
+
+			std::vector<std::string> warnings;
+			std::optional<utility::error> error;
+		};
+
+		// node which is currently being type checked
+		struct frame {
+			ast_node target;
+			ast_node parent;
+			type expected;
+
+			u32 stage;         // number of steps taken so far
+			u64 results_begin; // index of the type of the first child in the result stack
+		};
+
+		// single step of a node, either requests a child to be type checked, or finishes the node
+		struct step {
+			ast_node child;  // child to type check next, nullptr once the node is finished
+			ast_node parent; // parent of the child, not necessarily the current node
+			type value;      // expected type of the child, or the type of the finished node
+		};
+
+		using step_result = utility::result<step>;
+
+		type_checker(backend_context& context, semantic_context& semantics, utility::block_allocator& allocator);
+
+		auto type_check_declarations() -> utility::result<void>;
+		auto type_check_function_body(ast_node function_node) -> utility::result<void>;
 
 		auto type_check_node(ast_node target, ast_node parent, type expected = type::create_unknown()) -> type_check_result;
+		auto type_check_step(frame& current) -> step_result;
+		auto type_check_leaf(const frame& current) -> type_check_result;
+
+		static auto visit(ast_node child, ast_node parent, type expected = type::create_unknown()) -> step;
+		static auto finish(type result) -> step;
+
+		/**
+		 * \brief Retrieves the type of an already type checked child of \b current.
+		 * \param current Frame of the parent node
+		 * \param index Index of the child, in the order in which children were type checked
+		 * \return Type of the child.
+		 */
+		auto get_result(const frame& current, u64 index) const -> type;
 
 		// declarations
-		auto type_check_namespace_declaration(ast_node declaration) -> type_check_result;
+		auto type_check_namespace_declaration(frame& declaration) -> step_result;
 		auto type_check_function_declaration(ast_node declaration) -> type_check_result;
-		auto type_check_variable_declaration(ast_node declaration) const -> type_check_result;
+		auto type_check_variable_declaration(ast_node declaration) -> type_check_result;
 		auto type_check_struct_declaration(ast_node declaration) const -> type_check_result;
 
 		// literals
-		auto type_check_character_literal(ast_node literal, ast_node parent, type expected) const ->type_check_result;
-		auto type_check_string_literal(ast_node literal, ast_node parent, type expected) const -> type_check_result;
-		auto type_check_bool_literal(ast_node literal, ast_node parent, type expected) const -> type_check_result;
-		auto type_check_numerical_literal(ast_node literal, type expected) const -> type_check_result;
+		auto type_check_character_literal(ast_node literal, ast_node parent, type expected) ->type_check_result;
+		auto type_check_string_literal(ast_node literal, ast_node parent, type expected) -> type_check_result;
+		auto type_check_bool_literal(ast_node literal, ast_node parent, type expected) -> type_check_result;
+		auto type_check_numerical_literal(ast_node literal, type expected) -> type_check_result;
 
 		// expressions
-		auto type_check_binary_math_operator(ast_node binop, type expected) -> type_check_result;
-		auto type_check_binary_comparison_operator(ast_node binop, ast_node parent, type expected) -> type_check_result;
-		auto type_check_predicate_operator(ast_node binop, ast_node parent, type expected) -> type_check_result;
-		auto type_check_not_operator(ast_node op, ast_node parent, type expected) -> type_check_result;
+		auto type_check_binary_math_operator(frame& binop) -> step_result;
+		auto type_check_binary_comparison_operator(frame& binop) -> step_result;
+		auto type_check_predicate_operator(frame& binop) -> step_result;
+		auto type_check_not_operator(frame& op) -> step_result;
 
 		// statements
-		auto type_check_return(ast_node statement) -> type_check_result;
-		auto type_check_conditional_branch(ast_node branch) -> type_check_result;
-		auto type_check_branch(ast_node branch) -> type_check_result;
+		auto type_check_return(frame& statement) -> step_result;
+		auto type_check_conditional_branch(frame& branch) -> step_result;
+		auto type_check_branch(frame& branch) -> step_result;
 
 		// loads / stores
-		auto type_check_variable_access(ast_node access, ast_node parent, type expected) const->type_check_result;
-		auto type_check_array_access(ast_node access, ast_node parent, type expected) -> type_check_result;
-		auto type_check_local_member_access(ast_node access, ast_node parent, type expected) -> type_check_result;
-		auto type_check_load(ast_node load, type expected) -> type_check_result;
-		auto type_check_store(ast_node store) -> type_check_result;
+		auto type_check_variable_access(ast_node access, ast_node parent, type expected) ->type_check_result;
+		auto type_check_array_access(frame& access) -> step_result;
+		auto type_check_local_member_access(frame& access) -> step_result;
+		auto type_check_load(frame& load) -> step_result;
+		auto type_check_store(frame& store) -> step_result;
 
 		// other
-		auto type_check_alignof(ast_node alignof_node, ast_node parent, type expected) const->type_check_result;
-		auto type_check_sizeof(ast_node sizeof_node, ast_node parent, type expected) const->type_check_result;
-		auto type_check_function_call(ast_node call, ast_node parent, type expected) -> type_check_result;
-		auto type_check_explicit_cast(ast_node cast, ast_node parent, type expected) -> type_check_result;
+		auto type_check_alignof(ast_node alignof_node, ast_node parent, type expected) ->type_check_result;
+		auto type_check_sizeof(ast_node sizeof_node, ast_node parent, type expected) ->type_check_result;
+		auto type_check_function_call(frame& call) -> step_result;
+		auto type_check_explicit_cast(frame& cast) -> step_result;
 
 
 		/**
@@ -85,9 +145,17 @@ namespace sigma {
 		 * \param target Target node we want to cast
 		 * \return result<type> - if no errors occur the final type is returned. 
 		 */
-		auto implicit_type_cast(type original_type, type target_type, ast_node parent, ast_node target) const -> type_check_result;
+		auto implicit_type_cast(type original_type, type target_type, ast_node parent, ast_node target) -> type_check_result;
 	private:
 		backend_context& m_context;
+		semantic_context& m_semantics;
+		utility::block_allocator& m_allocator; // allocator used for implicit cast nodes
+
 		function_signature m_current_function;
+		std::vector<function_task> m_functions; // function bodies encountered while collecting declarations
+		std::vector<std::string> m_warnings;    // warnings emitted so far, printed once type checking finishes
+
+		std::vector<frame> m_frames; // nodes which are being type checked
+		std::vector<type> m_results; // types of finished children of nodes in m_frames
 	};
 } // namespace sigma
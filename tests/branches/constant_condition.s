@@ -0,0 +1,26 @@
+// check: main:
+// check-not: test
+// check-not: jmp
+// check: mov esi, 2
+// check-not: test
+// check-not: jmp
+i32 main() {
+	i32 value = 10;
+
+	if(value > 5) {
+		printf("greater\n");
+	}
+	else {
+		printf("smaller\n");
+	}
+
+	if(value == 3) {
+		value = 1;
+	}
+	else if(value == 10) {
+		value = 2;
+	}
+
+	printf("%d\n", value);
+	ret 0;
+}
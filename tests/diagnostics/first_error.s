@@ -0,0 +1,23 @@
+// arguments: -j 4
+// fails
+// diagnostic: first_error.s:14:6: error
+// diagnostic-not: missing_last
+// only the first error in declaration order is reported, even though the later bodies are
+// type checked as well
+
+struct point {
+	i32 x;
+	i32 y;
+};
+
+i32 first() {
+	ret missing_first;
+}
+
+i32 main() {
+	ret 0;
+}
+
+i32 last() {
+	ret missing_last;
+}
@@ -0,0 +1,27 @@
+// arguments: -j 4
+// diagnostic: warning_order.s:15:10: warning
+// diagnostic: warning_order.s:20:10: warning
+// diagnostic: warning_order.s:25:10: warning
+// function bodies are type checked in parallel, their diagnostics are still reported in
+// declaration order
+
+i32 main() {
+	printf("%d %d %d\n", first(), second(1), third(2));
+	ret 0;
+}
+
+i32 first() {
+	i64 a = 1;
+	i32 b = a;
+	ret b;
+}
+
+i32 second(i32 value) {
+	u64 c = value;
+	ret value;
+}
+
+i32 third(i32 value) {
+	i64 d = value;
+	ret value;
+}
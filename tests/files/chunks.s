@@ -0,0 +1,38 @@
+// arguments: -j 16 --token-chunk-size 16
+// the file is split into chunks of roughly 100 bytes, literals and comments are placed so
+// that the preferred boundaries fall inside of them: "a string in a comment
+// and a 'character' in a comment, neither of which may end a chunk
+
+i32 strings() {
+	printf("%s\n", "a string which contains // a comment and \"quotes\" which spans the boundary");
+	printf("%s\n", "another long string with an escaped \\ backslash, 'quotes' and more words");
+	printf("%s %s\n", "short", "// not a comment either, but long enough to contain a boundary");
+	ret 0;
+}
+
+i32 characters() {
+	// characters which change the lexical state when they aren't inside of a literal
+	printf("%c%c%c%c%c\n", '"', '\'', '/', '\\', 'x');
+	printf("%c%c%c\n", '/', '/', '"'); // "an unterminated string in a comment
+	ret 0;
+}
+
+// a comment which is long enough to contain a chunk boundary, followed by another one right away
+// "and one which starts with a quote
+i32 comments() {
+	// a sequence of short lines, which makes the chunk boundaries fall between tokens instead
+	i32 a = 1;
+	i32 b = 2;
+	i32 c = 3;
+	i32 d = 4;
+	printf("%d\n", a + b + c + d);
+	ret 0;
+}
+
+i32 main() {
+	strings();
+	characters();
+	comments();
+	printf("%s\n", "the last string, which ends in the final chunk");
+	ret 0;
+}
@@ -0,0 +1,4 @@
+i32 main() {
+	printf("%d\n", 1 + 2);
+	ret 0;
+}
\ No newline at end of file
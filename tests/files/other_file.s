@@ -0,0 +1,8 @@
+// sources: other_file_functions.s
+// jit
+// cache
+i32 main() {
+	printf("%d\n", square(add(2, 3)));
+	print_sum(4, 5);
+	ret 0;
+}
@@ -0,0 +1,11 @@
+i32 add(i32 a, i32 b) {
+	ret a + b;
+}
+
+i32 square(i32 value) {
+	ret value * value;
+}
+
+void print_sum(i32 a, i32 b) {
+	printf("%d\n", add(a, b));
+}
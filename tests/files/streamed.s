@@ -0,0 +1,140 @@
+// arguments: -j 2 --token-stream-size 0
+// the file is tokenized while it's being parsed, it contains more tokens than the stream
+// holds at once, so the ring buffer wraps around several times
+
+i32 sum(i32 x) {
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	x = x+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1+1;
+	ret x;
+}
+
+i32 main() {
+	printf("%s %d\n", "streamed", sum(0));
+	ret 0;
+}
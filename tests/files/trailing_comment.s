@@ -0,0 +1,5 @@
+i32 main() {
+	printf("%d\n", 4 + 5);
+	ret 0;
+}
+//
\ No newline at end of file
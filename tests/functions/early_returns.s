@@ -0,0 +1,24 @@
+i32 classify(i32 x) {
+	if(x < 0) {
+		ret 0;
+	}
+
+	if(x == 0) {
+		ret 1;
+	}
+
+	if(x < 10) {
+		ret 2;
+	}
+
+	ret 3;
+}
+
+i32 scaled(i32 x) {
+	ret classify(x) * 10;
+}
+
+i32 main() {
+	printf("%d %d %d %d\n", scaled(-5), scaled(0), scaled(7), scaled(42));
+	ret 0;
+}
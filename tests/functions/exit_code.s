@@ -0,0 +1,7 @@
+// jit
+// exit: 3
+i32 main() {
+	printf("first\n");
+	printf("second %d\n", 2);
+	ret 3;
+}
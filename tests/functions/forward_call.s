@@ -0,0 +1,13 @@
+// functions can be called before they're declared
+i32 main() {
+	printf("%d %d\n", twice(21), add(twice(1), 3));
+	ret 0;
+}
+
+i32 twice(i32 value) {
+	ret add(value, value);
+}
+
+i32 add(i32 a, i32 b) {
+	ret a + b;
+}
@@ -0,0 +1,26 @@
+// check: main:
+// check-not: call f
+// check: mov esi, 20
+// check: mov ecx, 100
+// check: call printf
+// check-not: call f
+i32 clamp(i32 value, i32 low, i32 high) {
+	if(value < low) {
+		ret low;
+	}
+
+	if(value > high) {
+		ret high;
+	}
+
+	ret value;
+}
+
+i32 twice(i32 value) {
+	ret clamp(value, 0, 50) * 2;
+}
+
+i32 main() {
+	printf("%d %d %d\n", twice(10), twice(-5), twice(100));
+	ret 0;
+}
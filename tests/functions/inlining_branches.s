@@ -0,0 +1,18 @@
+// check: main:
+// check-not: call f
+void report(i32 value) {
+	if(value > 10) {
+		printf("big %d\n", value);
+	}
+	else {
+		printf("small %d\n", value);
+	}
+
+	printf("done\n");
+}
+
+i32 main() {
+	report(3);
+	report(30);
+	ret 0;
+}
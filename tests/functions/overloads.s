@@ -0,0 +1,47 @@
+// arguments: -j 4
+// overloads which only differ in the cost of the implicit cast of their argument are resolved
+// to the same one, in every function body
+i32 pick(i64 value) {
+	ret 64;
+}
+
+i32 pick(i16 value) {
+	ret 16;
+}
+
+// the same overloads declared in reverse order, ties don't depend on the declaration order
+i32 reversed(i16 value) {
+	ret 16;
+}
+
+i32 reversed(i64 value) {
+	ret 64;
+}
+
+i32 first(i32 value) {
+	ret pick(value);
+}
+
+i32 second(i32 value) {
+	ret pick(value) + pick(value);
+}
+
+i32 main() {
+	i32 a = 1;
+	i64 b = 2;
+
+	// i32 -> i64 and i32 -> i16 have the same cost, the resolution is cached after the first call
+	printf("%d %d %d %d %d\n", pick(a), first(a), second(a), pick(b), reversed(a));
+
+	// 'closest' is declared after this call, which has to be resolved to it regardless
+	printf("%d\n", closest(a));
+	ret 0;
+}
+
+i32 closest(i64 value) {
+	ret 64;
+}
+
+i32 closest(i32 value) {
+	ret 32;
+}
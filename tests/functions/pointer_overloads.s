@@ -0,0 +1,46 @@
+// overloads which differ in struct types and pointer levels of their parameters
+struct point {
+	i32 x;
+	i32 y;
+};
+
+struct size {
+	i32 x;
+	i32 y;
+};
+
+i32 describe(point* value) {
+	ret 1;
+}
+
+i32 describe(size* value) {
+	ret 2;
+}
+
+i32 describe(i32* value) {
+	ret 3;
+}
+
+i32 describe(i32** value) {
+	ret 4;
+}
+
+i32 describe(i32 value) {
+	ret 5;
+}
+
+i32 describe(point value) {
+	ret 6;
+}
+
+i32 main() {
+	point* p = cast<point*>(malloc(sizeof(point)));
+	size* s = cast<size*>(malloc(sizeof(size)));
+	i32* i = cast<i32*>(malloc(sizeof(i32)));
+	i32** ii = cast<i32**>(malloc(sizeof(i32*)));
+	point v;
+
+	printf("%d %d %d %d %d\n", describe(p), describe(s), describe(i), describe(ii), describe(7));
+	printf("%d\n", describe(v));
+	ret 0;
+}
@@ -1,3 +1,4 @@
+// cache
 namespace a {
     namespace a {
         namespace a {
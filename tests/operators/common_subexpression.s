@@ -0,0 +1,15 @@
+// check: f0:
+// check: imul
+// check: imul
+// check-not: imul
+// check: main:
+i32 product(i32 x, i32 y) {
+	i32 a = x * y + 1;
+	i32 b = x * y + 2;
+	ret a * b;
+}
+
+i32 main() {
+	printf("%d\n", product(3, 4));
+	ret 0;
+}
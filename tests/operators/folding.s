@@ -0,0 +1,23 @@
+// check: f0:
+// check-not: sub
+// check-not: imul
+// check: ret
+// check: main:
+// check-not: imul
+// check: mov esi, 7
+// check: mov edx, 7
+i32 fold(i32 x) {
+	i32 zero = x - x;
+	i32 same = x * 1 + 0;
+	ret zero + same + 2 + 3;
+}
+
+i32 main() {
+	i32 a = 5;
+	i32 b = a * 0 + 7;
+	i32 c = a + 3 + 4 - a;
+
+	printf("%d %d\n", b, c);
+	printf("%d\n", fold(10));
+	ret 0;
+}
@@ -0,0 +1,23 @@
+// structs can be used in function bodies before they're declared, signatures are resolved in
+// declaration order and still require the struct to be declared first
+i32 main() {
+	point p;
+	p.x = 3;
+	p.y = 4;
+
+	printf("%d\n", length_squared(p.x, p.y));
+	ret 0;
+}
+
+i32 length_squared(i32 x, i32 y) {
+	point p;
+	p.x = x;
+	p.y = y;
+
+	ret p.x * p.x + p.y * p.y;
+}
+
+struct point {
+	i32 x;
+	i32 y;
+};
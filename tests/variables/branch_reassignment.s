@@ -0,0 +1,19 @@
+i32 pick(bool condition) {
+	i32 value = 1;
+
+	if(condition) {
+		value = 2;
+	}
+
+	ret value;
+}
+
+i32 main() {
+	i32 a = 10;
+	i32 b;
+	b = a + 5;
+	a = a * 2;
+	printf("%d %d\n", a, b);
+	printf("%d %d\n", pick(true), pick(false));
+	ret 0;
+}
@@ -0,0 +1,298 @@
+i32 sum(i32 x) {
+	i32 v0 = x * 2;
+	i32 v1 = x * 3;
+	i32 v2 = x * 4;
+	i32 v3 = x * 5;
+	i32 v4 = x * 6;
+	i32 v5 = x * 7;
+	i32 v6 = x * 8;
+	i32 v7 = x * 9;
+	i32 v8 = x * 10;
+	i32 v9 = x * 11;
+	i32 v10 = x * 12;
+	i32 v11 = x * 13;
+	i32 v12 = x * 14;
+	i32 v13 = x * 15;
+	i32 v14 = x * 16;
+	i32 v15 = x * 17;
+	i32 v16 = x * 18;
+	i32 v17 = x * 19;
+	i32 v18 = x * 20;
+	i32 v19 = x * 21;
+	i32 v20 = x * 22;
+	i32 v21 = x * 23;
+	i32 v22 = x * 24;
+	i32 v23 = x * 25;
+	i32 v24 = x * 26;
+	i32 v25 = x * 27;
+	i32 v26 = x * 28;
+	i32 v27 = x * 29;
+	i32 v28 = x * 30;
+	i32 v29 = x * 31;
+	i32 v30 = x * 32;
+	i32 v31 = x * 33;
+	i32 v32 = x * 34;
+	i32 v33 = x * 35;
+	i32 v34 = x * 36;
+	i32 v35 = x * 37;
+	i32 v36 = x * 38;
+	i32 v37 = x * 39;
+	i32 v38 = x * 40;
+	i32 v39 = x * 41;
+	i32 v40 = x * 42;
+	i32 v41 = x * 43;
+	i32 v42 = x * 44;
+	i32 v43 = x * 45;
+	i32 v44 = x * 46;
+	i32 v45 = x * 47;
+	i32 v46 = x * 48;
+	i32 v47 = x * 49;
+	i32 v48 = x * 50;
+	i32 v49 = x * 51;
+	i32 v50 = x * 52;
+	i32 v51 = x * 53;
+	i32 v52 = x * 54;
+	i32 v53 = x * 55;
+	i32 v54 = x * 56;
+	i32 v55 = x * 57;
+	i32 v56 = x * 58;
+	i32 v57 = x * 59;
+	i32 v58 = x * 60;
+	i32 v59 = x * 61;
+	i32 v60 = x * 62;
+	i32 v61 = x * 63;
+	i32 v62 = x * 64;
+	i32 v63 = x * 65;
+	i32 v64 = x * 66;
+	i32 v65 = x * 67;
+	i32 v66 = x * 68;
+	i32 v67 = x * 69;
+	i32 v68 = x * 70;
+	i32 v69 = x * 71;
+	i32 v70 = x * 72;
+	i32 v71 = x * 73;
+	i32 v72 = x * 74;
+	i32 v73 = x * 75;
+	i32 v74 = x * 76;
+	i32 v75 = x * 77;
+	i32 v76 = x * 78;
+	i32 v77 = x * 79;
+	i32 v78 = x * 80;
+	i32 v79 = x * 81;
+	i32 v80 = x * 82;
+	i32 v81 = x * 83;
+	i32 v82 = x * 84;
+	i32 v83 = x * 85;
+	i32 v84 = x * 86;
+	i32 v85 = x * 87;
+	i32 v86 = x * 88;
+	i32 v87 = x * 89;
+	i32 v88 = x * 90;
+	i32 v89 = x * 91;
+	i32 v90 = x * 92;
+	i32 v91 = x * 93;
+	i32 v92 = x * 94;
+	i32 v93 = x * 95;
+	i32 v94 = x * 96;
+	i32 v95 = x * 97;
+	i32 v96 = x * 98;
+	i32 v97 = x * 99;
+	i32 v98 = x * 100;
+	i32 v99 = x * 101;
+	i32 v100 = x * 102;
+	i32 v101 = x * 103;
+	i32 v102 = x * 104;
+	i32 v103 = x * 105;
+	i32 v104 = x * 106;
+	i32 v105 = x * 107;
+	i32 v106 = x * 108;
+	i32 v107 = x * 109;
+	i32 v108 = x * 110;
+	i32 v109 = x * 111;
+	i32 v110 = x * 112;
+	i32 v111 = x * 113;
+	i32 v112 = x * 114;
+	i32 v113 = x * 115;
+	i32 v114 = x * 116;
+	i32 v115 = x * 117;
+	i32 v116 = x * 118;
+	i32 v117 = x * 119;
+	i32 v118 = x * 120;
+	i32 v119 = x * 121;
+	i32 v120 = x * 122;
+	i32 v121 = x * 123;
+	i32 v122 = x * 124;
+	i32 v123 = x * 125;
+	i32 v124 = x * 126;
+	i32 v125 = x * 127;
+	i32 v126 = x * 128;
+	i32 v127 = x * 129;
+	i32 v128 = x * 130;
+	i32 v129 = x * 131;
+	i32 v130 = x * 132;
+	i32 v131 = x * 133;
+	i32 v132 = x * 134;
+	i32 v133 = x * 135;
+	i32 v134 = x * 136;
+	i32 v135 = x * 137;
+	i32 v136 = x * 138;
+	i32 v137 = x * 139;
+	i32 v138 = x * 140;
+	i32 v139 = x * 141;
+	i32 v140 = x * 142;
+	i32 v141 = x * 143;
+	i32 v142 = x * 144;
+	i32 v143 = x * 145;
+	i32 v144 = x * 146;
+	i32 v145 = x * 147;
+	i32 v146 = x * 148;
+	i32 v147 = x * 149;
+	i32 v148 = x * 150;
+	i32 v149 = x * 151;
+	i32 v150 = x * 152;
+	i32 v151 = x * 153;
+	i32 v152 = x * 154;
+	i32 v153 = x * 155;
+	i32 v154 = x * 156;
+	i32 v155 = x * 157;
+	i32 v156 = x * 158;
+	i32 v157 = x * 159;
+	i32 v158 = x * 160;
+	i32 v159 = x * 161;
+	i32 v160 = x * 162;
+	i32 v161 = x * 163;
+	i32 v162 = x * 164;
+	i32 v163 = x * 165;
+	i32 v164 = x * 166;
+	i32 v165 = x * 167;
+	i32 v166 = x * 168;
+	i32 v167 = x * 169;
+	i32 v168 = x * 170;
+	i32 v169 = x * 171;
+	i32 v170 = x * 172;
+	i32 v171 = x * 173;
+	i32 v172 = x * 174;
+	i32 v173 = x * 175;
+	i32 v174 = x * 176;
+	i32 v175 = x * 177;
+	i32 v176 = x * 178;
+	i32 v177 = x * 179;
+	i32 v178 = x * 180;
+	i32 v179 = x * 181;
+	i32 v180 = x * 182;
+	i32 v181 = x * 183;
+	i32 v182 = x * 184;
+	i32 v183 = x * 185;
+	i32 v184 = x * 186;
+	i32 v185 = x * 187;
+	i32 v186 = x * 188;
+	i32 v187 = x * 189;
+	i32 v188 = x * 190;
+	i32 v189 = x * 191;
+	i32 v190 = x * 192;
+	i32 v191 = x * 193;
+	i32 v192 = x * 194;
+	i32 v193 = x * 195;
+	i32 v194 = x * 196;
+	i32 v195 = x * 197;
+	i32 v196 = x * 198;
+	i32 v197 = x * 199;
+	i32 v198 = x * 200;
+	i32 v199 = x * 201;
+	i32 v200 = x * 202;
+	i32 v201 = x * 203;
+	i32 v202 = x * 204;
+	i32 v203 = x * 205;
+	i32 v204 = x * 206;
+	i32 v205 = x * 207;
+	i32 v206 = x * 208;
+	i32 v207 = x * 209;
+	i32 v208 = x * 210;
+	i32 v209 = x * 211;
+	i32 v210 = x * 212;
+	i32 v211 = x * 213;
+	i32 v212 = x * 214;
+	i32 v213 = x * 215;
+	i32 v214 = x * 216;
+	i32 v215 = x * 217;
+	i32 v216 = x * 218;
+	i32 v217 = x * 219;
+	i32 v218 = x * 220;
+	i32 v219 = x * 221;
+	i32 v220 = x * 222;
+	i32 v221 = x * 223;
+	i32 v222 = x * 224;
+	i32 v223 = x * 225;
+	i32 v224 = x * 226;
+	i32 v225 = x * 227;
+	i32 v226 = x * 228;
+	i32 v227 = x * 229;
+	i32 v228 = x * 230;
+	i32 v229 = x * 231;
+	i32 v230 = x * 232;
+	i32 v231 = x * 233;
+	i32 v232 = x * 234;
+	i32 v233 = x * 235;
+	i32 v234 = x * 236;
+	i32 v235 = x * 237;
+	i32 v236 = x * 238;
+	i32 v237 = x * 239;
+	i32 v238 = x * 240;
+	i32 v239 = x * 241;
+	i32 v240 = x * 242;
+	i32 v241 = x * 243;
+	i32 v242 = x * 244;
+	i32 v243 = x * 245;
+	i32 v244 = x * 246;
+	i32 v245 = x * 247;
+	i32 v246 = x * 248;
+	i32 v247 = x * 249;
+	i32 v248 = x * 250;
+	i32 v249 = x * 251;
+	i32 v250 = x * 252;
+	i32 v251 = x * 253;
+	i32 v252 = x * 254;
+	i32 v253 = x * 255;
+	i32 v254 = x * 256;
+	i32 v255 = x * 257;
+	i32 v256 = x * 258;
+	i32 v257 = x * 259;
+	i32 v258 = x * 260;
+	i32 v259 = x * 261;
+
+	// every value is still live across the call
+	printf("%d\n", x);
+
+	ret
+		v259 + v258 + v257 + v256 + v255 + v254 + v253 + v252 + v251 + v250 +
+		v249 + v248 + v247 + v246 + v245 + v244 + v243 + v242 + v241 + v240 +
+		v239 + v238 + v237 + v236 + v235 + v234 + v233 + v232 + v231 + v230 +
+		v229 + v228 + v227 + v226 + v225 + v224 + v223 + v222 + v221 + v220 +
+		v219 + v218 + v217 + v216 + v215 + v214 + v213 + v212 + v211 + v210 +
+		v209 + v208 + v207 + v206 + v205 + v204 + v203 + v202 + v201 + v200 +
+		v199 + v198 + v197 + v196 + v195 + v194 + v193 + v192 + v191 + v190 +
+		v189 + v188 + v187 + v186 + v185 + v184 + v183 + v182 + v181 + v180 +
+		v179 + v178 + v177 + v176 + v175 + v174 + v173 + v172 + v171 + v170 +
+		v169 + v168 + v167 + v166 + v165 + v164 + v163 + v162 + v161 + v160 +
+		v159 + v158 + v157 + v156 + v155 + v154 + v153 + v152 + v151 + v150 +
+		v149 + v148 + v147 + v146 + v145 + v144 + v143 + v142 + v141 + v140 +
+		v139 + v138 + v137 + v136 + v135 + v134 + v133 + v132 + v131 + v130 +
+		v129 + v128 + v127 + v126 + v125 + v124 + v123 + v122 + v121 + v120 +
+		v119 + v118 + v117 + v116 + v115 + v114 + v113 + v112 + v111 + v110 +
+		v109 + v108 + v107 + v106 + v105 + v104 + v103 + v102 + v101 + v100 +
+		v99 + v98 + v97 + v96 + v95 + v94 + v93 + v92 + v91 + v90 +
+		v89 + v88 + v87 + v86 + v85 + v84 + v83 + v82 + v81 + v80 +
+		v79 + v78 + v77 + v76 + v75 + v74 + v73 + v72 + v71 + v70 +
+		v69 + v68 + v67 + v66 + v65 + v64 + v63 + v62 + v61 + v60 +
+		v59 + v58 + v57 + v56 + v55 + v54 + v53 + v52 + v51 + v50 +
+		v49 + v48 + v47 + v46 + v45 + v44 + v43 + v42 + v41 + v40 +
+		v39 + v38 + v37 + v36 + v35 + v34 + v33 + v32 + v31 + v30 +
+		v29 + v28 + v27 + v26 + v25 + v24 + v23 + v22 + v21 + v20 +
+		v19 + v18 + v17 + v16 + v15 + v14 + v13 + v12 + v11 + v10 +
+		v9 + v8 + v7 + v6 + v5 + v4 + v3 + v2 + v1 + v0;
+}
+
+i32 main() {
+	printf("%d\n", sum(3));
+	ret 0;
+}